@@ -12,10 +12,16 @@
 #define SimdHash_hpp
 
 #include <array>
+#include <bit>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <ranges>
 #include <span>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <iostream>
 
 #include "simdhash.h"
@@ -23,6 +29,8 @@
 namespace simdhash
 {
 
+using Digest = std::vector<uint8_t>;
+
 namespace
 {
     static inline void
@@ -86,6 +94,620 @@ SimdHashSingle(
     SimdHashSingle(Algorithm, Input.size(), (const uint8_t*)Input.data(), Output.data());
 }
 
+class PooledContext
+/*++
+ Owns a context from the calling thread's pool and returns it when it
+ goes out of scope. Must be destroyed on the thread that created it
+--*/
+{
+public:
+    explicit PooledContext(
+        const HashAlgorithm Algorithm
+    ) : m_Context(SimdHashAcquireContext(Algorithm))
+    {
+        CheckImpl(m_Context != nullptr, "Failed to acquire a hash context");
+    }
+    ~PooledContext(void) { SimdHashReleaseContext(m_Context); }
+
+    PooledContext(const PooledContext&) = delete;
+    PooledContext& operator=(const PooledContext&) = delete;
+    PooledContext(PooledContext&& Other) noexcept : m_Context(std::exchange(Other.m_Context, nullptr)) {}
+    PooledContext&
+    operator=(
+        PooledContext&& Other
+    ) noexcept
+    {
+        if (this != &Other)
+        {
+            SimdHashReleaseContext(m_Context);
+            m_Context = std::exchange(Other.m_Context, nullptr);
+        }
+        return *this;
+    }
+
+    SimdHashContext* Get(void) const { return m_Context; }
+    SimdHashContext* operator->(void) const { return m_Context; }
+    SimdHashContext& operator*(void) const { return *m_Context; }
+    operator SimdHashContext*(void) const { return m_Context; }
+
+    void Reset(void) { SimdHashResetContext(m_Context, m_Context->Algorithm); }
+    void Reset(const HashAlgorithm Algorithm) { SimdHashResetContext(m_Context, Algorithm); }
+
+private:
+    SimdHashContext* m_Context;
+};
+
+constexpr size_t
+HashWidth(
+    const HashAlgorithm Algorithm
+)
+/*++
+ Compile time counterpart of GetHashWidth, 0 for unknown algorithms
+--*/
+{
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmNTLM:
+        return MD4_SIZE;
+    case HashAlgorithmMD5:
+        return MD5_SIZE;
+    case HashAlgorithmSHA1:
+        return SHA1_SIZE;
+    case HashAlgorithmSHA256:
+        return SHA256_SIZE;
+    case HashAlgorithmSHA384:
+        return SHA384_SIZE;
+    case HashAlgorithmSHA512:
+        return SHA512_SIZE;
+    case HashAlgorithmFNV1_32:
+    case HashAlgorithmFNV1a_32:
+        return FNV32_SIZE;
+    case HashAlgorithmFNV1_64:
+    case HashAlgorithmFNV1a_64:
+        return FNV64_SIZE;
+    default:
+        return 0;
+    }
+}
+
+// Anything with contiguous bytes behind data() and size(), such as
+// std::span<const uint8_t>, std::string_view or std::vector<uint8_t>
+template <typename T>
+concept ByteSequence = requires(const T& Value)
+{
+    { Value.data() } -> std::convertible_to<const void*>;
+    { Value.size() } -> std::convertible_to<size_t>;
+} && sizeof(*std::declval<const T&>().data()) == 1;
+
+// A byte sequence whose bytes outlive the expression that produced it,
+// either a reference into the range or a view such as std::string_view
+template <typename T>
+concept StableByteSequence = ByteSequence<T> &&
+    (std::is_lvalue_reference_v<T> || std::ranges::borrowed_range<T>);
+
+// A range of byte sequences that Hasher can batch. Forward ranges are
+// hashed in place, so their elements must stay put while a lane group
+// fills. Single pass ranges, such as std::views::istream, may hand out
+// the same cached element every time and are copied instead
+template <typename R>
+concept HashableRange = std::ranges::input_range<R> &&
+    ByteSequence<std::ranges::range_reference_t<R>> &&
+    (!std::ranges::forward_range<R> || StableByteSequence<std::ranges::range_reference_t<R>>);
+
+#pragma clang unsafe_buffer_usage begin
+template <ByteSequence T>
+inline std::span<const uint8_t>
+AsBytes(
+    const T& Input
+)
+/*++
+ Views the bytes of any byte sequence as a span without copying them
+--*/
+{
+    return std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(Input.data()), Input.size());
+}
+#pragma clang unsafe_buffer_usage end
+
+template <HashAlgorithm Algorithm>
+class Hasher
+/*++
+ Hashes any range of byte sequences in place, without copying them into
+ a SimdHashBuffer. Inputs are taken a lane group at a time and hashed
+ with SimdHashAdaptive, which takes the optimized path whenever the
+ lengths allow it
+--*/
+{
+public:
+    static constexpr size_t DigestSize = HashWidth(Algorithm);
+    static_assert(DigestSize != 0, "Unsupported hash algorithm");
+    using DigestType = std::array<uint8_t, DigestSize>;
+    static_assert(sizeof(DigestType) == DigestSize, "Digests must be contiguous");
+
+    Hasher(void) : m_Lanes(SimdLanes()) {}
+
+    template <HashableRange Range>
+    size_t
+    Hash(
+        Range&& Inputs,
+        std::span<DigestType> Output
+    ) const
+    /*++
+     Writes the digest of the i-th input to Output[i], straight from the
+     hash output without an intermediate copy. Returns the input count
+    --*/
+    {
+        return ForEachGroup(
+            std::forward<Range>(Inputs),
+            [&](const size_t First, const size_t Count, const size_t* Lengths, const uint8_t* const* Buffers)
+            {
+                CheckImpl(First + Count <= Output.size(), "Output span too small for inputs");
+                uint8_t* hashes = reinterpret_cast<uint8_t*>(Output.subspan(First, Count).data());
+                SimdHashAdaptive(Algorithm, Count, Lengths, Buffers, hashes);
+            });
+    }
+
+    template <HashableRange Range, typename Callback>
+        requires std::invocable<Callback&, size_t, const DigestType&>
+    size_t
+    Hash(
+        Range&& Inputs,
+        Callback&& OnDigest
+    ) const
+    /*++
+     Calls OnDigest(index, digest) for every input in order
+    --*/
+    {
+        std::array<DigestType, MAX_LANES> digests;
+        return ForEachGroup(
+            std::forward<Range>(Inputs),
+            [&](const size_t First, const size_t Count, const size_t* Lengths, const uint8_t* const* Buffers)
+            {
+                SimdHashAdaptive(Algorithm, Count, Lengths, Buffers, reinterpret_cast<uint8_t*>(digests.data()));
+                for (size_t i = 0; i < Count; i++)
+                {
+                    OnDigest(First + i, digests[i]);
+                }
+            });
+    }
+
+    DigestType
+    Hash(
+        std::span<const uint8_t> Input
+    ) const
+    {
+        DigestType digest;
+        ::SimdHashSingle(Algorithm, Input.size(), Input.data(), digest.data());
+        return digest;
+    }
+
+private:
+    template <typename Range, typename Flush>
+    size_t
+    ForEachGroup(
+        Range&& Inputs,
+        Flush&& HashGroup
+    ) const
+    {
+        std::array<size_t, MAX_LANES> lengths{};
+        std::array<const uint8_t*, MAX_LANES> buffers{};
+        // Only used by single pass ranges, and keeps its storage between groups
+        std::array<std::vector<uint8_t>, MAX_LANES> copies;
+        static const uint8_t empty = 0;
+        size_t first = 0;
+        size_t count = 0;
+
+        for (auto&& input : Inputs)
+        {
+            const std::span<const uint8_t> bytes = AsBytes(input);
+            lengths[count] = bytes.size();
+            if (bytes.empty())
+            {
+                buffers[count] = &empty;
+            }
+            else if constexpr (std::ranges::forward_range<Range>)
+            {
+                buffers[count] = bytes.data();
+            }
+            else
+            {
+                copies[count].assign(bytes.begin(), bytes.end());
+                buffers[count] = copies[count].data();
+            }
+            if (++count == m_Lanes)
+            {
+                HashGroup(first, count, lengths.data(), buffers.data());
+                first += count;
+                count = 0;
+            }
+        }
+
+        if (count > 0)
+        {
+            HashGroup(first, count, lengths.data(), buffers.data());
+        }
+
+        return first + count;
+    }
+
+    const size_t m_Lanes;
+};
+
+//
+// Compile time hashing. Each function is bit identical to the runtime
+// path for the same algorithm: the FNV functions return the integer
+// that the Fnv*Single functions store, the others return the digest
+// bytes that SimdHashSingle writes.
+//
+namespace constant
+{
+
+inline constexpr uint32_t Fnv32OffsetBasis = 0x811c9dc5;
+inline constexpr uint32_t Fnv32Prime = 0x01000193;
+inline constexpr uint64_t Fnv64OffsetBasis = 0xcbf29ce484222325ULL;
+inline constexpr uint64_t Fnv64Prime = 0x00000100000001B3ULL;
+
+template <typename Bytes>
+constexpr uint8_t
+ByteAt(
+    const Bytes& Input,
+    const size_t Index
+)
+{
+    return static_cast<uint8_t>(Input[Index]);
+}
+
+template <typename Bytes>
+constexpr uint8_t
+PaddedByteAt(
+    const Bytes& Input,
+    const size_t Index,
+    const bool BigEndian
+)
+/*++
+ Byte Index of the Merkle-Damgard padded message: the message, 0x80,
+ zeros and the 64-bit bit length in the last eight bytes
+--*/
+{
+    const size_t length = Input.size();
+    const size_t total = ((length + sizeof(uint64_t)) / 64 + 1) * 64;
+    if (Index < length)
+    {
+        return ByteAt(Input, Index);
+    }
+    if (Index == length)
+    {
+        return 0x80;
+    }
+    if (Index >= total - sizeof(uint64_t))
+    {
+        const uint64_t bitLength = (uint64_t)length * 8;
+        const size_t position = Index - (total - sizeof(uint64_t));
+        const size_t shift = BigEndian ? (7 - position) * 8 : position * 8;
+        return (uint8_t)(bitLength >> shift);
+    }
+    return 0;
+}
+
+template <typename Bytes>
+constexpr uint32_t
+PaddedWordAt(
+    const Bytes& Input,
+    const size_t Offset,
+    const bool BigEndian
+)
+{
+    uint32_t word = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); i++)
+    {
+        const uint32_t byte = PaddedByteAt(Input, Offset + i, BigEndian);
+        word |= BigEndian ? byte << ((3 - i) * 8) : byte << (i * 8);
+    }
+    return word;
+}
+
+template <size_t N>
+constexpr std::array<uint8_t, N * 4>
+WordsToBytes(
+    const std::array<uint32_t, N>& Words,
+    const bool BigEndian
+)
+{
+    std::array<uint8_t, N * 4> bytes{};
+    for (size_t i = 0; i < N; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            bytes[i * 4 + j] = (uint8_t)(Words[i] >> (BigEndian ? (3 - j) * 8 : j * 8));
+        }
+    }
+    return bytes;
+}
+
+constexpr size_t
+BlockCount(
+    const size_t Length
+)
+{
+    return (Length + sizeof(uint64_t)) / 64 + 1;
+}
+
+template <typename Bytes>
+constexpr uint32_t
+Fnv1_32(
+    const Bytes& Input
+)
+{
+    uint32_t hash = Fnv32OffsetBasis;
+    for (size_t i = 0; i < Input.size(); i++)
+    {
+        hash *= Fnv32Prime;
+        hash ^= ByteAt(Input, i);
+    }
+    return hash;
+}
+
+template <typename Bytes>
+constexpr uint32_t
+Fnv1a_32(
+    const Bytes& Input
+)
+{
+    uint32_t hash = Fnv32OffsetBasis;
+    for (size_t i = 0; i < Input.size(); i++)
+    {
+        hash ^= ByteAt(Input, i);
+        hash *= Fnv32Prime;
+    }
+    return hash;
+}
+
+template <typename Bytes>
+constexpr uint64_t
+Fnv1_64(
+    const Bytes& Input
+)
+{
+    uint64_t hash = Fnv64OffsetBasis;
+    for (size_t i = 0; i < Input.size(); i++)
+    {
+        hash *= Fnv64Prime;
+        hash ^= ByteAt(Input, i);
+    }
+    return hash;
+}
+
+template <typename Bytes>
+constexpr uint64_t
+Fnv1a_64(
+    const Bytes& Input
+)
+{
+    uint64_t hash = Fnv64OffsetBasis;
+    for (size_t i = 0; i < Input.size(); i++)
+    {
+        hash ^= ByteAt(Input, i);
+        hash *= Fnv64Prime;
+    }
+    return hash;
+}
+
+inline constexpr std::array<uint32_t, 64> Md5Constants{
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+inline constexpr std::array<int, 64> Md5Shifts{
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+template <typename Bytes>
+constexpr std::array<uint8_t, MD5_SIZE>
+Md5(
+    const Bytes& Input
+)
+{
+    std::array<uint32_t, 4> h{ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+    for (size_t block = 0; block < BlockCount(Input.size()); block++)
+    {
+        std::array<uint32_t, 16> m{};
+        for (size_t i = 0; i < 16; i++)
+        {
+            m[i] = PaddedWordAt(Input, block * 64 + i * 4, false);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+        for (size_t i = 0; i < 64; i++)
+        {
+            uint32_t f = 0;
+            size_t g = 0;
+            if (i < 16)
+            {
+                f = (b & c) | (~b & d);
+                g = i;
+            }
+            else if (i < 32)
+            {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) % 16;
+            }
+            else if (i < 48)
+            {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) % 16;
+            }
+            else
+            {
+                f = c ^ (b | ~d);
+                g = (7 * i) % 16;
+            }
+            const uint32_t temp = d;
+            d = c;
+            c = b;
+            b = b + std::rotl(a + f + Md5Constants[i] + m[g], Md5Shifts[i]);
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+    }
+
+    return WordsToBytes(h, false);
+}
+
+template <typename Bytes>
+constexpr std::array<uint8_t, SHA1_SIZE>
+Sha1(
+    const Bytes& Input
+)
+{
+    std::array<uint32_t, 5> h{ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+    for (size_t block = 0; block < BlockCount(Input.size()); block++)
+    {
+        std::array<uint32_t, 80> w{};
+        for (size_t i = 0; i < 16; i++)
+        {
+            w[i] = PaddedWordAt(Input, block * 64 + i * 4, true);
+        }
+        for (size_t i = 16; i < 80; i++)
+        {
+            w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (size_t i = 0; i < 80; i++)
+        {
+            uint32_t f = 0;
+            uint32_t k = 0;
+            if (i < 20)
+            {
+                f = (b & c) | (~b & d);
+                k = 0x5a827999;
+            }
+            else if (i < 40)
+            {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            }
+            else if (i < 60)
+            {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8f1bbcdc;
+            }
+            else
+            {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+            const uint32_t temp = std::rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = std::rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    return WordsToBytes(h, true);
+}
+
+inline constexpr std::array<uint32_t, 64> Sha256Constants{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+template <typename Bytes>
+constexpr std::array<uint8_t, SHA256_SIZE>
+Sha256(
+    const Bytes& Input
+)
+{
+    std::array<uint32_t, 8> h{
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    for (size_t block = 0; block < BlockCount(Input.size()); block++)
+    {
+        std::array<uint32_t, 64> w{};
+        for (size_t i = 0; i < 16; i++)
+        {
+            w[i] = PaddedWordAt(Input, block * 64 + i * 4, true);
+        }
+        for (size_t i = 16; i < 64; i++)
+        {
+            const uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        std::array<uint32_t, 8> v = h;
+        for (size_t i = 0; i < 64; i++)
+        {
+            const uint32_t s1 = std::rotr(v[4], 6) ^ std::rotr(v[4], 11) ^ std::rotr(v[4], 25);
+            const uint32_t choice = (v[4] & v[5]) ^ (~v[4] & v[6]);
+            const uint32_t temp1 = v[7] + s1 + choice + Sha256Constants[i] + w[i];
+            const uint32_t s0 = std::rotr(v[0], 2) ^ std::rotr(v[0], 13) ^ std::rotr(v[0], 22);
+            const uint32_t majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+            const uint32_t temp2 = s0 + majority;
+            v[7] = v[6];
+            v[6] = v[5];
+            v[5] = v[4];
+            v[4] = v[3] + temp1;
+            v[3] = v[2];
+            v[2] = v[1];
+            v[1] = v[0];
+            v[0] = temp1 + temp2;
+        }
+        for (size_t i = 0; i < 8; i++)
+        {
+            h[i] += v[i];
+        }
+    }
+
+    return WordsToBytes(h, true);
+}
+
+}
+
+namespace literals
+{
+
+#pragma clang unsafe_buffer_usage begin
+consteval uint32_t operator""_fnv1_32(const char* Input, size_t Length) { return constant::Fnv1_32(std::string_view(Input, Length)); }
+consteval uint32_t operator""_fnv1a_32(const char* Input, size_t Length) { return constant::Fnv1a_32(std::string_view(Input, Length)); }
+consteval uint64_t operator""_fnv1_64(const char* Input, size_t Length) { return constant::Fnv1_64(std::string_view(Input, Length)); }
+consteval uint64_t operator""_fnv1a_64(const char* Input, size_t Length) { return constant::Fnv1a_64(std::string_view(Input, Length)); }
+consteval std::array<uint8_t, MD5_SIZE> operator""_md5(const char* Input, size_t Length) { return constant::Md5(std::string_view(Input, Length)); }
+consteval std::array<uint8_t, SHA1_SIZE> operator""_sha1(const char* Input, size_t Length) { return constant::Sha1(std::string_view(Input, Length)); }
+consteval std::array<uint8_t, SHA256_SIZE> operator""_sha256(const char* Input, size_t Length) { return constant::Sha256(std::string_view(Input, Length)); }
+#pragma clang unsafe_buffer_usage end
+
+}
+
 }
 
-#endif /* SimdHash_hpp */
\ No newline at end of file
+#endif /* SimdHash_hpp */
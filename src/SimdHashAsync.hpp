@@ -0,0 +1,210 @@
+//
+//  SimdHashAsync.hpp
+//  SimdHash
+//
+//  Created by Kryc on 18/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+// Awaitable hashing for C++20 coroutines. co_await async_hash(...) parks
+// the coroutine with an executor instead of hashing inline. When the
+// executor runs, every parked request is grouped by algorithm into SIMD
+// lane groups, hashed, and its coroutine resumed with the digest. Any
+// requests made by the resumed coroutines are batched in the next round.
+//
+// An executor is not thread safe; each thread has its own default one.
+
+#ifndef SimdHashAsync_hpp
+#define SimdHashAsync_hpp
+
+#include <algorithm>
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "simdhash.h"
+#include "SimdHash.hpp"
+
+namespace simdhash
+{
+
+class HashExecutor;
+
+class HashAwaitable
+{
+public:
+    HashAwaitable(
+        HashExecutor& Executor,
+        const HashAlgorithm Algorithm,
+        std::span<const uint8_t> Input
+    ) : m_Executor(Executor), m_Algorithm(Algorithm), m_Input(Input) {}
+
+    bool await_ready(void) const noexcept { return false; }
+    inline void await_suspend(std::coroutine_handle<> Handle);
+    Digest await_resume(void) { return std::move(m_Digest); }
+
+private:
+    friend class HashExecutor;
+    HashExecutor& m_Executor;
+    const HashAlgorithm m_Algorithm;
+    std::span<const uint8_t> m_Input;
+    std::coroutine_handle<> m_Handle;
+    Digest m_Digest;
+};
+
+class HashExecutor
+{
+public:
+    void
+    Schedule(
+        HashAwaitable* Awaitable
+    )
+    {
+        m_Pending.push_back(Awaitable);
+    }
+
+    const size_t GetPendingCount(void) const { return m_Pending.size(); }
+    const size_t GetGroupCount(void) const { return m_Groups; }
+
+    size_t
+    Run(void)
+    /*++
+     Hashes and resumes parked coroutines until none are left, returning
+     the number of requests completed. Every request of a round is hashed
+     before any coroutine is resumed so that the next round collects as
+     many requests as possible
+    --*/
+    {
+        size_t completed = 0;
+        std::vector<HashAwaitable*> round;
+        std::vector<std::coroutine_handle<>> handles;
+
+        while (!m_Pending.empty())
+        {
+            round.clear();
+            round.swap(m_Pending);
+
+            std::stable_sort(round.begin(), round.end(),
+                [](const HashAwaitable* A, const HashAwaitable* B) {
+                    return A->m_Algorithm < B->m_Algorithm;
+                });
+
+            const size_t lanes = SimdLanes();
+            for (size_t start = 0; start < round.size();)
+            {
+                size_t end = start + 1;
+                while (end < round.size() &&
+                       end - start < lanes &&
+                       round[end]->m_Algorithm == round[start]->m_Algorithm)
+                {
+                    end++;
+                }
+                HashGroup(std::span<HashAwaitable*>(round).subspan(start, end - start));
+                start = end;
+            }
+
+            // A resumed coroutine may destroy its awaitable, so take the
+            // handles out first
+            handles.clear();
+            for (HashAwaitable* awaitable : round)
+            {
+                handles.push_back(awaitable->m_Handle);
+            }
+            for (auto handle : handles)
+            {
+                handle.resume();
+            }
+            completed += handles.size();
+        }
+
+        return completed;
+    }
+
+private:
+    void
+    HashGroup(
+        std::span<HashAwaitable*> Group
+    )
+    {
+        std::array<size_t, MAX_LANES> lengths{};
+        std::array<const uint8_t*, MAX_LANES> buffers{};
+        std::array<uint8_t, MAX_LANES * MAX_HASH_SIZE> hashes;
+        std::span<const uint8_t> digests(hashes);
+        const HashAlgorithm algorithm = Group[0]->m_Algorithm;
+        const size_t hashWidth = GetHashWidth(algorithm);
+        static const uint8_t empty = 0;
+
+        for (size_t i = 0; i < Group.size(); i++)
+        {
+            lengths[i] = Group[i]->m_Input.size();
+            buffers[i] = lengths[i] ? Group[i]->m_Input.data() : &empty;
+        }
+
+        SimdHashAdaptive(algorithm, Group.size(), lengths.data(), buffers.data(), hashes.data());
+        m_Groups++;
+
+        for (size_t i = 0; i < Group.size(); i++)
+        {
+            const auto digest = digests.subspan(i * hashWidth, hashWidth);
+            Group[i]->m_Digest.assign(digest.begin(), digest.end());
+        }
+    }
+
+    std::vector<HashAwaitable*> m_Pending;
+    size_t m_Groups = 0;
+};
+
+inline void
+HashAwaitable::await_suspend(
+    std::coroutine_handle<> Handle
+)
+{
+    m_Handle = Handle;
+    m_Executor.Schedule(this);
+}
+
+inline HashExecutor&
+DefaultExecutor(void)
+{
+    thread_local HashExecutor executor;
+    return executor;
+}
+
+inline HashAwaitable
+async_hash(
+    HashExecutor& Executor,
+    const HashAlgorithm Algorithm,
+    std::span<const uint8_t> Input
+)
+/*++
+ The input is not copied and must stay valid until the coroutine resumes
+--*/
+{
+    return HashAwaitable(Executor, Algorithm, Input);
+}
+
+inline HashAwaitable
+async_hash(
+    const HashAlgorithm Algorithm,
+    std::span<const uint8_t> Input
+)
+{
+    return async_hash(DefaultExecutor(), Algorithm, Input);
+}
+
+inline HashAwaitable
+async_hash(
+    const HashAlgorithm Algorithm,
+    std::string_view Input
+)
+{
+    return async_hash(Algorithm, AsBytes(Input));
+}
+
+}
+
+#endif /* SimdHashAsync_hpp */
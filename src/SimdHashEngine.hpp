@@ -0,0 +1,795 @@
+//
+//  SimdHashEngine.hpp
+//  SimdHash
+//
+//  Created by Kryc on 18/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+// Header-only hash engine parameterised by instruction set and algorithm.
+//
+// isa::Library wraps the simd_t operations from simdcommon.h that the C
+// kernels use, and is the Native trait. The other traits name one vector
+// width each, so several widths can be instantiated in the same
+// translation unit: with -march=native on an AVX-512 machine both
+// Engine<isa::Avx2, ...> and Engine<isa::Avx512, ...> are available side
+// by side. A trait exists when the translation unit is compiled with its
+// instruction set enabled. The rounds are fully unrolled templates, so a
+// generator loop that fills a Block and calls Transform gets the whole
+// compression function inlined with no call into the library.
+
+#ifndef SimdHashEngine_hpp
+#define SimdHashEngine_hpp
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "simdhash.h"
+#include "SimdHash.hpp"
+
+// The unrolled rounds only keep their state in registers and fold
+// constant message words when every step is inlined into the caller
+#define ENGINE_INLINE __attribute__((always_inline))
+
+namespace simdhash
+{
+
+#pragma clang unsafe_buffer_usage begin
+
+namespace isa
+{
+
+//
+// In-register transposes of a square of Lanes vectors, turning one row
+// of message words per lane into one vector per message word
+//
+#if defined(__SSE2__)
+static inline ENGINE_INLINE void
+Transpose(
+    __m128i (&Rows)[4]
+)
+{
+    const __m128i t0 = _mm_unpacklo_epi32(Rows[0], Rows[1]);
+    const __m128i t1 = _mm_unpacklo_epi32(Rows[2], Rows[3]);
+    const __m128i t2 = _mm_unpackhi_epi32(Rows[0], Rows[1]);
+    const __m128i t3 = _mm_unpackhi_epi32(Rows[2], Rows[3]);
+    Rows[0] = _mm_unpacklo_epi64(t0, t1);
+    Rows[1] = _mm_unpackhi_epi64(t0, t1);
+    Rows[2] = _mm_unpacklo_epi64(t2, t3);
+    Rows[3] = _mm_unpackhi_epi64(t2, t3);
+}
+#endif
+
+#if defined(__AVX2__)
+static inline ENGINE_INLINE void
+Transpose(
+    __m256i (&Rows)[8]
+)
+{
+    // 4x4 transposes within each 128-bit half, then swap the halves
+    __m256i t[8];
+    for (size_t i = 0; i < 8; i += 2)
+    {
+        t[i] = _mm256_unpacklo_epi32(Rows[i], Rows[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(Rows[i], Rows[i + 1]);
+    }
+    __m256i u[8];
+    for (size_t i = 0; i < 8; i += 4)
+    {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        Rows[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        Rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+#endif
+
+#if defined(__AVX512F__)
+static inline ENGINE_INLINE void
+Transpose(
+    __m512i (&Rows)[16]
+)
+{
+    // 4x4 transposes within each 128-bit quarter, then a 4x4 transpose
+    // of the quarters across each group of four vectors
+    __m512i t[16];
+    for (size_t i = 0; i < 16; i += 2)
+    {
+        t[i] = _mm512_unpacklo_epi32(Rows[i], Rows[i + 1]);
+        t[i + 1] = _mm512_unpackhi_epi32(Rows[i], Rows[i + 1]);
+    }
+    __m512i u[16];
+    for (size_t i = 0; i < 16; i += 4)
+    {
+        u[i] = _mm512_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm512_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm512_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm512_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        const __m512i low01 = _mm512_shuffle_i32x4(u[i], u[i + 4], 0x44);
+        const __m512i high01 = _mm512_shuffle_i32x4(u[i], u[i + 4], 0xee);
+        const __m512i low23 = _mm512_shuffle_i32x4(u[i + 8], u[i + 12], 0x44);
+        const __m512i high23 = _mm512_shuffle_i32x4(u[i + 8], u[i + 12], 0xee);
+        Rows[i] = _mm512_shuffle_i32x4(low01, low23, 0x88);
+        Rows[i + 4] = _mm512_shuffle_i32x4(low01, low23, 0xdd);
+        Rows[i + 8] = _mm512_shuffle_i32x4(high01, high23, 0x88);
+        Rows[i + 12] = _mm512_shuffle_i32x4(high01, high23, 0xdd);
+    }
+}
+#endif
+
+#if defined(__ARM_NEON)
+static inline ENGINE_INLINE void
+Transpose(
+    uint32x4_t (&Rows)[4]
+)
+{
+    const uint32x4x2_t t01 = vtrnq_u32(Rows[0], Rows[1]);
+    const uint32x4x2_t t23 = vtrnq_u32(Rows[2], Rows[3]);
+    Rows[0] = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+    Rows[1] = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+    Rows[2] = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+    Rows[3] = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+}
+#endif
+
+struct Scalar
+{
+    using Vector = uint32_t;
+    static constexpr size_t Lanes = 1;
+
+    static inline Vector Load(const uint32_t* Words) { return *Words; }
+    static inline void Store(uint32_t* Words, const Vector V) { *Words = V; }
+    static inline Vector Set1(const uint32_t Value) { return Value; }
+    static inline Vector Add(const Vector A, const Vector B) { return A + B; }
+    static inline Vector Xor(const Vector A, const Vector B) { return A ^ B; }
+    static inline Vector Or(const Vector A, const Vector B) { return A | B; }
+    static inline Vector And(const Vector A, const Vector B) { return A & B; }
+    static inline Vector AndNot(const Vector A, const Vector B) { return ~A & B; }
+    static inline Vector Not(const Vector A) { return ~A; }
+    template <int N> static inline Vector ShiftLeft(const Vector A) { return A << N; }
+    template <int N> static inline Vector ShiftRight(const Vector A) { return A >> N; }
+    template <int N> static inline Vector RotateLeft(const Vector A) { return std::rotl(A, N); }
+    template <int N> static inline Vector RotateRight(const Vector A) { return std::rotr(A, N); }
+    static inline Vector ByteSwap(const Vector A) { return __builtin_bswap32(A); }
+    static inline void Transpose(Vector (&)[Lanes]) {}
+};
+
+#if defined(__SSE2__)
+struct Sse2
+{
+    using Vector = __m128i;
+    static constexpr size_t Lanes = 4;
+
+    static inline Vector Load(const uint32_t* Words) { return _mm_loadu_si128((const __m128i*)Words); }
+    static inline void Store(uint32_t* Words, const Vector V) { _mm_storeu_si128((__m128i*)Words, V); }
+    static inline Vector Set1(const uint32_t Value) { return _mm_set1_epi32((int)Value); }
+    static inline Vector Add(const Vector A, const Vector B) { return _mm_add_epi32(A, B); }
+    static inline Vector Xor(const Vector A, const Vector B) { return _mm_xor_si128(A, B); }
+    static inline Vector Or(const Vector A, const Vector B) { return _mm_or_si128(A, B); }
+    static inline Vector And(const Vector A, const Vector B) { return _mm_and_si128(A, B); }
+    static inline Vector AndNot(const Vector A, const Vector B) { return _mm_andnot_si128(A, B); }
+    static inline Vector Not(const Vector A) { return _mm_xor_si128(A, _mm_set1_epi32(-1)); }
+    template <int N> static inline Vector ShiftLeft(const Vector A) { return _mm_slli_epi32(A, N); }
+    template <int N> static inline Vector ShiftRight(const Vector A) { return _mm_srli_epi32(A, N); }
+    template <int N> static inline Vector RotateLeft(const Vector A) { return Or(ShiftLeft<N>(A), ShiftRight<32 - N>(A)); }
+    template <int N> static inline Vector RotateRight(const Vector A) { return RotateLeft<32 - N>(A); }
+    static inline Vector
+    ByteSwap(
+        const Vector A
+    )
+    {
+#if defined(__SSSE3__)
+        const __m128i mask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        return _mm_shuffle_epi8(A, mask);
+#else
+        // Swap the bytes of each word, then the words of each dword
+        const __m128i swapped = _mm_or_si128(_mm_slli_epi16(A, 8), _mm_srli_epi16(A, 8));
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(swapped, 0xb1), 0xb1);
+#endif
+    }
+    static inline void Transpose(Vector (&Rows)[Lanes]) { isa::Transpose(Rows); }
+};
+#endif
+
+#if defined(__AVX2__)
+struct Avx2
+{
+    using Vector = __m256i;
+    static constexpr size_t Lanes = 8;
+
+    static inline Vector Load(const uint32_t* Words) { return _mm256_loadu_si256((const __m256i*)Words); }
+    static inline void Store(uint32_t* Words, const Vector V) { _mm256_storeu_si256((__m256i*)Words, V); }
+    static inline Vector Set1(const uint32_t Value) { return _mm256_set1_epi32((int)Value); }
+    static inline Vector Add(const Vector A, const Vector B) { return _mm256_add_epi32(A, B); }
+    static inline Vector Xor(const Vector A, const Vector B) { return _mm256_xor_si256(A, B); }
+    static inline Vector Or(const Vector A, const Vector B) { return _mm256_or_si256(A, B); }
+    static inline Vector And(const Vector A, const Vector B) { return _mm256_and_si256(A, B); }
+    static inline Vector AndNot(const Vector A, const Vector B) { return _mm256_andnot_si256(A, B); }
+    static inline Vector Not(const Vector A) { return _mm256_xor_si256(A, _mm256_set1_epi32(-1)); }
+    template <int N> static inline Vector ShiftLeft(const Vector A) { return _mm256_slli_epi32(A, N); }
+    template <int N> static inline Vector ShiftRight(const Vector A) { return _mm256_srli_epi32(A, N); }
+    template <int N> static inline Vector RotateLeft(const Vector A) { return Or(ShiftLeft<N>(A), ShiftRight<32 - N>(A)); }
+    template <int N> static inline Vector RotateRight(const Vector A) { return RotateLeft<32 - N>(A); }
+    static inline Vector
+    ByteSwap(
+        const Vector A
+    )
+    {
+        const __m256i mask = _mm256_set_epi8(
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        return _mm256_shuffle_epi8(A, mask);
+    }
+    static inline void Transpose(Vector (&Rows)[Lanes]) { isa::Transpose(Rows); }
+};
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+struct Avx512
+{
+    using Vector = __m512i;
+    static constexpr size_t Lanes = 16;
+
+    static inline Vector Load(const uint32_t* Words) { return _mm512_loadu_si512((const void*)Words); }
+    static inline void Store(uint32_t* Words, const Vector V) { _mm512_storeu_si512((void*)Words, V); }
+    static inline Vector Set1(const uint32_t Value) { return _mm512_set1_epi32((int)Value); }
+    static inline Vector Add(const Vector A, const Vector B) { return _mm512_add_epi32(A, B); }
+    static inline Vector Xor(const Vector A, const Vector B) { return _mm512_xor_si512(A, B); }
+    static inline Vector Or(const Vector A, const Vector B) { return _mm512_or_si512(A, B); }
+    static inline Vector And(const Vector A, const Vector B) { return _mm512_and_si512(A, B); }
+    static inline Vector AndNot(const Vector A, const Vector B) { return _mm512_andnot_si512(A, B); }
+    static inline Vector Not(const Vector A) { return _mm512_ternarylogic_epi32(A, A, A, 0x55); }
+    template <int N> static inline Vector ShiftLeft(const Vector A) { return _mm512_slli_epi32(A, N); }
+    template <int N> static inline Vector ShiftRight(const Vector A) { return _mm512_srli_epi32(A, N); }
+    template <int N> static inline Vector RotateLeft(const Vector A) { return _mm512_rol_epi32(A, N); }
+    template <int N> static inline Vector RotateRight(const Vector A) { return _mm512_ror_epi32(A, N); }
+    static inline Vector
+    ByteSwap(
+        const Vector A
+    )
+    {
+        const __m512i mask = _mm512_broadcast_i32x4(
+            _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3));
+        return _mm512_shuffle_epi8(A, mask);
+    }
+    static inline void Transpose(Vector (&Rows)[Lanes]) { isa::Transpose(Rows); }
+};
+#endif
+
+#if defined(__ARM_NEON)
+struct Neon
+{
+    using Vector = uint32x4_t;
+    static constexpr size_t Lanes = 4;
+
+    static inline Vector Load(const uint32_t* Words) { return vld1q_u32(Words); }
+    static inline void Store(uint32_t* Words, const Vector V) { vst1q_u32(Words, V); }
+    static inline Vector Set1(const uint32_t Value) { return vdupq_n_u32(Value); }
+    static inline Vector Add(const Vector A, const Vector B) { return vaddq_u32(A, B); }
+    static inline Vector Xor(const Vector A, const Vector B) { return veorq_u32(A, B); }
+    static inline Vector Or(const Vector A, const Vector B) { return vorrq_u32(A, B); }
+    static inline Vector And(const Vector A, const Vector B) { return vandq_u32(A, B); }
+    static inline Vector AndNot(const Vector A, const Vector B) { return vbicq_u32(B, A); }
+    static inline Vector Not(const Vector A) { return vmvnq_u32(A); }
+    template <int N> static inline Vector ShiftLeft(const Vector A) { return vshlq_n_u32(A, N); }
+    template <int N> static inline Vector ShiftRight(const Vector A) { return vshrq_n_u32(A, N); }
+    template <int N> static inline Vector RotateLeft(const Vector A) { return vsriq_n_u32(vshlq_n_u32(A, N), A, 32 - N); }
+    template <int N> static inline Vector RotateRight(const Vector A) { return RotateLeft<32 - N>(A); }
+    static inline Vector ByteSwap(const Vector A) { return vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(A))); }
+    static inline void Transpose(Vector (&Rows)[Lanes]) { isa::Transpose(Rows); }
+};
+#endif
+
+//
+// The simdcommon.h operations on simd_t, matching the C library's
+// kernels lane for lane. Load and Store are unaligned
+//
+struct Library
+{
+    using Vector = simd_t;
+    static constexpr size_t Lanes = SIMD_WIDTH / 32;
+
+    static inline Vector Load(const uint32_t* Words) { Vector v; memcpy(&v, Words, sizeof(v)); return v; }
+    static inline void Store(uint32_t* Words, const Vector V) { memcpy(Words, &V, sizeof(V)); }
+    static inline Vector Set1(const uint32_t Value) { return set1_epi32(Value); }
+    static inline Vector Add(const Vector A, const Vector B) { return add_epi32(A, B); }
+    static inline Vector Xor(const Vector A, const Vector B) { return xor_simd(A, B); }
+    static inline Vector Or(const Vector A, const Vector B) { return or_simd(A, B); }
+    static inline Vector And(const Vector A, const Vector B) { return and_simd(A, B); }
+    static inline Vector AndNot(const Vector A, const Vector B) { return andnot_simd(A, B); }
+    static inline Vector Not(const Vector A) { return not_simd(A); }
+    template <int N> static inline Vector ShiftLeft(const Vector A) { return slli_epi32(A, N); }
+    template <int N> static inline Vector ShiftRight(const Vector A) { return srli_epi32(A, N); }
+    template <int N> static inline Vector RotateLeft(const Vector A) { return rotl_epi32(A, N); }
+    template <int N> static inline Vector RotateRight(const Vector A) { return rotr_epi32(A, N); }
+    static inline Vector ByteSwap(const Vector A) { return bswap_epi32(A); }
+    static inline void Transpose(Vector (&Rows)[Lanes]) { isa::Transpose(Rows); }
+};
+
+using Native = Library;
+
+}
+
+template <typename Isa, HashAlgorithm Algorithm>
+class Engine
+/*++
+ Block words are the message words as the algorithm reads them: little
+ endian for MD4 and MD5, big endian for SHA1 and SHA256. Block[i] holds
+ word i of every lane.
+--*/
+{
+public:
+    static_assert(
+        Algorithm == HashAlgorithmMD4 || Algorithm == HashAlgorithmMD5 ||
+        Algorithm == HashAlgorithmSHA1 || Algorithm == HashAlgorithmSHA256,
+        "Engine supports MD4, MD5, SHA1 and SHA256");
+
+    using Vector = typename Isa::Vector;
+    static constexpr size_t Lanes = Isa::Lanes;
+    static constexpr size_t DigestSize = HashWidth(Algorithm);
+    static constexpr size_t HCount = DigestSize / sizeof(uint32_t);
+    static constexpr bool BigEndian = Algorithm == HashAlgorithmSHA1 || Algorithm == HashAlgorithmSHA256;
+    static constexpr size_t BlockSize = 64;
+
+    // Plain arrays of vectors, since vector types lose their alignment
+    // attributes as std::array template arguments
+    template <size_t N>
+    struct Vectors
+    {
+        Vector Values[N];
+        Vector& operator[](const size_t Index) { return Values[Index]; }
+        const Vector& operator[](const size_t Index) const { return Values[Index]; }
+    };
+
+    using State = Vectors<HCount>;
+    using Block = Vectors<16>;
+
+    static inline State
+    Init(void)
+    {
+        State state;
+        for (size_t i = 0; i < HCount; i++)
+        {
+            state[i] = Isa::Set1(InitialH[i]);
+        }
+        return state;
+    }
+
+    static inline ENGINE_INLINE void
+    Transform(
+        State& H,
+        const Block& M
+    )
+    {
+        if constexpr (Algorithm == HashAlgorithmMD4)
+        {
+            Md4Transform(H, M);
+        }
+        else if constexpr (Algorithm == HashAlgorithmMD5)
+        {
+            Md5Transform(H, M);
+        }
+        else if constexpr (Algorithm == HashAlgorithmSHA1)
+        {
+            Sha1Transform(H, M);
+        }
+        else
+        {
+            Sha256Transform(H, M);
+        }
+    }
+
+    static inline ENGINE_INLINE void
+    LoadRows(
+        Block& M,
+        const uint32_t (&Rows)[Lanes][16]
+    )
+    /*++
+     Rows holds the 16 words of one lane's block in memory order. They
+     are loaded as vectors and transposed a square of Lanes words at a
+     time so M[i] holds word i of every lane
+    --*/
+    {
+        for (size_t i = 0; i < 16; i += Lanes)
+        {
+            Vector tile[Lanes];
+            for (size_t lane = 0; lane < Lanes; lane++)
+            {
+                tile[lane] = Isa::Load(&Rows[lane][i]);
+            }
+            Isa::Transpose(tile);
+            for (size_t j = 0; j < Lanes; j++)
+            {
+                M[i + j] = BigEndian ? Isa::ByteSwap(tile[j]) : tile[j];
+            }
+        }
+    }
+
+    static void
+    LoadBlock(
+        Block& M,
+        const size_t Lengths[],
+        const uint8_t* const Buffers[],
+        const size_t BlockIndex
+    )
+    /*++
+     Loads block BlockIndex of each lane's padded message
+    --*/
+    {
+        alignas(64) uint32_t rows[Lanes][16];
+        const size_t offset = BlockIndex * BlockSize;
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            if (offset + BlockSize <= Lengths[lane])
+            {
+                memcpy(rows[lane], &Buffers[lane][offset], BlockSize);
+            }
+            else
+            {
+                PadRow(rows[lane], Buffers[lane], Lengths[lane], offset);
+            }
+        }
+        LoadRows(M, rows);
+    }
+
+    static void
+    Hash(
+        const size_t Lengths[],
+        const uint8_t* const Buffers[],
+        uint8_t* HashBuffers
+    )
+    /*++
+     Hashes Lanes whole messages of any length, writing Lanes digests
+     back to back. Lanes whose message ends early keep their state while
+     the longer ones finish
+    --*/
+    {
+        State h = Init();
+        Block m;
+        size_t maxBlocks = 0;
+        alignas(64) uint32_t blocks[Lanes];
+
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            blocks[lane] = (uint32_t)BlockCount(Lengths[lane]);
+            maxBlocks = blocks[lane] > maxBlocks ? blocks[lane] : maxBlocks;
+        }
+
+        for (size_t block = 0; block < maxBlocks; block++)
+        {
+            bool uniform = true;
+            alignas(64) uint32_t done[Lanes];
+            for (size_t lane = 0; lane < Lanes; lane++)
+            {
+                done[lane] = blocks[lane] <= block ? 0xffffffff : 0;
+                uniform &= done[lane] == 0;
+            }
+
+            LoadBlock(m, Lengths, Buffers, block);
+            if (uniform)
+            {
+                Transform(h, m);
+                continue;
+            }
+
+            const State previous = h;
+            const Vector keep = Isa::Load(done);
+            Transform(h, m);
+            for (size_t i = 0; i < HCount; i++)
+            {
+                h[i] = Isa::Or(Isa::And(keep, previous[i]), Isa::AndNot(keep, h[i]));
+            }
+        }
+
+        GetDigests(h, HashBuffers);
+    }
+
+    static void
+    GetDigests(
+        const State& H,
+        uint8_t* HashBuffers
+    )
+    {
+        alignas(64) uint32_t words[HCount][Lanes];
+        for (size_t i = 0; i < HCount; i++)
+        {
+            Isa::Store(words[i], BigEndian ? Isa::ByteSwap(H[i]) : H[i]);
+        }
+        for (size_t lane = 0; lane < Lanes; lane++)
+        {
+            for (size_t i = 0; i < HCount; i++)
+            {
+                memcpy(&HashBuffers[lane * DigestSize + i * sizeof(uint32_t)], &words[i][lane], sizeof(uint32_t));
+            }
+        }
+    }
+
+private:
+    static constexpr std::array<uint32_t, 8> InitialH =
+        Algorithm == HashAlgorithmSHA256 ?
+            std::array<uint32_t, 8>{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 } :
+            std::array<uint32_t, 8>{ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476,
+                                     0xc3d2e1f0, 0, 0, 0 };
+
+    static constexpr int Md4Shifts[12] = { 3, 7, 11, 19, 3, 5, 9, 13, 3, 9, 11, 15 };
+    static constexpr size_t Md4Order[48] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+        0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+        0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15
+    };
+
+    static constexpr size_t
+    BlockCount(
+        const size_t Length
+    )
+    {
+        return (Length + sizeof(uint64_t)) / BlockSize + 1;
+    }
+
+    static inline void
+    PadRow(
+        uint32_t (&Row)[16],
+        const uint8_t* Buffer,
+        const size_t Length,
+        const size_t Offset
+    )
+    /*++
+     Writes the block at Offset of the padded message: the message tail,
+     0x80, zeros and the bit length in the last block
+    --*/
+    {
+        uint8_t* row = reinterpret_cast<uint8_t*>(Row);
+        memset(row, 0, BlockSize);
+        if (Offset < Length)
+        {
+            memcpy(row, &Buffer[Offset], Length - Offset);
+        }
+        if (Offset <= Length)
+        {
+            row[Length - Offset] = 0x80;
+        }
+        if (Offset / BlockSize + 1 == BlockCount(Length))
+        {
+            const uint64_t bitLength = (uint64_t)Length * 8;
+            const uint64_t stored = BigEndian ? __builtin_bswap64(bitLength) : bitLength;
+            memcpy(&row[BlockSize - sizeof(uint64_t)], &stored, sizeof(stored));
+        }
+    }
+
+    template <typename Function, size_t... I>
+    static inline ENGINE_INLINE void
+    UnrollImpl(
+        Function&& Round,
+        std::index_sequence<I...>
+    )
+    {
+        (Round(std::integral_constant<size_t, I>{}), ...);
+    }
+
+    template <size_t Count, typename Function>
+    static inline ENGINE_INLINE void
+    Unroll(
+        Function&& Round
+    )
+    {
+        UnrollImpl(Round, std::make_index_sequence<Count>{});
+    }
+
+    static inline ENGINE_INLINE void
+    Md4Transform(
+        State& H,
+        const Block& M
+    )
+    {
+        State v = H;
+
+        // The working variables rotate through v rather than being moved
+        Unroll<48>([&](auto I) ENGINE_INLINE
+        {
+            constexpr size_t i = I;
+            Vector& a = v[(4 - i % 4) % 4];
+            const Vector b = v[(5 - i % 4) % 4];
+            const Vector c = v[(6 - i % 4) % 4];
+            const Vector d = v[(7 - i % 4) % 4];
+            Vector f;
+            uint32_t k;
+            if constexpr (i < 16)
+            {
+                f = Isa::Or(Isa::And(b, c), Isa::AndNot(b, d));
+                k = 0;
+            }
+            else if constexpr (i < 32)
+            {
+                f = Isa::Or(Isa::And(b, Isa::Or(c, d)), Isa::And(c, d));
+                k = 0x5a827999;
+            }
+            else
+            {
+                f = Isa::Xor(b, Isa::Xor(c, d));
+                k = 0x6ed9eba1;
+            }
+            Vector t = Isa::Add(Isa::Add(a, f), M[Md4Order[i]]);
+            if (k != 0)
+            {
+                t = Isa::Add(t, Isa::Set1(k));
+            }
+            a = Isa::template RotateLeft<Md4Shifts[i % 4 + i / 16 * 4]>(t);
+        });
+
+        for (size_t i = 0; i < HCount; i++)
+        {
+            H[i] = Isa::Add(H[i], v[i]);
+        }
+    }
+
+    static inline ENGINE_INLINE void
+    Md5Transform(
+        State& H,
+        const Block& M
+    )
+    {
+        State v = H;
+
+        Unroll<64>([&](auto I) ENGINE_INLINE
+        {
+            constexpr size_t i = I;
+            Vector& a = v[(4 - i % 4) % 4];
+            const Vector b = v[(5 - i % 4) % 4];
+            const Vector c = v[(6 - i % 4) % 4];
+            const Vector d = v[(7 - i % 4) % 4];
+            Vector f;
+            size_t g;
+            if constexpr (i < 16)
+            {
+                f = Isa::Or(Isa::And(b, c), Isa::AndNot(b, d));
+                g = i;
+            }
+            else if constexpr (i < 32)
+            {
+                f = Isa::Or(Isa::And(d, b), Isa::AndNot(d, c));
+                g = (5 * i + 1) % 16;
+            }
+            else if constexpr (i < 48)
+            {
+                f = Isa::Xor(b, Isa::Xor(c, d));
+                g = (3 * i + 5) % 16;
+            }
+            else
+            {
+                f = Isa::Xor(c, Isa::Or(b, Isa::Not(d)));
+                g = (7 * i) % 16;
+            }
+            const Vector t = Isa::Add(Isa::Add(a, f), Isa::Add(Isa::Set1(constant::Md5Constants[i]), M[g]));
+            a = Isa::Add(b, Isa::template RotateLeft<constant::Md5Shifts[i]>(t));
+        });
+
+        for (size_t i = 0; i < HCount; i++)
+        {
+            H[i] = Isa::Add(H[i], v[i]);
+        }
+    }
+
+    static inline ENGINE_INLINE void
+    Sha1Transform(
+        State& H,
+        const Block& M
+    )
+    {
+        Block w = M;
+        State v = H;
+
+        Unroll<80>([&](auto I) ENGINE_INLINE
+        {
+            constexpr size_t i = I;
+            const Vector a = v[(5 - i % 5) % 5];
+            Vector& b = v[(6 - i % 5) % 5];
+            const Vector c = v[(7 - i % 5) % 5];
+            const Vector d = v[(8 - i % 5) % 5];
+            Vector& e = v[(9 - i % 5) % 5];
+            if constexpr (i >= 16)
+            {
+                w[i % 16] = Isa::template RotateLeft<1>(
+                    Isa::Xor(Isa::Xor(w[(i - 3) % 16], w[(i - 8) % 16]), Isa::Xor(w[(i - 14) % 16], w[i % 16])));
+            }
+            Vector f;
+            uint32_t k;
+            if constexpr (i < 20)
+            {
+                f = Isa::Or(Isa::And(b, c), Isa::AndNot(b, d));
+                k = 0x5a827999;
+            }
+            else if constexpr (i < 40)
+            {
+                f = Isa::Xor(b, Isa::Xor(c, d));
+                k = 0x6ed9eba1;
+            }
+            else if constexpr (i < 60)
+            {
+                f = Isa::Or(Isa::And(b, Isa::Or(c, d)), Isa::And(c, d));
+                k = 0x8f1bbcdc;
+            }
+            else
+            {
+                f = Isa::Xor(b, Isa::Xor(c, d));
+                k = 0xca62c1d6;
+            }
+            e = Isa::Add(Isa::Add(Isa::template RotateLeft<5>(a), f), Isa::Add(Isa::Add(e, Isa::Set1(k)), w[i % 16]));
+            b = Isa::template RotateLeft<30>(b);
+        });
+
+        for (size_t i = 0; i < HCount; i++)
+        {
+            H[i] = Isa::Add(H[i], v[i]);
+        }
+    }
+
+    static inline ENGINE_INLINE void
+    Sha256Transform(
+        State& H,
+        const Block& M
+    )
+    {
+        Block w = M;
+        State v = H;
+
+        Unroll<64>([&](auto I) ENGINE_INLINE
+        {
+            constexpr size_t i = I;
+            const Vector a = v[(8 - i % 8) % 8];
+            const Vector b = v[(9 - i % 8) % 8];
+            const Vector c = v[(10 - i % 8) % 8];
+            Vector& d = v[(11 - i % 8) % 8];
+            const Vector e = v[(12 - i % 8) % 8];
+            const Vector f = v[(13 - i % 8) % 8];
+            const Vector g = v[(14 - i % 8) % 8];
+            Vector& h = v[(15 - i % 8) % 8];
+            if constexpr (i >= 16)
+            {
+                const Vector w15 = w[(i - 15) % 16];
+                const Vector w2 = w[(i - 2) % 16];
+                const Vector s0 = Isa::Xor(Isa::Xor(Isa::template RotateRight<7>(w15), Isa::template RotateRight<18>(w15)), Isa::template ShiftRight<3>(w15));
+                const Vector s1 = Isa::Xor(Isa::Xor(Isa::template RotateRight<17>(w2), Isa::template RotateRight<19>(w2)), Isa::template ShiftRight<10>(w2));
+                w[i % 16] = Isa::Add(Isa::Add(w[i % 16], s0), Isa::Add(w[(i - 7) % 16], s1));
+            }
+            const Vector s1 = Isa::Xor(Isa::Xor(Isa::template RotateRight<6>(e), Isa::template RotateRight<11>(e)), Isa::template RotateRight<25>(e));
+            const Vector choice = Isa::Xor(Isa::And(e, f), Isa::AndNot(e, g));
+            const Vector temp1 = Isa::Add(Isa::Add(Isa::Add(h, s1), Isa::Add(choice, Isa::Set1(constant::Sha256Constants[i]))), w[i % 16]);
+            const Vector s0 = Isa::Xor(Isa::Xor(Isa::template RotateRight<2>(a), Isa::template RotateRight<13>(a)), Isa::template RotateRight<22>(a));
+            const Vector majority = Isa::Xor(Isa::Xor(Isa::And(a, b), Isa::And(a, c)), Isa::And(b, c));
+            d = Isa::Add(d, temp1);
+            h = Isa::Add(temp1, Isa::Add(s0, majority));
+        });
+
+        for (size_t i = 0; i < HCount; i++)
+        {
+            H[i] = Isa::Add(H[i], v[i]);
+        }
+    }
+};
+
+#pragma clang unsafe_buffer_usage end
+
+}
+
+#undef ENGINE_INLINE
+
+#endif /* SimdHashEngine_hpp */
@@ -0,0 +1,233 @@
+//
+//  SimdHashFixed.hpp
+//  SimdHash
+//
+//  Created by Kryc on 18/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+// Single block kernels specialised at compile time for a fixed input
+// length. When every lane has the same length the padding byte, the
+// zero words and the length word are all known constants. The kernels
+// load the whole block of every lane as usual, then overwrite those words
+// with Set1 values before running Engine<isa::Native, Algorithm>. The
+// rounds therefore see compile time constants, which the compiler folds
+// into the round constants and the message schedule.
+
+#ifndef SimdHashFixed_hpp
+#define SimdHashFixed_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "simdhash.h"
+#include "SimdHash.hpp"
+#include "SimdHashEngine.hpp"
+
+namespace simdhash
+{
+
+namespace fixed
+{
+
+#pragma clang unsafe_buffer_usage begin
+
+enum class WordKind
+{
+    Zero,
+    Constant,
+    Variable
+};
+
+struct MessageWord
+{
+    WordKind Kind;
+    // The word value when Kind is Constant
+    uint32_t Value;
+};
+
+inline constexpr size_t MaxLength = MAX_OPTIMIZED_BUFFER_SIZE;
+
+template <size_t Length, bool BigEndian>
+constexpr MessageWord
+BlockWord(
+    const size_t Index
+)
+/*++
+ Classifies a word of the single padded block of a Length byte message
+ --*/
+{
+    static_assert(Length <= MaxLength, "Fixed kernels only cover a single block");
+    const size_t padIndex = Length / 4;
+    if (Index < padIndex)
+    {
+        return { WordKind::Variable, 0 };
+    }
+    if (Index == padIndex)
+    {
+        if (Length % 4 != 0)
+        {
+            // Padding byte is gathered along with the message tail
+            return { WordKind::Variable, 0 };
+        }
+        return { WordKind::Constant, BigEndian ? 0x80000000u : 0x00000080u };
+    }
+    if (Index == (BigEndian ? 15u : 14u))
+    {
+        return { WordKind::Constant, (uint32_t)(Length * 8) };
+    }
+    return { WordKind::Zero, 0 };
+}
+
+template <HashAlgorithm Algorithm, size_t Length>
+inline void
+LoadBlock(
+    const uint8_t* const Buffers[],
+    typename Engine<isa::Native, Algorithm>::Block& M
+)
+/*++
+ Copies each lane's message and padding byte into a zeroed row and
+ transposes all 16 words of every row with Compressor::LoadRows. The
+ padding, zero and length words are then overwritten with Set1 values,
+ so the rounds only read the transposed message words
+ --*/
+{
+    using Compressor = Engine<isa::Native, Algorithm>;
+    alignas(64) uint32_t rows[Compressor::Lanes][16] = {};
+    const uint8_t pad = 0x80;
+    for (size_t lane = 0; lane < Compressor::Lanes; lane++)
+    {
+        uint8_t* row = reinterpret_cast<uint8_t*>(rows[lane]);
+        std::memcpy(row, Buffers[lane], Length);
+        std::memcpy(row + Length, &pad, sizeof(pad));
+    }
+    Compressor::LoadRows(M, rows);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        const MessageWord word = BlockWord<Length, Compressor::BigEndian>(i);
+        if (word.Kind != WordKind::Variable)
+        {
+            M[i] = isa::Native::Set1(word.Value);
+        }
+    }
+}
+
+//
+// Runtime dispatch
+//
+using Kernel = void (*)(SimdHashContext*, const uint8_t* const[]);
+
+template <HashAlgorithm Algorithm, size_t Length>
+inline void
+KernelFor(
+    SimdHashContext* Context,
+    const uint8_t* const Buffers[]
+)
+{
+    using Compressor = Engine<isa::Native, Algorithm>;
+    typename Compressor::Block m;
+    LoadBlock<Algorithm, Length>(Buffers, m);
+
+    typename Compressor::State h = Compressor::Init();
+    Compressor::Transform(h, m);
+    for (size_t i = 0; i < Compressor::HCount; i++)
+    {
+        isa::Native::Store(Context->H[i].epi32_u32, Compressor::BigEndian ? isa::Native::ByteSwap(h[i]) : h[i]);
+    }
+    Context->HSize = Compressor::HCount;
+    Context->HashSize = Compressor::DigestSize;
+    Context->Lanes = Compressor::Lanes;
+    Context->Algorithm = Algorithm;
+}
+
+template <HashAlgorithm Algorithm, size_t... Lengths>
+constexpr std::array<Kernel, sizeof...(Lengths)>
+MakeKernels(
+    std::index_sequence<Lengths...>
+)
+{
+    // Index 0 is the 1 byte kernel
+    return { &KernelFor<Algorithm, Lengths + 1>... };
+}
+
+inline Kernel
+GetKernel(
+    const HashAlgorithm Algorithm,
+    const size_t Length
+)
+{
+    static constexpr auto md4 = MakeKernels<HashAlgorithmMD4>(std::make_index_sequence<MaxLength>{});
+    static constexpr auto md5 = MakeKernels<HashAlgorithmMD5>(std::make_index_sequence<MaxLength>{});
+    static constexpr auto sha1 = MakeKernels<HashAlgorithmSHA1>(std::make_index_sequence<MaxLength>{});
+    static constexpr auto sha256 = MakeKernels<HashAlgorithmSHA256>(std::make_index_sequence<MaxLength>{});
+
+    if (Length == 0 || Length > MaxLength)
+    {
+        return nullptr;
+    }
+
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+        return md4[Length - 1];
+    case HashAlgorithmMD5:
+        return md5[Length - 1];
+    case HashAlgorithmSHA1:
+        return sha1[Length - 1];
+    case HashAlgorithmSHA256:
+        return sha256[Length - 1];
+    default:
+        return nullptr;
+    }
+}
+
+#pragma clang unsafe_buffer_usage end
+
+} // namespace fixed
+
+//
+// Returns true if a compile-time specialised kernel exists
+// for every lane having the given Length
+//
+static inline bool
+SupportsFixedLength(
+    const HashAlgorithm Algorithm,
+    const size_t Length
+)
+{
+    return fixed::GetKernel(Algorithm, Length) != nullptr;
+}
+
+//
+// Hash SimdLanes() inputs of identical Length with the specialised
+// kernel for that length and write the digests to HashBuffers in the
+// same layout as SimdHashGetHashes. Returns false, without touching
+// HashBuffers, if no kernel exists for Algorithm and Length.
+//
+static inline bool
+SimdHashFixed(
+    const HashAlgorithm Algorithm,
+    const size_t Length,
+    const uint8_t* const Buffers[],
+    uint8_t* HashBuffers
+)
+{
+    const fixed::Kernel kernel = fixed::GetKernel(Algorithm, Length);
+    if (kernel == nullptr)
+    {
+        return false;
+    }
+
+    SimdHashContext ctx;
+    kernel(&ctx, Buffers);
+    SimdHashGetHashes(&ctx, HashBuffers);
+    return true;
+}
+
+}
+
+#endif /* SimdHashFixed_hpp */
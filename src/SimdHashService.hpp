@@ -0,0 +1,386 @@
+//
+//  SimdHashService.hpp
+//  SimdHash
+//
+//  Created by Kryc on 18/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+// In-process micro-batching hash service. Any number of threads submit
+// single inputs through a lock-free multi-producer ring; one worker
+// gathers them into SIMD lane groups and hashes each group together.
+// A group that has not filled by the latency deadline is flushed partially
+// filled, so a lone request never waits longer than the deadline for
+// company. Digests are returned through a future or a callback.
+
+#ifndef SimdHashService_hpp
+#define SimdHashService_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "simdhash.h"
+#include "SimdHash.hpp"
+
+namespace simdhash
+{
+
+using DigestCallback = std::function<void(std::span<const uint8_t>)>;
+
+class HashService
+{
+public:
+    HashService(
+        const HashAlgorithm Algorithm,
+        const std::chrono::microseconds Deadline = std::chrono::microseconds(100),
+        const size_t Capacity = 4096
+    ) :
+        m_Algorithm(Algorithm),
+        m_HashWidth(::GetHashWidth(Algorithm)),
+        m_Lanes(SimdLanes()),
+        m_Deadline(Deadline),
+        m_Ring(RoundUpPowerOfTwo(Capacity)),
+        m_Mask(m_Ring.size() - 1)
+    {
+        for (size_t i = 0; i < m_Ring.size(); i++)
+        {
+            m_Ring[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+        m_Worker = std::thread(&HashService::Run, this);
+    }
+
+    HashService(const HashService&) = delete;
+    HashService& operator=(const HashService&) = delete;
+
+    ~HashService(void)
+    {
+        // Outstanding requests are completed before the worker exits
+        m_Stop.store(true, std::memory_order_release);
+        Wake(true);
+        m_Worker.join();
+    }
+
+    std::future<Digest>
+    Submit(
+        std::span<const uint8_t> Input
+    )
+    {
+        std::future<Digest> future;
+        Enqueue(Input, [&](Request& Pending)
+        {
+            future = Pending.Promise.emplace().get_future();
+        });
+        return future;
+    }
+
+    std::future<Digest>
+    Submit(
+        std::string_view Input
+    )
+    {
+        return Submit(AsBytes(Input));
+    }
+
+    void
+    Submit(
+        std::span<const uint8_t> Input,
+        DigestCallback Callback
+    )
+    /*++
+     The callback runs on the worker thread and must not block it
+    --*/
+    {
+        Enqueue(Input, [&](Request& Pending)
+        {
+            Pending.Callback = std::move(Callback);
+        });
+    }
+
+    void
+    Submit(
+        std::string_view Input,
+        DigestCallback Callback
+    )
+    {
+        Submit(AsBytes(Input), std::move(Callback));
+    }
+
+    const HashAlgorithm GetAlgorithm(void) const { return m_Algorithm; }
+    const size_t GetHashWidth(void) const { return m_HashWidth; }
+    const std::chrono::microseconds GetDeadline(void) const { return m_Deadline; }
+
+private:
+    // Requests live in the ring slots and are reused, so once a slot's
+    // Data has grown to fit the inputs it sees, submitting allocates
+    // nothing beyond what a future or callback needs itself
+    struct Request
+    {
+        std::vector<uint8_t> Data;
+        std::chrono::steady_clock::time_point Submitted;
+        std::optional<std::promise<Digest>> Promise;
+        DigestCallback Callback;
+    };
+
+    static constexpr size_t MaxRetainedInput = 4096;
+
+    struct alignas(64) Slot
+    {
+        std::atomic<size_t> Sequence;
+        Request Value;
+    };
+
+    static size_t
+    RoundUpPowerOfTwo(
+        const size_t Value
+    )
+    {
+        size_t result = 2;
+        while (result < Value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    template <typename Fill>
+    bool
+    TryPush(
+        std::span<const uint8_t> Input,
+        Fill& FillRequest
+    )
+    /*++
+     Bounded multi-producer ring. Each slot carries a sequence number that
+     tells a producer whether the slot is free for its ticket and tells
+     the consumer whether the request in it has been published. The
+     request is written in place while the producer holds the ticket
+    --*/
+    {
+        size_t tail = m_Tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot& slot = m_Ring[tail & m_Mask];
+            const size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+            const intptr_t difference = (intptr_t)sequence - (intptr_t)tail;
+            if (difference == 0)
+            {
+                if (m_Tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                {
+                    Request& request = slot.Value;
+                    request.Data.assign(Input.begin(), Input.end());
+                    request.Submitted = std::chrono::steady_clock::now();
+                    FillRequest(request);
+                    slot.Sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                // Full
+                return false;
+            }
+            else
+            {
+                tail = m_Tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Request*
+    TryPop(void)
+    /*++
+     The slot stays claimed until Release, so the request can be hashed
+     where it is
+    --*/
+    {
+        Slot& slot = m_Ring[m_Head & m_Mask];
+        if (slot.Sequence.load(std::memory_order_acquire) != m_Head + 1)
+        {
+            return nullptr;
+        }
+        m_Head++;
+        return &slot.Value;
+    }
+
+    void
+    Release(
+        const size_t Count
+    )
+    /*++
+     Hands the oldest Count popped slots back to the producers. Requests
+     are completed in the order they were popped
+    --*/
+    {
+        for (size_t i = 0; i < Count; i++)
+        {
+            Slot& slot = m_Ring[m_Released & m_Mask];
+            slot.Value.Promise.reset();
+            slot.Value.Callback = nullptr;
+            if (slot.Value.Data.capacity() > MaxRetainedInput)
+            {
+                // Don't let one large input pin its buffer in the ring
+                std::vector<uint8_t>().swap(slot.Value.Data);
+            }
+            slot.Sequence.store(m_Released + m_Ring.size(), std::memory_order_release);
+            m_Released++;
+        }
+    }
+
+    template <typename Fill>
+    void
+    Enqueue(
+        std::span<const uint8_t> Input,
+        Fill&& FillRequest
+    )
+    {
+        while (!TryPush(Input, FillRequest))
+        {
+            // Let the worker drain the ring
+            Wake(true);
+            std::this_thread::yield();
+        }
+        Wake(false);
+    }
+
+    void
+    Wake(
+        const bool Always
+    )
+    /*++
+     Producers only touch the mutex when the worker is asleep, so the
+     submission path stays lock-free while the service is busy
+    --*/
+    {
+        // Pairs with the fence in Run so that either the worker sees the
+        // new request or the producer sees the worker asleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (Always || m_Sleeping.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Wakeup.notify_one();
+        }
+    }
+
+    void
+    Complete(
+        const size_t Count
+    )
+    {
+        std::array<size_t, MAX_LANES> lengths{};
+        std::array<const uint8_t*, MAX_LANES> buffers{};
+        std::array<uint8_t, MAX_LANES * MAX_HASH_SIZE> hashes;
+        std::span<const uint8_t> digests(hashes);
+        static const uint8_t empty = 0;
+
+        for (size_t i = 0; i < Count; i++)
+        {
+            // An empty vector may not have storage to point at
+            lengths[i] = m_Batch[i]->Data.size();
+            buffers[i] = lengths[i] ? m_Batch[i]->Data.data() : &empty;
+        }
+
+        SimdHashAdaptive(m_Algorithm, Count, lengths.data(), buffers.data(), hashes.data());
+
+        for (size_t i = 0; i < Count; i++)
+        {
+            Request* request = m_Batch[i];
+            const auto digest = digests.subspan(i * m_HashWidth, m_HashWidth);
+            if (request->Callback)
+            {
+                request->Callback(digest);
+            }
+            else
+            {
+                request->Promise->set_value(Digest(digest.begin(), digest.end()));
+            }
+        }
+
+        Release(Count);
+    }
+
+    void
+    Run(void)
+    {
+        size_t count = 0;
+
+        for (;;)
+        {
+            // Top up the current group from the ring
+            while (count < m_Lanes)
+            {
+                Request* request = TryPop();
+                if (request == nullptr)
+                {
+                    break;
+                }
+                m_Batch[count++] = request;
+            }
+
+            const bool stopping = m_Stop.load(std::memory_order_acquire);
+            const auto now = std::chrono::steady_clock::now();
+
+            if (count == m_Lanes ||
+                (count > 0 && (stopping || now >= m_Batch[0]->Submitted + m_Deadline)))
+            {
+                Complete(count);
+                count = 0;
+                continue;
+            }
+
+            if (count == 0 && stopping)
+            {
+                break;
+            }
+
+            // Sleep until the oldest request is due, or until woken when idle
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const Slot& next = m_Ring[m_Head & m_Mask];
+            if (next.Sequence.load(std::memory_order_acquire) != m_Head + 1 &&
+                !m_Stop.load(std::memory_order_acquire))
+            {
+                if (count > 0)
+                {
+                    m_Wakeup.wait_until(lock, m_Batch[0]->Submitted + m_Deadline);
+                }
+                else
+                {
+                    m_Wakeup.wait(lock);
+                }
+            }
+            m_Sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    const HashAlgorithm m_Algorithm;
+    const size_t m_HashWidth;
+    const size_t m_Lanes;
+    const std::chrono::microseconds m_Deadline;
+    std::vector<Slot> m_Ring;
+    const size_t m_Mask;
+    alignas(64) std::atomic<size_t> m_Tail{0};
+    alignas(64) size_t m_Head = 0;
+    size_t m_Released = 0;
+    std::array<Request*, MAX_LANES> m_Batch{};
+    std::atomic<bool> m_Sleeping{false};
+    std::atomic<bool> m_Stop{false};
+    std::mutex m_Mutex;
+    std::condition_variable m_Wakeup;
+    std::thread m_Worker;
+};
+
+}
+
+#endif /* SimdHashService_hpp */
@@ -0,0 +1,223 @@
+//
+//  SimdHashViews.hpp
+//  SimdHash
+//
+//  Created by Kryc on 18/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+// Lazy hashing range adaptor.
+//
+//     for (auto [input, digest] : lines | simdhash::views::hash(HashAlgorithmSHA1))
+//
+// pulls SimdLanes() elements at a time from the underlying range, copies
+// them into a SimdHashBufferFixed, hashes them as one batch and then
+// yields (input, digest) pairs. Both halves of a pair point into the
+// view's batch and are valid until the iterator moves past that batch.
+
+#ifndef SimdHashViews_hpp
+#define SimdHashViews_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "simdhash.h"
+#include "SimdHash.hpp"
+#include "SimdHashBuffer.hpp"
+
+namespace simdhash
+{
+
+// Inputs up to this length are buffered without allocation
+inline constexpr size_t DefaultViewWidth = 128;
+
+template <std::ranges::input_range V, size_t Width = DefaultViewWidth>
+    requires std::ranges::view<V> && ByteSequence<std::ranges::range_reference_t<V>>
+class hash_view : public std::ranges::view_interface<hash_view<V, Width>>
+{
+public:
+    using value_type = std::pair<std::string_view, std::span<const uint8_t>>;
+
+    hash_view(
+        V Base,
+        const HashAlgorithm Algorithm
+    ) : m_Base(std::move(Base)), m_Algorithm(Algorithm), m_HashWidth(GetHashWidth(Algorithm)) {}
+
+    class iterator
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = hash_view::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator(void) = default;
+        explicit iterator(hash_view* Parent) : m_Parent(Parent) {}
+        iterator(iterator&&) = default;
+        iterator& operator=(iterator&&) = default;
+
+        value_type operator*(void) const { return m_Parent->Current(); }
+        iterator& operator++(void) { m_Parent->Advance(); return *this; }
+        void operator++(int) { ++*this; }
+
+        friend bool
+        operator==(
+            const iterator& Iterator,
+            std::default_sentinel_t
+        )
+        {
+            return Iterator.AtEnd();
+        }
+
+    private:
+        bool AtEnd(void) const { return m_Parent->Done(); }
+        hash_view* m_Parent = nullptr;
+    };
+
+    iterator
+    begin(void)
+    /*++
+     Single pass, like the input ranges it is built for. The batch state
+     is allocated once here rather than in the view so that the view can
+     be moved around freely before iteration starts
+    --*/
+    {
+        m_State = std::make_unique<State>(std::ranges::begin(m_Base));
+        Fill();
+        return iterator(this);
+    }
+
+    std::default_sentinel_t end(void) const { return std::default_sentinel; }
+
+private:
+    struct State
+    {
+        explicit State(std::ranges::iterator_t<V> Begin) : Next(std::move(Begin)) {}
+        std::ranges::iterator_t<V> Next;
+        SimdHashBufferFixed<Width> Buffer;
+        // Longer inputs keep their storage between batches
+        std::array<std::string, MAX_LANES> Overflow;
+        std::array<size_t, MAX_LANES> Lengths{};
+        std::array<const uint8_t*, MAX_LANES> Buffers{};
+        std::array<uint8_t, MAX_LANES * MAX_HASH_SIZE> Hashes;
+        size_t Count = 0;
+        size_t Index = 0;
+    };
+
+#pragma clang unsafe_buffer_usage begin
+    void
+    Fill(void)
+    {
+        State& state = *m_State;
+        const size_t lanes = SimdLanes();
+
+        state.Count = 0;
+        state.Index = 0;
+        while (state.Count < lanes && state.Next != std::ranges::end(m_Base))
+        {
+            auto&& input = *state.Next;
+            const std::string_view bytes(reinterpret_cast<const char*>(input.data()), input.size());
+            const size_t lane = state.Count++;
+
+            if (bytes.size() <= Width)
+            {
+                state.Buffer.Set(lane, bytes);
+                state.Buffers[lane] = state.Buffer[lane];
+            }
+            else
+            {
+                state.Overflow[lane].assign(bytes);
+                state.Buffers[lane] = reinterpret_cast<const uint8_t*>(state.Overflow[lane].data());
+            }
+            state.Lengths[lane] = bytes.size();
+            ++state.Next;
+        }
+
+        if (state.Count > 0)
+        {
+            SimdHashAdaptive(m_Algorithm, state.Count, state.Lengths.data(), state.Buffers.data(), state.Hashes.data());
+        }
+    }
+
+    value_type
+    Current(void) const
+    {
+        const State& state = *m_State;
+        const size_t lane = state.Index;
+        return value_type(
+            std::string_view(reinterpret_cast<const char*>(state.Buffers[lane]), state.Lengths[lane]),
+            std::span<const uint8_t>(&state.Hashes[lane * m_HashWidth], m_HashWidth)
+        );
+    }
+#pragma clang unsafe_buffer_usage end
+
+    void
+    Advance(void)
+    {
+        if (++m_State->Index == m_State->Count)
+        {
+            Fill();
+        }
+    }
+
+    bool Done(void) const { return m_State->Count == 0; }
+
+    V m_Base;
+    HashAlgorithm m_Algorithm;
+    size_t m_HashWidth;
+    std::unique_ptr<State> m_State;
+};
+
+template <typename R>
+hash_view(R&&, HashAlgorithm) -> hash_view<std::views::all_t<R>>;
+
+namespace views
+{
+
+template <size_t Width = DefaultViewWidth>
+struct hash_adaptor
+{
+    HashAlgorithm Algorithm;
+
+    template <std::ranges::viewable_range R>
+    friend auto
+    operator|(
+        R&& Range,
+        const hash_adaptor& Adaptor
+    )
+    {
+        return hash_view<std::views::all_t<R>, Width>(std::views::all(std::forward<R>(Range)), Adaptor.Algorithm);
+    }
+};
+
+template <size_t Width = DefaultViewWidth>
+inline hash_adaptor<Width>
+hash(
+    const HashAlgorithm Algorithm
+)
+{
+    return hash_adaptor<Width>{ Algorithm };
+}
+
+template <size_t Width = DefaultViewWidth, std::ranges::viewable_range R>
+inline auto
+hash(
+    R&& Range,
+    const HashAlgorithm Algorithm
+)
+{
+    return std::forward<R>(Range) | hash<Width>(Algorithm);
+}
+
+}
+
+}
+
+#endif /* SimdHashViews_hpp */
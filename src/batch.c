@@ -0,0 +1,159 @@
+//
+//  batch.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define BATCH_BUCKETS (256)
+
+static inline size_t
+BatchBucket(
+    const size_t Length,
+    const size_t OptimizedLength
+)
+/*++
+ Short inputs are bucketed by exact length so that a lane group takes
+ the uniform gather in SimdHashUpdateOptimized, longer inputs by the
+ number of blocks they need once padded
+--*/
+{
+    if (Length <= OptimizedLength)
+    {
+        return Length;
+    }
+
+    const size_t blocks = (Length + sizeof(uint64_t)) / MAX_BUFFER_SIZE + 1;
+    const size_t bucket = OptimizedLength + blocks;
+    return bucket < BATCH_BUCKETS ? bucket : BATCH_BUCKETS - 1;
+}
+
+static void
+HashLaneGroup(
+    const HashAlgorithm Algorithm,
+    const size_t Count,
+    const size_t Indices[],
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    uint8_t* HashBuffers
+)
+/*++
+ Gathers up to SimdLanes inputs by index, hashes them together and
+ scatters the digests back to their original positions
+--*/
+{
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    const size_t hashWidth = GetHashWidth(Algorithm);
+
+    for (size_t lane = 0; lane < Count; lane++)
+    {
+        lengths[lane] = Lengths[Indices[lane]];
+        buffers[lane] = Buffers[Indices[lane]];
+    }
+
+    SimdHashAdaptive(Algorithm, Count, lengths, buffers, hashes);
+
+    for (size_t lane = 0; lane < Count; lane++)
+    {
+        memcpy(&HashBuffers[Indices[lane] * hashWidth], &hashes[lane * hashWidth], hashWidth);
+    }
+}
+
+void
+SimdHashMany(
+    const HashAlgorithm Algorithm,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    uint8_t* HashBuffers
+)
+/*++
+ Hashes Count inputs in any order of lengths, writing the digests to
+ HashBuffers in input order. A counting sort on the length bucket forms
+ lane groups that need the same number of transforms. What is left of
+ each bucket is merged with the others afterwards so only the very last
+ group runs partially filled
+--*/
+{
+    size_t offsets[BATCH_BUCKETS + 1] = { 0 };
+    const size_t lanes = SimdLanes();
+    const size_t optimizedLength = SupportsOptimization(Algorithm) ?
+        GetOptimizedLength(Algorithm) : 0;
+    size_t* order;
+
+    if (Count == 0)
+    {
+        return;
+    }
+
+    order = malloc(Count * sizeof(size_t));
+    if (order == NULL)
+    {
+        // Hash in input order rather than fail
+        size_t indices[MAX_LANES];
+        for (size_t i = 0; i < Count; i += lanes)
+        {
+            const size_t group = Count - i < lanes ? Count - i : lanes;
+            for (size_t lane = 0; lane < group; lane++)
+            {
+                indices[lane] = i + lane;
+            }
+            HashLaneGroup(Algorithm, group, indices, Lengths, Buffers, HashBuffers);
+        }
+        return;
+    }
+
+    // Histogram, prefix sum and a stable scatter of the indices
+    for (size_t i = 0; i < Count; i++)
+    {
+        offsets[BatchBucket(Lengths[i], optimizedLength) + 1]++;
+    }
+    for (size_t b = 0; b < BATCH_BUCKETS; b++)
+    {
+        offsets[b + 1] += offsets[b];
+    }
+    for (size_t i = 0; i < Count; i++)
+    {
+        order[offsets[BatchBucket(Lengths[i], optimizedLength)]++] = i;
+    }
+
+    // Hash the full lane groups of each bucket, compacting the leftovers
+    // to the front of the order array. The leftovers are still sorted by
+    // bucket so grouping them keeps similar lengths together
+    size_t leftovers = 0;
+    size_t start = 0;
+    for (size_t b = 0; b < BATCH_BUCKETS; b++)
+    {
+        const size_t end = offsets[b];
+        size_t i = start;
+        for (; i + lanes <= end; i += lanes)
+        {
+            HashLaneGroup(Algorithm, lanes, &order[i], Lengths, Buffers, HashBuffers);
+        }
+        for (; i < end; i++)
+        {
+            order[leftovers++] = order[i];
+        }
+        start = end;
+    }
+
+    for (size_t i = 0; i < leftovers; i += lanes)
+    {
+        const size_t group = leftovers - i < lanes ? leftovers - i : lanes;
+        HashLaneGroup(Algorithm, group, &order[i], Lengths, Buffers, HashBuffers);
+    }
+
+    free(order);
+}
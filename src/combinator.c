@@ -0,0 +1,298 @@
+//
+//  combinator.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define LANE_COUNT (SIMD_WIDTH / 32)
+#define NO_PREFIX (UINT64_MAX)
+
+bool
+SimdHashCombinatorInit(
+    SimdHashCombinator* Combinator,
+    const HashAlgorithm Algorithm,
+    const size_t LeftCount,
+    const size_t LeftLengths[],
+    const uint8_t* const Left[],
+    const size_t RightCount,
+    const size_t RightLengths[],
+    const uint8_t* const Right[],
+    const char* Separator,
+    const size_t MinLength,
+    const size_t MaxLength
+)
+/*++
+ Prepares to generate every left word followed by Separator (which may
+ be NULL) and every right word, keeping those whose length lies within
+ [MinLength, MaxLength]. The word lists must outlive the combinator.
+ Candidate Index is left word Index / RightCount and right word
+ Index % RightCount. The whole keyspace is selected until
+ SimdHashCombinatorSeek narrows it
+--*/
+{
+    memset(Combinator, 0, sizeof(*Combinator));
+
+    if (Algorithm != HashAlgorithmMD4 &&
+        Algorithm != HashAlgorithmMD5 &&
+        Algorithm != HashAlgorithmSHA1 &&
+        Algorithm != HashAlgorithmSHA256)
+    {
+        return false;
+    }
+
+    if (__builtin_mul_overflow((uint64_t)LeftCount, (uint64_t)RightCount, &Combinator->Keyspace))
+    {
+        return false;
+    }
+
+    Combinator->Algorithm = Algorithm;
+    Combinator->LeftCount = LeftCount;
+    Combinator->LeftLengths = LeftLengths;
+    Combinator->Left = Left;
+    Combinator->RightCount = RightCount;
+    Combinator->RightLengths = RightLengths;
+    Combinator->Right = Right;
+    Combinator->Separator = (const uint8_t*)(Separator != NULL ? Separator : "");
+    Combinator->SeparatorLength = Separator != NULL ? strlen(Separator) : 0;
+    Combinator->MinLength = MinLength;
+    Combinator->MaxLength = MaxLength;
+    SimdHashCombinatorSeek(Combinator, 0, UINT64_MAX);
+
+    return true;
+}
+
+void
+SimdHashCombinatorSeek(
+    SimdHashCombinator* Combinator,
+    const uint64_t Start,
+    const uint64_t Count
+)
+/*++
+ Restricts generation to candidates [Start, Start + Count), clamped to
+ the keyspace, so that disjoint ranges can go to different threads
+--*/
+{
+    Combinator->Next = Start < Combinator->Keyspace ? Start : Combinator->Keyspace;
+    Combinator->End = Count < Combinator->Keyspace - Combinator->Next ?
+        Combinator->Next + Count : Combinator->Keyspace;
+    Combinator->Current = NO_PREFIX;
+}
+
+size_t
+SimdHashCombinatorCandidate(
+    const SimdHashCombinator* Combinator,
+    const uint64_t Index,
+    uint8_t* Buffer
+)
+/*++
+ Writes candidate Index, which must fit Buffer, and returns its length
+--*/
+{
+    const size_t left = (size_t)(Index / Combinator->RightCount);
+    const size_t right = (size_t)(Index % Combinator->RightCount);
+    const size_t leftLength = Combinator->LeftLengths[left];
+    const size_t rightLength = Combinator->RightLengths[right];
+
+    memcpy(Buffer, Combinator->Left[left], leftLength);
+    memcpy(&Buffer[leftLength], Combinator->Separator, Combinator->SeparatorLength);
+    memcpy(&Buffer[leftLength + Combinator->SeparatorLength], Combinator->Right[right], rightLength);
+
+    return leftLength + Combinator->SeparatorLength + rightLength;
+}
+
+static inline uint8_t
+PrefixByte(
+    const SimdHashCombinator* Combinator,
+    const size_t Left,
+    const size_t Position
+)
+{
+    const size_t leftLength = Combinator->LeftLengths[Left];
+
+    return Position < leftLength ?
+        Combinator->Left[Left][Position] :
+        Combinator->Separator[Position - leftLength];
+}
+
+static void
+LoadPrefix(
+    SimdHashCombinator* Combinator,
+    const size_t Left
+)
+/*++
+ Runs the full blocks of a left word and separator once into the
+ midstate, then writes the remaining prefix bytes to every lane so that
+ only right words are written per lane group
+--*/
+{
+    const size_t prefixLength = Combinator->LeftLengths[Left] + Combinator->SeparatorLength;
+    const size_t blocks = prefixLength / MAX_BUFFER_SIZE;
+    SimdHashContext* midstate = &Combinator->Midstate;
+
+    Combinator->Current = Left;
+    Combinator->PrefixBlocks = blocks;
+    Combinator->TailLength = prefixLength % MAX_BUFFER_SIZE;
+
+    SimdHashResetContext(midstate, Combinator->Algorithm);
+    for (size_t block = 0; block < blocks; block++)
+    {
+        for (size_t i = 0; i < MAX_BUFFER_SIZE; i++)
+        {
+            const uint8_t value = PrefixByte(Combinator, Left, block * MAX_BUFFER_SIZE + i);
+            for (size_t lane = 0; lane < LANE_COUNT; lane++)
+            {
+                midstate->Buffer[i / 4].epi32_u8[lane][i % 4] = value;
+            }
+        }
+        SimdHashTransform(midstate);
+    }
+
+    memset(Combinator->Words, 0, sizeof(Combinator->Words));
+    for (size_t i = 0; i < Combinator->TailLength; i++)
+    {
+        const uint8_t value = PrefixByte(Combinator, Left, blocks * MAX_BUFFER_SIZE + i);
+        for (size_t lane = 0; lane < LANE_COUNT; lane++)
+        {
+            Combinator->Words[i / 4].epi32_u8[lane][i % 4] = value;
+        }
+    }
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        Combinator->LaneLength[lane] = Combinator->TailLength;
+    }
+}
+
+static inline size_t
+WriteRight(
+    SimdHashCombinator* Combinator,
+    const size_t Lane,
+    const uint8_t* Word,
+    const size_t Length
+)
+/*++
+ Writes as much of a right word as fits after the prefix tail of one
+ lane, clears what is left of the lane's previous, possibly longer,
+ word and returns how many bytes were written
+--*/
+{
+    const size_t offset = Combinator->TailLength;
+    const size_t previous = Combinator->LaneLength[Lane];
+    const size_t written = Length < MAX_BUFFER_SIZE - offset ? Length : MAX_BUFFER_SIZE - offset;
+    SimdValue* words = Combinator->Words;
+
+    for (size_t i = 0; i < written; i++)
+    {
+        words[(offset + i) / 4].epi32_u8[Lane][(offset + i) % 4] = Word[i];
+    }
+    for (size_t position = offset + written; position < previous; position++)
+    {
+        words[position / 4].epi32_u8[Lane][position % 4] = 0;
+    }
+    Combinator->LaneLength[Lane] = offset + written;
+
+    return written;
+}
+
+size_t
+SimdHashCombinatorNext(
+    SimdHashCombinator* Combinator,
+    SimdHashContext* Context
+)
+/*++
+ Loads the next lane group of candidates into a freshly reset Context
+ and returns how many lanes hold candidates, 0 once the range is
+ exhausted. The candidate in each lane is recorded in Index. A group
+ never mixes left words. Right words that run past the prefix tail's
+ block are finished with SimdHashUpdate, so the Context is always ready
+ for SimdHashFinalize
+--*/
+{
+    size_t overflowLengths[MAX_LANES] = { 0 };
+    const uint8_t* overflowBuffers[MAX_LANES] = { NULL };
+    bool overflow = false;
+    size_t count = 0;
+
+    assert(Context->Lanes == LANE_COUNT);
+    assert(Context->Algorithm == Combinator->Algorithm);
+
+    while (count < LANE_COUNT && Combinator->Next < Combinator->End)
+    {
+        const size_t left = (size_t)(Combinator->Next / Combinator->RightCount);
+        const size_t right = (size_t)(Combinator->Next % Combinator->RightCount);
+        const size_t prefixLength = Combinator->LeftLengths[left] + Combinator->SeparatorLength;
+
+        if (left != Combinator->Current)
+        {
+            if (count > 0)
+            {
+                break;
+            }
+
+            // Nothing can follow a prefix that is already too long
+            if (prefixLength > Combinator->MaxLength)
+            {
+                Combinator->Next = (uint64_t)(left + 1) * Combinator->RightCount;
+                continue;
+            }
+            LoadPrefix(Combinator, left);
+        }
+
+        const size_t rightLength = Combinator->RightLengths[right];
+        const size_t length = prefixLength + rightLength;
+
+        if (length >= Combinator->MinLength &&
+            length <= Combinator->MaxLength)
+        {
+            const uint8_t* word = Combinator->Right[right];
+            const size_t written = WriteRight(Combinator, count, word, rightLength);
+
+            overflowLengths[count] = rightLength - written;
+            overflowBuffers[count] = &word[written];
+            overflow |= written != rightLength;
+            Combinator->Index[count++] = Combinator->Next;
+        }
+        Combinator->Next++;
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    for (size_t lane = count; lane < LANE_COUNT; lane++)
+    {
+        WriteRight(Combinator, lane, NULL, 0);
+    }
+
+    for (size_t i = 0; i < Context->HSize; i++)
+    {
+        store_simd(&Context->H[i].usimd, load_simd(&Combinator->Midstate.H[i].usimd));
+    }
+    for (size_t dw = 0; dw < MAX_BUFFER_SIZE_DWORDS; dw++)
+    {
+        store_simd(&Context->Buffer[dw].usimd, load_simd(&Combinator->Words[dw].usimd));
+    }
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        Context->Offset[lane] = Combinator->LaneLength[lane];
+        Context->BitLength[lane] = (Combinator->PrefixBlocks * MAX_BUFFER_SIZE + Combinator->LaneLength[lane]) * 8;
+    }
+
+    if (overflow)
+    {
+        SimdHashUpdate(Context, overflowLengths, overflowBuffers);
+    }
+
+    return count;
+}
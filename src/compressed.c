@@ -0,0 +1,531 @@
+//
+//  compressed.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#ifdef SIMDHASH_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SIMDHASH_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define MIN_BLOCK_COUNT (2)
+
+static const uint8_t GzipMagic[] = { 0x1f, 0x8b };
+static const uint8_t ZstdMagic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+typedef enum _InputFormat
+{
+    InputFormatPlain,
+    InputFormatGzip,
+    InputFormatZstd
+} InputFormat;
+
+struct _SimdHashCompressedReader
+{
+    // Decoder, only touched by the decompression thread once started
+    InputFormat Format;
+    FILE*     File;
+#ifdef SIMDHASH_HAVE_ZLIB
+    gzFile    Gzip;
+#endif
+#ifdef SIMDHASH_HAVE_ZSTD
+    ZSTD_DStream* Zstd;
+    uint8_t*  ZstdInput;
+    ZSTD_inBuffer ZstdIn;
+    size_t    ZstdPending;
+#endif
+    uint8_t*  Carry;
+    size_t    CarrySize;
+    // Dropping the rest of a line longer than a block
+    bool      Skipping;
+
+    size_t    MinLength;
+    size_t    MaxLength;
+    size_t    BlockSize;
+    size_t    BlockCount;
+    SimdHashInputBlock* Blocks;
+
+    // Shared state, guarded by Lock
+    pthread_mutex_t Lock;
+    pthread_cond_t  Changed;
+    size_t*   Free;
+    size_t    FreeCount;
+    size_t*   Ready;
+    size_t    ReadyHead;
+    size_t    ReadyCount;
+    bool      Done;
+    bool      Failed;
+    bool      Stopping;
+    pthread_t Thread;
+};
+
+static InputFormat
+DetectFormat(
+    FILE* File
+)
+{
+    uint8_t magic[sizeof(ZstdMagic)] = { 0 };
+    const size_t read = fread(magic, 1, sizeof(magic), File);
+
+    rewind(File);
+    if (read >= sizeof(ZstdMagic) && memcmp(magic, ZstdMagic, sizeof(ZstdMagic)) == 0)
+    {
+        return InputFormatZstd;
+    }
+    if (read >= sizeof(GzipMagic) && memcmp(magic, GzipMagic, sizeof(GzipMagic)) == 0)
+    {
+        return InputFormatGzip;
+    }
+    return InputFormatPlain;
+}
+
+static bool
+OpenDecoder(
+    SimdHashCompressedReader* Reader,
+    const char* Path
+)
+{
+    Reader->File = fopen(Path, "rb");
+    if (Reader->File == NULL)
+    {
+        return false;
+    }
+
+    Reader->Format = DetectFormat(Reader->File);
+    switch (Reader->Format)
+    {
+    case InputFormatPlain:
+        return true;
+    case InputFormatGzip:
+#ifdef SIMDHASH_HAVE_ZLIB
+        {
+            // zlib takes over the file, including concatenated members
+            const int fd = dup(fileno(Reader->File));
+            fclose(Reader->File);
+            Reader->File = NULL;
+            if (fd == -1)
+            {
+                return false;
+            }
+
+            Reader->Gzip = gzdopen(fd, "rb");
+            if (Reader->Gzip == NULL)
+            {
+                close(fd);
+                return false;
+            }
+            return true;
+        }
+#else
+        return false;
+#endif
+    case InputFormatZstd:
+#ifdef SIMDHASH_HAVE_ZSTD
+        Reader->Zstd = ZSTD_createDStream();
+        Reader->ZstdInput = malloc(ZSTD_DStreamInSize());
+        if (Reader->Zstd == NULL || Reader->ZstdInput == NULL)
+        {
+            return false;
+        }
+        ZSTD_initDStream(Reader->Zstd);
+        Reader->ZstdIn.src = Reader->ZstdInput;
+        Reader->ZstdIn.size = 0;
+        Reader->ZstdIn.pos = 0;
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+static void
+CloseDecoder(
+    SimdHashCompressedReader* Reader
+)
+{
+    if (Reader->File != NULL)
+    {
+        fclose(Reader->File);
+    }
+#ifdef SIMDHASH_HAVE_ZLIB
+    if (Reader->Gzip != NULL)
+    {
+        gzclose(Reader->Gzip);
+    }
+#endif
+#ifdef SIMDHASH_HAVE_ZSTD
+    ZSTD_freeDStream(Reader->Zstd);
+    free(Reader->ZstdInput);
+#endif
+}
+
+static ssize_t
+DecoderRead(
+    SimdHashCompressedReader* Reader,
+    uint8_t* Output,
+    const size_t Length
+)
+/*++
+ Returns the number of bytes decompressed, 0 at the end of the input or
+ -1 if the input is corrupt
+--*/
+{
+    switch (Reader->Format)
+    {
+    case InputFormatPlain:
+        {
+            const size_t read = fread(Output, 1, Length, Reader->File);
+            return read == 0 && ferror(Reader->File) ? -1 : (ssize_t)read;
+        }
+    case InputFormatGzip:
+#ifdef SIMDHASH_HAVE_ZLIB
+        {
+            const unsigned chunk = Length > INT32_MAX ? INT32_MAX : (unsigned)Length;
+            const int read = gzread(Reader->Gzip, Output, chunk);
+            return read < 0 ? -1 : read;
+        }
+#else
+        return -1;
+#endif
+    case InputFormatZstd:
+#ifdef SIMDHASH_HAVE_ZSTD
+        {
+            ZSTD_outBuffer out = { Output, Length, 0 };
+            while (out.pos == 0)
+            {
+                if (Reader->ZstdIn.pos == Reader->ZstdIn.size)
+                {
+                    Reader->ZstdIn.size = fread(Reader->ZstdInput, 1, ZSTD_DStreamInSize(), Reader->File);
+                    Reader->ZstdIn.pos = 0;
+                    if (Reader->ZstdIn.size == 0)
+                    {
+                        // A truncated frame still has a hint pending
+                        return Reader->ZstdPending == 0 && !ferror(Reader->File) ? 0 : -1;
+                    }
+                }
+                Reader->ZstdPending = ZSTD_decompressStream(Reader->Zstd, &out, &Reader->ZstdIn);
+                if (ZSTD_isError(Reader->ZstdPending))
+                {
+                    return -1;
+                }
+            }
+            return (ssize_t)out.pos;
+        }
+#else
+        return -1;
+#endif
+    }
+    return -1;
+}
+
+static SimdHashInputBlock*
+TakeFreeBlock(
+    SimdHashCompressedReader* Reader
+)
+{
+    SimdHashInputBlock* block = NULL;
+
+    pthread_mutex_lock(&Reader->Lock);
+    while (Reader->FreeCount == 0 && !Reader->Stopping)
+    {
+        pthread_cond_wait(&Reader->Changed, &Reader->Lock);
+    }
+    if (!Reader->Stopping)
+    {
+        block = &Reader->Blocks[Reader->Free[--Reader->FreeCount]];
+    }
+    pthread_mutex_unlock(&Reader->Lock);
+
+    return block;
+}
+
+static void
+PublishBlock(
+    SimdHashCompressedReader* Reader,
+    SimdHashInputBlock* Block
+)
+{
+    const size_t index = Block - Reader->Blocks;
+
+    pthread_mutex_lock(&Reader->Lock);
+    if (Block->Size == 0)
+    {
+        Reader->Free[Reader->FreeCount++] = index;
+    }
+    else
+    {
+        Reader->Ready[(Reader->ReadyHead + Reader->ReadyCount) % Reader->BlockCount] = index;
+        Reader->ReadyCount++;
+    }
+    pthread_cond_broadcast(&Reader->Changed);
+    pthread_mutex_unlock(&Reader->Lock);
+}
+
+static void*
+DecompressThread(
+    void* Context
+)
+/*++
+ Fills free blocks with whole lines. The partial line at the end of a
+ block is carried over to the front of the next one. A line longer than
+ a block can never be a candidate whole, so it is dropped up to and
+ including its newline rather than split into fragments
+--*/
+{
+    SimdHashCompressedReader* reader = (SimdHashCompressedReader*)Context;
+    bool end = false;
+    bool failed = false;
+
+    while (!end)
+    {
+        SimdHashInputBlock* block = TakeFreeBlock(reader);
+        if (block == NULL)
+        {
+            break;
+        }
+
+        memcpy(block->Data, reader->Carry, reader->CarrySize);
+        size_t size = reader->CarrySize;
+        reader->CarrySize = 0;
+
+        while (size < reader->BlockSize)
+        {
+            const ssize_t read = DecoderRead(reader, block->Data + size, reader->BlockSize - size);
+            if (read <= 0)
+            {
+                failed = read < 0;
+                end = true;
+                break;
+            }
+            if (reader->Skipping)
+            {
+                // Nothing is carried while skipping, so the read starts the block
+                const uint8_t* newline = memchr(block->Data, '\n', (size_t)read);
+                if (newline == NULL)
+                {
+                    continue;
+                }
+                const size_t rest = (size_t)read - (size_t)(newline + 1 - block->Data);
+                memmove(block->Data, newline + 1, rest);
+                reader->Skipping = false;
+                size = rest;
+                continue;
+            }
+            size += (size_t)read;
+        }
+
+        if (!end)
+        {
+            size_t last = size;
+            while (last > 0 && block->Data[last - 1] != '\n')
+            {
+                last--;
+            }
+            if (last > 0)
+            {
+                reader->CarrySize = size - last;
+                memcpy(reader->Carry, block->Data + last, reader->CarrySize);
+                size = last;
+            }
+            else
+            {
+                // A full block without a newline is the head of an overlong line
+                reader->Skipping = true;
+                size = 0;
+            }
+        }
+
+        block->Size = size;
+        SimdHashLineSplitterInit(&block->Splitter, block->Data, size, reader->MinLength, reader->MaxLength, true);
+        PublishBlock(reader, block);
+    }
+
+    pthread_mutex_lock(&reader->Lock);
+    reader->Done = true;
+    reader->Failed = failed;
+    pthread_cond_broadcast(&reader->Changed);
+    pthread_mutex_unlock(&reader->Lock);
+
+    return NULL;
+}
+
+static void
+FreeReader(
+    SimdHashCompressedReader* Reader
+)
+{
+    CloseDecoder(Reader);
+    if (Reader->Blocks != NULL)
+    {
+        for (size_t i = 0; i < Reader->BlockCount; i++)
+        {
+            free(Reader->Blocks[i].Data);
+        }
+    }
+    free(Reader->Blocks);
+    free(Reader->Free);
+    free(Reader->Ready);
+    free(Reader->Carry);
+    free(Reader);
+}
+
+SimdHashCompressedReader*
+SimdHashCompressedOpen(
+    const char* Path,
+    const size_t MinLength,
+    const size_t MaxLength,
+    const size_t BlockCount,
+    const size_t BlockSize
+)
+/*++
+ Opens a plain, gzip or zstd wordlist, detected from its magic bytes, and
+ starts decompressing it into BlockCount blocks of BlockSize bytes on a
+ background thread. gzip and zstd need zlib and libzstd at build time
+--*/
+{
+    SimdHashCompressedReader* reader = calloc(1, sizeof(SimdHashCompressedReader));
+
+    if (reader == NULL)
+    {
+        return NULL;
+    }
+
+    reader->MinLength = MinLength;
+    reader->MaxLength = MaxLength;
+    reader->BlockCount = BlockCount < MIN_BLOCK_COUNT ? MIN_BLOCK_COUNT : BlockCount;
+    reader->BlockSize = BlockSize;
+
+    if (BlockSize == 0 || !OpenDecoder(reader, Path))
+    {
+        FreeReader(reader);
+        return NULL;
+    }
+
+    reader->Blocks = calloc(reader->BlockCount, sizeof(SimdHashInputBlock));
+    reader->Free = malloc(reader->BlockCount * sizeof(size_t));
+    reader->Ready = malloc(reader->BlockCount * sizeof(size_t));
+    reader->Carry = malloc(BlockSize);
+    if (reader->Blocks == NULL || reader->Free == NULL || reader->Ready == NULL || reader->Carry == NULL)
+    {
+        FreeReader(reader);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < reader->BlockCount; i++)
+    {
+        reader->Blocks[i].Data = malloc(BlockSize);
+        if (reader->Blocks[i].Data == NULL)
+        {
+            FreeReader(reader);
+            return NULL;
+        }
+        reader->Free[i] = reader->BlockCount - 1 - i;
+    }
+    reader->FreeCount = reader->BlockCount;
+
+    pthread_mutex_init(&reader->Lock, NULL);
+    pthread_cond_init(&reader->Changed, NULL);
+    if (pthread_create(&reader->Thread, NULL, DecompressThread, reader) != 0)
+    {
+        pthread_cond_destroy(&reader->Changed);
+        pthread_mutex_destroy(&reader->Lock);
+        FreeReader(reader);
+        return NULL;
+    }
+
+    return reader;
+}
+
+SimdHashInputBlock*
+SimdHashCompressedAcquire(
+    SimdHashCompressedReader* Reader
+)
+/*++
+ Waits for the next block of lines, returning NULL once the input is
+ exhausted. Any number of threads may acquire blocks; each splits its
+ own block into lane groups with SimdHashLineSplitterNext and hands it
+ back with SimdHashCompressedRelease
+--*/
+{
+    SimdHashInputBlock* block = NULL;
+
+    pthread_mutex_lock(&Reader->Lock);
+    while (Reader->ReadyCount == 0 && !Reader->Done)
+    {
+        pthread_cond_wait(&Reader->Changed, &Reader->Lock);
+    }
+    if (Reader->ReadyCount > 0)
+    {
+        block = &Reader->Blocks[Reader->Ready[Reader->ReadyHead]];
+        Reader->ReadyHead = (Reader->ReadyHead + 1) % Reader->BlockCount;
+        Reader->ReadyCount--;
+    }
+    pthread_mutex_unlock(&Reader->Lock);
+
+    return block;
+}
+
+void
+SimdHashCompressedRelease(
+    SimdHashCompressedReader* Reader,
+    SimdHashInputBlock* Block
+)
+{
+    pthread_mutex_lock(&Reader->Lock);
+    Reader->Free[Reader->FreeCount++] = Block - Reader->Blocks;
+    pthread_cond_broadcast(&Reader->Changed);
+    pthread_mutex_unlock(&Reader->Lock);
+}
+
+bool
+SimdHashCompressedFailed(
+    SimdHashCompressedReader* Reader
+)
+/*++
+ True once the decompression thread has stopped on corrupt input
+--*/
+{
+    pthread_mutex_lock(&Reader->Lock);
+    const bool failed = Reader->Failed;
+    pthread_mutex_unlock(&Reader->Lock);
+    return failed;
+}
+
+void
+SimdHashCompressedClose(
+    SimdHashCompressedReader* Reader
+)
+/*++
+ Stops the decompression thread, which may not have reached the end of
+ the input. No block may still be held by a consumer
+--*/
+{
+    pthread_mutex_lock(&Reader->Lock);
+    Reader->Stopping = true;
+    pthread_cond_broadcast(&Reader->Changed);
+    pthread_mutex_unlock(&Reader->Lock);
+
+    pthread_join(Reader->Thread, NULL);
+    pthread_cond_destroy(&Reader->Changed);
+    pthread_mutex_destroy(&Reader->Lock);
+    FreeReader(Reader);
+}
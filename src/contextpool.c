@@ -0,0 +1,215 @@
+//
+//  contextpool.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define CACHE_LINE_SIZE (64)
+#define CONTEXT_POOL_SIZE (16)
+#define TEMPLATE_COUNT (HashAlgorithmMax + 1)
+
+typedef struct _PooledContext
+{
+    SimdHashContext Context __attribute__((__aligned__(CACHE_LINE_SIZE)));
+} PooledContext;
+
+typedef struct _ContextPool
+{
+    PooledContext Templates[TEMPLATE_COUNT];
+    PooledContext Contexts[CONTEXT_POOL_SIZE];
+    bool          HaveTemplate[TEMPLATE_COUNT];
+    size_t        Free[CONTEXT_POOL_SIZE];
+    size_t        FreeCount;
+} ContextPool;
+
+static _Thread_local ContextPool* ThreadPool;
+static pthread_key_t PoolKey;
+static pthread_once_t PoolKeyOnce = PTHREAD_ONCE_INIT;
+
+static void
+DestroyPool(
+    void* Pool
+)
+/*++
+ Runs on the exiting thread, so ThreadPool is that thread's own pointer
+--*/
+{
+    ThreadPool = NULL;
+    free(Pool);
+}
+
+static void
+CreatePoolKey(void)
+{
+    pthread_key_create(&PoolKey, DestroyPool);
+}
+
+static ContextPool*
+GetThreadPool(void)
+/*++
+ Each thread allocates its pool on first use. The key only exists so that
+ the pool is freed when the thread exits
+--*/
+{
+    ContextPool* pool = ThreadPool;
+
+    if (pool != NULL)
+    {
+        return pool;
+    }
+
+    if (posix_memalign((void**)&pool, CACHE_LINE_SIZE, sizeof(ContextPool)) != 0)
+    {
+        return NULL;
+    }
+
+    memset(pool->HaveTemplate, 0, sizeof(pool->HaveTemplate));
+    for (size_t i = 0; i < CONTEXT_POOL_SIZE; i++)
+    {
+        pool->Free[i] = CONTEXT_POOL_SIZE - 1 - i;
+    }
+    pool->FreeCount = CONTEXT_POOL_SIZE;
+
+    pthread_once(&PoolKeyOnce, CreatePoolKey);
+    pthread_setspecific(PoolKey, pool);
+    ThreadPool = pool;
+    return pool;
+}
+
+static const SimdHashContext*
+GetTemplate(
+    ContextPool* Pool,
+    const HashAlgorithm Algorithm
+)
+{
+    assert(Algorithm < TEMPLATE_COUNT);
+
+    SimdHashContext* context = &Pool->Templates[Algorithm].Context;
+    if (!Pool->HaveTemplate[Algorithm])
+    {
+        memset(context, 0, sizeof(*context));
+        SimdHashInit(context, Algorithm);
+        Pool->HaveTemplate[Algorithm] = true;
+    }
+    return context;
+}
+
+static inline void
+CopyTemplate(
+    SimdHashContext* Destination,
+    const SimdHashContext* Template
+)
+/*++
+ The SIMD algorithms only need the live H words and the fields behind the
+ union from the template. The buffer and lengths are always zero, so they
+ are cleared rather than copied
+--*/
+{
+    const size_t unionEnd = offsetof(SimdHashContext, HSize);
+
+    switch (Template->Algorithm)
+    {
+    case HashAlgorithmSHA384:
+    case HashAlgorithmSHA512:
+        memcpy(Destination, Template, sizeof(*Template));
+        break;
+    default:
+        memcpy(Destination->H, Template->H, Template->HSize * sizeof(Template->H[0]));
+        memset(Destination->Buffer, 0, sizeof(Destination->Buffer));
+        memset(Destination->Offset, 0, sizeof(Destination->Offset));
+        memset(Destination->BitLength, 0, sizeof(Destination->BitLength));
+        Destination->BufferSize = Template->BufferSize;
+        memcpy((uint8_t*)Destination + unionEnd,
+               (const uint8_t*)Template + unionEnd,
+               sizeof(*Template) - unionEnd);
+        break;
+    }
+}
+
+void
+SimdHashResetContext(
+    SimdHashContext* Context,
+    const HashAlgorithm Algorithm
+)
+/*++
+ Equivalent to SimdHashInit for pooled contexts, but copies the initial
+ state prepared once per thread instead of recomputing it. The one shot
+ hashing functions keep calling SimdHashInit so that they never allocate
+ a pool
+--*/
+{
+    ContextPool* pool = GetThreadPool();
+
+    if (pool == NULL)
+    {
+        SimdHashInit(Context, Algorithm);
+        return;
+    }
+
+    CopyTemplate(Context, GetTemplate(pool, Algorithm));
+}
+
+SimdHashContext*
+SimdHashAcquireContext(
+    const HashAlgorithm Algorithm
+)
+/*++
+ Returns a cache aligned context that is ready for updates. It must be
+ released on the same thread with SimdHashReleaseContext. When the pool
+ is exhausted a context is allocated instead
+--*/
+{
+    ContextPool* pool = GetThreadPool();
+    PooledContext* pooled;
+
+    if (pool != NULL && pool->FreeCount > 0)
+    {
+        pooled = &pool->Contexts[pool->Free[--pool->FreeCount]];
+    }
+    else if (posix_memalign((void**)&pooled, CACHE_LINE_SIZE, sizeof(PooledContext)) != 0)
+    {
+        return NULL;
+    }
+
+    SimdHashResetContext(&pooled->Context, Algorithm);
+    return &pooled->Context;
+}
+
+void
+SimdHashReleaseContext(
+    SimdHashContext* Context
+)
+{
+    ContextPool* pool = ThreadPool;
+    const uintptr_t address = (uintptr_t)Context;
+
+    if (Context == NULL)
+    {
+        return;
+    }
+
+    if (pool != NULL &&
+        address >= (uintptr_t)&pool->Contexts[0] &&
+        address < (uintptr_t)&pool->Contexts[CONTEXT_POOL_SIZE])
+    {
+        const size_t index = (address - (uintptr_t)&pool->Contexts[0]) / sizeof(PooledContext);
+        assert(pool->FreeCount < CONTEXT_POOL_SIZE);
+        pool->Free[pool->FreeCount++] = index;
+        return;
+    }
+
+    free(Context);
+}
@@ -0,0 +1,307 @@
+//
+//  encode.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+static const char HexLower[] = "0123456789abcdef";
+static const char HexUpper[] = "0123456789ABCDEF";
+static const char Base64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t
+SimdHashEncodeHex(
+    const uint8_t* Input,
+    const size_t Length,
+    char* Output,
+    const bool Uppercase
+)
+/*++
+ Writes 2 * Length hex characters to Output, without a terminator.
+ Each 16 byte block is split into nibbles that index a 16 entry
+ alphabet with a byte shuffle, then interleaved back into order
+--*/
+{
+    const char* alphabet = Uppercase ? HexUpper : HexLower;
+    size_t i = 0;
+
+#if defined(__SSSE3__)
+    const __m128i table = _mm_loadu_si128((const __m128i*)alphabet);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    for (; i + 16 <= Length; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(Input + i));
+        const __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        const __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i*)(Output + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(Output + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#elif defined(__SSE2__)
+    // No byte shuffle, map 0-9 and 10-15 arithmetically
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i letter = _mm_set1_epi8((Uppercase ? 'A' : 'a') - '0' - 10);
+    for (; i + 16 <= Length; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(Input + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        __m128i lo = _mm_and_si128(v, mask);
+        hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter));
+        _mm_storeu_si128((__m128i*)(Output + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(Output + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#elif defined(__arm64__) || defined(__aarch64__)
+    const uint8x16_t table = vld1q_u8((const uint8_t*)alphabet);
+    for (; i + 16 <= Length; i += 16)
+    {
+        const uint8x16_t v = vld1q_u8(Input + i);
+        uint8x16x2_t out;
+        out.val[0] = vqtbl1q_u8(table, vshrq_n_u8(v, 4));
+        out.val[1] = vqtbl1q_u8(table, vandq_u8(v, vdupq_n_u8(0x0f)));
+        vst2q_u8((uint8_t*)(Output + i * 2), out);
+    }
+#endif
+
+    for (; i < Length; i++)
+    {
+        Output[i * 2] = alphabet[Input[i] >> 4];
+        Output[i * 2 + 1] = alphabet[Input[i] & 0x0f];
+    }
+
+    return Length * 2;
+}
+
+static inline int
+HexValue(
+    const char Character
+)
+{
+    if (Character >= '0' && Character <= '9')
+    {
+        return Character - '0';
+    }
+    const char lower = Character | 0x20;
+    if (lower >= 'a' && lower <= 'f')
+    {
+        return lower - 'a' + 10;
+    }
+    return -1;
+}
+
+size_t
+SimdHashDecodeHex(
+    const char* Input,
+    const size_t Length,
+    uint8_t* Output
+)
+/*++
+ Parses Length hex characters (either case) into Length / 2 bytes.
+ Returns the number of bytes written, or (size_t)-1 if Length is odd
+ or any character is not a hex digit
+--*/
+{
+    size_t i = 0;
+
+    if (Length & 1)
+    {
+        return (size_t)-1;
+    }
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i five = _mm_set1_epi8(5);
+    const __m128i ten = _mm_set1_epi8(10);
+    const __m128i lowercase = _mm_set1_epi8(0x20);
+    const __m128i letter = _mm_set1_epi8('a');
+    const __m128i lowByte = _mm_set1_epi16(0x00ff);
+    for (; i + 32 <= Length; i += 32)
+    {
+        __m128i bytes[2];
+        for (size_t half = 0; half < 2; half++)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(Input + i + half * 16));
+            // Unsigned range checks: x <= n is min(x, n) == x
+            const __m128i digit = _mm_sub_epi8(v, zero);
+            const __m128i alpha = _mm_sub_epi8(_mm_or_si128(v, lowercase), letter);
+            const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit);
+            const __m128i isAlpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, five), alpha);
+            if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xffff)
+            {
+                return (size_t)-1;
+            }
+            const __m128i nibbles = _mm_or_si128(
+                _mm_and_si128(isDigit, digit),
+                _mm_and_si128(isAlpha, _mm_add_epi8(alpha, ten))
+            );
+            // Even characters are the high nibble of each byte
+            bytes[half] = _mm_or_si128(
+                _mm_slli_epi16(_mm_and_si128(nibbles, lowByte), 4),
+                _mm_srli_epi16(nibbles, 8)
+            );
+        }
+        _mm_storeu_si128((__m128i*)(Output + i / 2), _mm_packus_epi16(bytes[0], bytes[1]));
+    }
+#elif defined(__arm64__) || defined(__aarch64__)
+    for (; i + 32 <= Length; i += 32)
+    {
+        // De-interleave high and low nibble characters
+        const uint8x16x2_t v = vld2q_u8((const uint8_t*)(Input + i));
+        uint8x16_t nibbles[2];
+        for (size_t n = 0; n < 2; n++)
+        {
+            const uint8x16_t digit = vsubq_u8(v.val[n], vdupq_n_u8('0'));
+            const uint8x16_t isDigit = vcltq_u8(digit, vdupq_n_u8(10));
+            const uint8x16_t alpha = vsubq_u8(vorrq_u8(v.val[n], vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+            const uint8x16_t isAlpha = vcltq_u8(alpha, vdupq_n_u8(6));
+            if (vminvq_u8(vorrq_u8(isDigit, isAlpha)) == 0)
+            {
+                return (size_t)-1;
+            }
+            nibbles[n] = vbslq_u8(isDigit, digit, vaddq_u8(alpha, vdupq_n_u8(10)));
+        }
+        vst1q_u8(Output + i / 2, vorrq_u8(vshlq_n_u8(nibbles[0], 4), nibbles[1]));
+    }
+#endif
+
+    for (; i < Length; i += 2)
+    {
+        const int hi = HexValue(Input[i]);
+        const int lo = HexValue(Input[i + 1]);
+        if (hi < 0 || lo < 0)
+        {
+            return (size_t)-1;
+        }
+        Output[i / 2] = (uint8_t)((hi << 4) | lo);
+    }
+
+    return Length / 2;
+}
+
+size_t
+SimdHashEncodeBase64(
+    const uint8_t* Input,
+    const size_t Length,
+    char* Output
+)
+/*++
+ Writes the padded base64 encoding of Input, without a terminator, and
+ returns its length. Whole 12 byte groups are spread into 16 six bit
+ indices with a shuffle and two multiplies, then mapped to the alphabet
+ with a shuffle of per range offsets
+--*/
+{
+    size_t i = 0;
+    char* out = Output;
+
+#if defined(__SSSE3__)
+    // The 16 byte load only consumes 12, so keep 4 bytes of slack
+    for (; i + 16 <= Length; i += 12)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(Input + i));
+        v = _mm_shuffle_epi8(v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t0, t1);
+
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        const __m128i offsets = _mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+        );
+        _mm_storeu_si128((__m128i*)out, _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range)));
+        out += 16;
+    }
+#endif
+
+    for (; i + 3 <= Length; i += 3)
+    {
+        const uint32_t triple = (Input[i] << 16) | (Input[i + 1] << 8) | Input[i + 2];
+        *out++ = Base64Alphabet[(triple >> 18) & 0x3f];
+        *out++ = Base64Alphabet[(triple >> 12) & 0x3f];
+        *out++ = Base64Alphabet[(triple >> 6) & 0x3f];
+        *out++ = Base64Alphabet[triple & 0x3f];
+    }
+
+    if (i < Length)
+    {
+        const uint32_t triple = (Input[i] << 16) | (i + 1 < Length ? Input[i + 1] << 8 : 0);
+        *out++ = Base64Alphabet[(triple >> 18) & 0x3f];
+        *out++ = Base64Alphabet[(triple >> 12) & 0x3f];
+        *out++ = i + 1 < Length ? Base64Alphabet[(triple >> 6) & 0x3f] : '=';
+        *out++ = '=';
+    }
+
+    return out - Output;
+}
+
+void
+SimdHashEncodeHashesHex(
+    const uint8_t* HashBuffers,
+    const size_t HashSize,
+    const size_t Count,
+    char* Output,
+    const bool Uppercase
+)
+{
+    const size_t stride = SimdHashHexStride(HashSize);
+    for (size_t i = 0; i < Count; i++)
+    {
+        char* out = Output + i * stride;
+        out[SimdHashEncodeHex(HashBuffers + i * HashSize, HashSize, out, Uppercase)] = '\0';
+    }
+}
+
+void
+SimdHashEncodeHashesBase64(
+    const uint8_t* HashBuffers,
+    const size_t HashSize,
+    const size_t Count,
+    char* Output
+)
+{
+    const size_t stride = SimdHashBase64Stride(HashSize);
+    for (size_t i = 0; i < Count; i++)
+    {
+        char* out = Output + i * stride;
+        out[SimdHashEncodeBase64(HashBuffers + i * HashSize, HashSize, out)] = '\0';
+    }
+}
+
+void
+SimdHashGetHashesHex(
+    SimdHashContext* Context,
+    char* Output,
+    const bool Uppercase
+)
+{
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    SimdHashGetHashes(Context, hashes);
+    SimdHashEncodeHashesHex(hashes, Context->HashSize, Context->Lanes, Output, Uppercase);
+}
+
+void
+SimdHashGetHashesBase64(
+    SimdHashContext* Context,
+    char* Output
+)
+{
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    SimdHashGetHashes(Context, hashes);
+    SimdHashEncodeHashesBase64(hashes, Context->HashSize, Context->Lanes, Output);
+}
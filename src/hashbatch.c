@@ -0,0 +1,301 @@
+//
+//  hashbatch.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+static void*
+AllocateArena(
+    const size_t Size,
+    const bool HugePages,
+    bool* Mapped
+)
+/*++
+ Huge pages are tried explicitly first, then as a transparent huge page
+ hint on an ordinary mapping. Without huge pages the arena only needs to
+ be aligned for vector loads
+--*/
+{
+    void* arena = NULL;
+
+    *Mapped = false;
+    if (HugePages)
+    {
+#ifdef MAP_HUGETLB
+        arena = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (arena != MAP_FAILED)
+        {
+            *Mapped = true;
+            return arena;
+        }
+#endif
+        arena = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (arena == MAP_FAILED)
+        {
+            return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(arena, Size, MADV_HUGEPAGE);
+#endif
+        *Mapped = true;
+        return arena;
+    }
+
+    if (posix_memalign(&arena, VALUE_ALIGN, Size) != 0)
+    {
+        return NULL;
+    }
+    return arena;
+}
+
+SimdValue*
+SimdHashBatchGroupWords(
+    const SimdHashBatch* Batch,
+    const size_t Group
+)
+/*++
+ The words of one lane group, ready to be loaded into Context->Buffer
+--*/
+{
+    return &Batch->Words[Group * Batch->WidthDwords];
+}
+
+bool
+SimdHashBatchInit(
+    SimdHashBatch* Batch,
+    const size_t Width,
+    const size_t Capacity,
+    const bool HugePages
+)
+/*++
+ Reserves room for Capacity candidates of up to Width bytes, rounded up
+ to whole lane groups. Width is limited to what fits in a single block
+--*/
+{
+    memset(Batch, 0, sizeof(*Batch));
+
+    if (Width == 0 || Width > MAX_OPTIMIZED_BUFFER_SIZE || Capacity == 0)
+    {
+        return false;
+    }
+
+    Batch->Lanes = SimdLanes();
+    Batch->Width = Width;
+    Batch->WidthDwords = (Width + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    Batch->Groups = (Capacity + Batch->Lanes - 1) / Batch->Lanes;
+    Batch->Capacity = Batch->Groups * Batch->Lanes;
+
+    // Words first so that every SimdValue is aligned, lengths after
+    const size_t wordsSize = Batch->Groups * Batch->WidthDwords * sizeof(SimdValue);
+    const size_t lengthsSize = Batch->Capacity * sizeof(uint64_t);
+    Batch->ArenaSize = wordsSize + lengthsSize;
+    if (HugePages)
+    {
+        Batch->ArenaSize = (Batch->ArenaSize + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+    }
+
+    Batch->Arena = AllocateArena(Batch->ArenaSize, HugePages, &Batch->Mapped);
+    if (Batch->Arena == NULL)
+    {
+        memset(Batch, 0, sizeof(*Batch));
+        return false;
+    }
+
+    Batch->Words = (SimdValue*)Batch->Arena;
+    Batch->Lengths = (uint64_t*)((uint8_t*)Batch->Arena + wordsSize);
+    Batch->Count = 0;
+
+    return true;
+}
+
+void
+SimdHashBatchDestroy(
+    SimdHashBatch* Batch
+)
+{
+    if (Batch->Mapped)
+    {
+        munmap(Batch->Arena, Batch->ArenaSize);
+    }
+    else
+    {
+        free(Batch->Arena);
+    }
+    memset(Batch, 0, sizeof(*Batch));
+}
+
+void
+SimdHashBatchClear(
+    SimdHashBatch* Batch
+)
+/*++
+ Stale candidates are left in place, every slot is rewritten in full
+ when it is next used
+--*/
+{
+    Batch->Count = 0;
+}
+
+void
+SimdHashBatchSet(
+    SimdHashBatch* Batch,
+    const size_t Index,
+    const size_t Length,
+    const uint8_t* Buffer
+)
+/*++
+ Writes a candidate into its lane of the interleaved words, zeroing the
+ rest of the slot so the finalize padding lands on clean bytes
+--*/
+{
+    assert(Index < Batch->Capacity);
+    assert(Length <= Batch->Width);
+
+    const size_t lane = Index % Batch->Lanes;
+    SimdValue* words = SimdHashBatchGroupWords(Batch, Index / Batch->Lanes);
+    const size_t fullDwords = Length / sizeof(uint32_t);
+    const size_t tailBytes = Length % sizeof(uint32_t);
+    size_t dw = 0;
+
+    for (; dw < fullDwords; dw++)
+    {
+        uint32_t value;
+        memcpy(&value, Buffer + dw * sizeof(uint32_t), sizeof(value));
+        words[dw].epi32_u32[lane] = value;
+    }
+
+    if (tailBytes)
+    {
+        uint32_t value = 0;
+        memcpy(&value, Buffer + dw * sizeof(uint32_t), tailBytes);
+        words[dw++].epi32_u32[lane] = value;
+    }
+
+    for (; dw < Batch->WidthDwords; dw++)
+    {
+        words[dw].epi32_u32[lane] = 0;
+    }
+
+    Batch->Lengths[Index] = Length;
+}
+
+bool
+SimdHashBatchAdd(
+    SimdHashBatch* Batch,
+    const size_t Length,
+    const uint8_t* Buffer
+)
+/*++
+ Appends a candidate, returning false when the batch is full or the
+ candidate is wider than the batch
+--*/
+{
+    if (Batch->Count == Batch->Capacity || Length > Batch->Width)
+    {
+        return false;
+    }
+
+    SimdHashBatchSet(Batch, Batch->Count, Length, Buffer);
+    Batch->Count++;
+    return true;
+}
+
+void
+SimdHashUpdateBatch(
+    SimdHashContext* Context,
+    const SimdHashBatch* Batch,
+    const size_t Group
+)
+/*++
+ The batch already holds the candidates in the layout of Context->Buffer,
+ so the message words are moved with aligned vector loads and stores and
+ no per lane gather. Lanes past the end of the batch hold no candidate
+ and produce undefined digests
+--*/
+{
+    assert(Context->Lanes == Batch->Lanes);
+    assert(Batch->Width <= GetOptimizedLength(Context->Algorithm));
+    assert(Context->Algorithm != HashAlgorithmNTLM);
+    assert(Group < Batch->Groups);
+
+    const SimdValue* words = SimdHashBatchGroupWords(Batch, Group);
+    const uint64_t* lengths = &Batch->Lengths[Group * Batch->Lanes];
+    const size_t first = Group * Batch->Lanes;
+
+    for (size_t dw = 0; dw < Batch->WidthDwords; dw++)
+    {
+        store_simd(&Context->Buffer[dw].usimd, load_simd(&words[dw].usimd));
+    }
+
+    for (size_t lane = 0; lane < Batch->Lanes; lane++)
+    {
+        const uint64_t length = first + lane < Batch->Count ? lengths[lane] : 0;
+        Context->Offset[lane] += length;
+        Context->BitLength[lane] += length * 8;
+    }
+}
+
+void
+SimdHashBatchHash(
+    const HashAlgorithm Algorithm,
+    const SimdHashBatch* Batch,
+    uint8_t* HashBuffers
+)
+/*++
+ Hashes every candidate in the batch, writing Count digests contiguously
+ in candidate order. Only the single block algorithms are supported
+--*/
+{
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    const size_t hashWidth = GetHashWidth(Algorithm);
+    const size_t groups = SimdHashBatchGroupCount(Batch);
+
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmMD5:
+    case HashAlgorithmSHA1:
+    case HashAlgorithmSHA256:
+        break;
+    default:
+        assert(false);
+        return;
+    }
+
+    for (size_t group = 0; group < groups; group++)
+    {
+        SimdHashContext ctx;
+        const size_t first = group * Batch->Lanes;
+        const size_t count = Batch->Count - first < Batch->Lanes ? Batch->Count - first : Batch->Lanes;
+        uint8_t* output = &HashBuffers[first * hashWidth];
+
+        SimdHashInit(&ctx, Algorithm);
+        SimdHashUpdateBatch(&ctx, Batch, group);
+        SimdHashFinalize(&ctx);
+
+        // The digests of a partial group go through a scratch buffer
+        if (count == Batch->Lanes)
+        {
+            SimdHashGetHashes(&ctx, output);
+        }
+        else
+        {
+            SimdHashGetHashes(&ctx, hashes);
+            memcpy(output, hashes, count * hashWidth);
+        }
+    }
+}
@@ -6,6 +6,9 @@
 //  Copyright © 2021 Gareth Evans. All rights reserved.
 //
 
+#include <string.h>
+#include <assert.h>
+
 #include "simdhash.h"
 #include "hashcommon.h"
 #include "library.h"
@@ -65,4 +68,120 @@ SimdHashUpdateLaneBuffer(
     
     // Return number of bytes unwritten
     return Length - (next - Buffer);
-}
\ No newline at end of file
+}
+
+static inline uint32_t
+ReadPaddedDword(
+    const uint8_t* Buffer,
+    const size_t Length,
+    const size_t Offset
+)
+/*++
+ Reads the dword at Offset of the padded message, for an Offset that
+ contains the end of the message or the 0x80 padding byte
+--*/
+{
+    uint32_t value = 0;
+    const size_t remaining = Length - Offset;
+    memcpy(&value, Buffer + Offset, remaining);
+    return value | ((uint32_t)0x80 << (remaining * 8));
+}
+
+void
+SimdHashLoadPaddedBlock(
+    SimdHashContext* Context,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const size_t Block,
+    const bool Uniform
+)
+/*++
+ Writes one complete block of the padded message for every lane. The
+ message bytes, the 0x80 terminator and the length are written directly,
+ Offset and BitLength are not used
+--*/
+{
+    const size_t lanes = Context->Lanes;
+    const size_t blockStart = Block * Context->BufferSize;
+    const size_t blockDwords = Context->BufferSize / sizeof(uint32_t);
+    const bool bigEndian = Context->Algorithm == HashAlgorithmSHA1 ||
+        Context->Algorithm == HashAlgorithmSHA256;
+
+    if (Uniform)
+    {
+        // Every lane shares the same layout so each dword is either
+        // gathered, padded, zero or the length across all lanes at once
+        const size_t length = Lengths[0];
+        const size_t lastData = blockDwords - (sizeof(uint64_t) / sizeof(uint32_t));
+        const bool finalBlock = length < blockStart + Context->BufferSize - sizeof(uint64_t);
+
+        for (size_t dw = 0; dw < blockDwords; dw++)
+        {
+            const size_t offset = blockStart + dw * 4;
+            SimdValue v __attribute__((__aligned__(VALUE_ALIGN)));
+
+            if (offset + 4 <= length)
+            {
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    memcpy(&v.epi32_u32[lane], Buffers[lane] + offset, sizeof(uint32_t));
+                }
+                store_simd(&Context->Buffer[dw].usimd, v.usimd);
+            }
+            else if (offset <= length)
+            {
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    v.epi32_u32[lane] = ReadPaddedDword(Buffers[lane], length, offset);
+                }
+                store_simd(&Context->Buffer[dw].usimd, v.usimd);
+            }
+            else if (finalBlock && dw >= lastData)
+            {
+                const uint64_t bitLength = bigEndian ?
+                    __builtin_bswap64((uint64_t)length * 8) : (uint64_t)length * 8;
+                const uint32_t value = dw == lastData ?
+                    (uint32_t)bitLength : (uint32_t)(bitLength >> 32);
+                store_simd(&Context->Buffer[dw].usimd, set1_epi32(value));
+            }
+            else
+            {
+                store_simd(&Context->Buffer[dw].usimd, set1_epi32(0));
+            }
+        }
+    }
+    else
+    {
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            const size_t length = Lengths[lane];
+            const uint8_t* buf = Buffers[lane];
+
+            for (size_t dw = 0; dw < blockDwords; dw++)
+            {
+                const size_t offset = blockStart + dw * 4;
+                uint32_t value = 0;
+
+                if (offset + 4 <= length)
+                {
+                    memcpy(&value, buf + offset, sizeof(uint32_t));
+                }
+                else if (offset <= length)
+                {
+                    value = ReadPaddedDword(buf, length, offset);
+                }
+                Context->Buffer[dw].epi32_u32[lane] = value;
+            }
+
+            if (length < blockStart + Context->BufferSize - sizeof(uint64_t))
+            {
+                SimdHashWriteBuffer64(
+                    Context,
+                    Context->BufferSize - sizeof(uint64_t),
+                    lane,
+                    bigEndian ? __builtin_bswap64((uint64_t)length * 8) : (uint64_t)length * 8
+                );
+            }
+        }
+    }
+}
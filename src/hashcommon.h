@@ -57,6 +57,14 @@ SimdHashUpdateLaneBuffer(
     const size_t Length,
     const uint8_t* Buffers);
 
+void
+SimdHashLoadPaddedBlock(
+    SimdHashContext* Context,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const size_t Block,
+    const bool Uniform);
+
 static inline simd_t
 SimdBitwiseChoiceWithControlOriginal(
     const simd_t Choice1,
@@ -0,0 +1,381 @@
+//
+//  markov.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define LANE_COUNT (SIMD_WIDTH / 32)
+
+static const char DefaultCharset[] =
+    " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+
+struct _SimdHashMarkovStats
+{
+    // Position 0 is keyed by a NUL predecessor
+    uint32_t  Counts[MARKOV_MAX_LENGTH][256][256];
+};
+
+SimdHashMarkovStats*
+SimdHashMarkovCreate(
+    void
+)
+{
+    return calloc(1, sizeof(SimdHashMarkovStats));
+}
+
+void
+SimdHashMarkovDestroy(
+    SimdHashMarkovStats* Stats
+)
+{
+    free(Stats);
+}
+
+void
+SimdHashMarkovTrain(
+    SimdHashMarkovStats* Stats,
+    const uint8_t* Word,
+    const size_t Length
+)
+/*++
+ Counts the bigrams of Word at each position. Bytes past
+ MARKOV_MAX_LENGTH are ignored and counts saturate
+--*/
+{
+    uint8_t previous = 0;
+
+    for (size_t i = 0; i < Length && i < MARKOV_MAX_LENGTH; i++)
+    {
+        uint32_t* count = &Stats->Counts[i][previous][Word[i]];
+        *count += *count != UINT32_MAX;
+        previous = Word[i];
+    }
+}
+
+bool
+SimdHashMarkovTrainFile(
+    SimdHashMarkovStats* Stats,
+    const char* Path
+)
+{
+    SimdHashWordlist wordlist;
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+    size_t found;
+
+    if (!SimdHashWordlistOpen(&wordlist, Path, 1, SIZE_MAX))
+    {
+        return false;
+    }
+
+    while ((found = SimdHashWordlistNext(&wordlist, MAX_LANES, lengths, buffers)) > 0)
+    {
+        for (size_t i = 0; i < found; i++)
+        {
+            SimdHashMarkovTrain(Stats, buffers[i], lengths[i]);
+        }
+    }
+
+    SimdHashWordlistClose(&wordlist);
+    return true;
+}
+
+typedef struct _RankEntry
+{
+    uint32_t  Count;
+    uint16_t  Order;
+    uint8_t   Value;
+} RankEntry;
+
+static int
+CompareRank(
+    const void* Left,
+    const void* Right
+)
+/*++
+ Most frequent first, ties broken by the order of the charset
+--*/
+{
+    const RankEntry* left = Left;
+    const RankEntry* right = Right;
+
+    if (left->Count != right->Count)
+    {
+        return left->Count > right->Count ? -1 : 1;
+    }
+    return (int)left->Order - (int)right->Order;
+}
+
+bool
+SimdHashMarkovChainInit(
+    SimdHashMarkovChain* Chain,
+    const SimdHashMarkovStats* Stats,
+    const size_t Length,
+    const size_t Threshold,
+    const char* Charset
+)
+/*++
+ Builds, for every position and predecessor, the Threshold most likely
+ next bytes from Charset (printable ASCII when NULL). Candidate indices
+ are mixed radix numbers of ranks with the rightmost position fastest,
+ so index 0 is the most likely word and low indices come first. Fails if
+ the keyspace does not fit in 64 bits
+--*/
+{
+    RankEntry entries[256];
+    const uint8_t* charset = (const uint8_t*)(Charset != NULL ? Charset : DefaultCharset);
+    bool seen[256] = { false };
+    uint8_t bytes[256];
+    size_t size = 0;
+
+    memset(Chain, 0, sizeof(*Chain));
+
+    for (const uint8_t* next = charset; *next; next++)
+    {
+        if (!seen[*next])
+        {
+            seen[*next] = true;
+            bytes[size++] = *next;
+        }
+    }
+
+    if (Length == 0 || Length > MARKOV_MAX_LENGTH || Threshold == 0 || size == 0)
+    {
+        return false;
+    }
+
+    Chain->Length = Length;
+    Chain->Threshold = Threshold < size ? Threshold : size;
+    Chain->Keyspace = 1;
+    for (size_t position = 0; position < Length; position++)
+    {
+        if (__builtin_mul_overflow(Chain->Keyspace, Chain->Threshold, &Chain->Keyspace))
+        {
+            return false;
+        }
+    }
+
+    Chain->Table = malloc(Length * 256 * Chain->Threshold);
+    if (Chain->Table == NULL)
+    {
+        return false;
+    }
+
+    for (size_t position = 0; position < Length; position++)
+    {
+        for (size_t previous = 0; previous < 256; previous++)
+        {
+            // Only the start marker and charset bytes can precede a byte
+            if (position == 0 ? previous != 0 : !seen[previous])
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < size; i++)
+            {
+                entries[i].Count = Stats->Counts[position][previous][bytes[i]];
+                entries[i].Order = (uint16_t)i;
+                entries[i].Value = bytes[i];
+            }
+            qsort(entries, size, sizeof(RankEntry), CompareRank);
+
+            uint8_t* row = &Chain->Table[(position * 256 + previous) * Chain->Threshold];
+            for (size_t rank = 0; rank < Chain->Threshold; rank++)
+            {
+                row[rank] = entries[rank].Value;
+            }
+        }
+    }
+
+    return true;
+}
+
+void
+SimdHashMarkovChainDestroy(
+    SimdHashMarkovChain* Chain
+)
+{
+    free(Chain->Table);
+    memset(Chain, 0, sizeof(*Chain));
+}
+
+static inline uint8_t
+Lookup(
+    const SimdHashMarkovChain* Chain,
+    const size_t Position,
+    const uint8_t Previous,
+    const uint32_t Rank
+)
+{
+    return Chain->Table[(Position * 256 + Previous) * Chain->Threshold + Rank];
+}
+
+size_t
+SimdHashMarkovCandidate(
+    const SimdHashMarkovChain* Chain,
+    const uint64_t Index,
+    uint8_t* Buffer
+)
+/*++
+ Writes candidate Index of the chain's keyspace and returns its length
+--*/
+{
+    uint32_t ranks[MARKOV_MAX_LENGTH];
+    uint64_t remainder = Index;
+    uint8_t previous = 0;
+
+    for (size_t position = Chain->Length; position-- > 0;)
+    {
+        ranks[position] = (uint32_t)(remainder % Chain->Threshold);
+        remainder /= Chain->Threshold;
+    }
+
+    for (size_t position = 0; position < Chain->Length; position++)
+    {
+        Buffer[position] = Lookup(Chain, position, previous, ranks[position]);
+        previous = Buffer[position];
+    }
+
+    return Chain->Length;
+}
+
+static inline void
+WritePositions(
+    SimdHashMarkovGenerator* Generator,
+    const size_t Lane,
+    const size_t First
+)
+/*++
+ Every byte depends on its predecessor, so a change at First rewrites
+ the rest of the word
+--*/
+{
+    const SimdHashMarkovChain* chain = Generator->Chain;
+    uint8_t* candidate = Generator->Candidates[Lane];
+    uint8_t previous = First > 0 ? candidate[First - 1] : 0;
+
+    for (size_t position = First; position < chain->Length; position++)
+    {
+        candidate[position] = Lookup(chain, position, previous, Generator->Ranks[Lane][position]);
+        previous = candidate[position];
+    }
+}
+
+void
+SimdHashMarkovGeneratorInit(
+    SimdHashMarkovGenerator* Generator,
+    const SimdHashMarkovChain* Chain,
+    const uint64_t Start,
+    const uint64_t Count
+)
+/*++
+ Prepares to generate candidates [Start, Start + Count) of the chain's
+ keyspace, clamped to its end, so that disjoint ranges can be handed to
+ different threads or processes with the same statistics
+--*/
+{
+    memset(Generator, 0, sizeof(*Generator));
+    Generator->Chain = Chain;
+    Generator->Next = Start < Chain->Keyspace ? Start : Chain->Keyspace;
+    Generator->End = Count < Chain->Keyspace - Generator->Next ? Generator->Next + Count : Chain->Keyspace;
+
+    // The lane count in base Threshold is what every step adds
+    uint64_t step = LANE_COUNT;
+    for (size_t position = Chain->Length; position-- > 0;)
+    {
+        Generator->Step[position] = (uint32_t)(step % Chain->Threshold);
+        step /= Chain->Threshold;
+    }
+
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        uint64_t remainder = (Generator->Next + lane) % Chain->Keyspace;
+        for (size_t position = Chain->Length; position-- > 0;)
+        {
+            Generator->Ranks[lane][position] = (uint32_t)(remainder % Chain->Threshold);
+            remainder /= Chain->Threshold;
+        }
+        WritePositions(Generator, lane, 0);
+    }
+}
+
+static inline void
+Advance(
+    SimdHashMarkovGenerator* Generator
+)
+{
+    const SimdHashMarkovChain* chain = Generator->Chain;
+
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        uint32_t* ranks = Generator->Ranks[lane];
+        uint32_t carry = 0;
+        size_t first = chain->Length;
+
+        for (size_t position = chain->Length; position-- > 0;)
+        {
+            const uint32_t step = Generator->Step[position];
+            if (step == 0 && carry == 0)
+            {
+                continue;
+            }
+
+            const uint32_t value = ranks[position] + step + carry;
+            carry = value >= chain->Threshold;
+            ranks[position] = value - (carry ? (uint32_t)chain->Threshold : 0);
+            first = position;
+        }
+
+        WritePositions(Generator, lane, first);
+    }
+}
+
+size_t
+SimdHashMarkovGeneratorNext(
+    SimdHashMarkovGenerator* Generator,
+    size_t Lengths[],
+    const uint8_t* Buffers[]
+)
+/*++
+ Fills one lane group of candidates for SimdHashOptimized and returns
+ how many lanes hold candidates of the range, 0 once it is exhausted.
+ Unused lanes are padded with empty words. The buffers stay valid until
+ the next call
+--*/
+{
+    const size_t length = Generator->Chain->Length;
+
+    if (Generator->Next >= Generator->End)
+    {
+        return 0;
+    }
+
+    // Stepping is deferred so the previous group's buffers stay intact
+    if (Generator->Started)
+    {
+        Advance(Generator);
+    }
+    Generator->Started = true;
+
+    const uint64_t remaining = Generator->End - Generator->Next;
+    const size_t count = remaining < LANE_COUNT ? (size_t)remaining : LANE_COUNT;
+
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        Lengths[lane] = lane < count ? length : 0;
+        Buffers[lane] = Generator->Candidates[lane];
+    }
+
+    Generator->Next += count;
+    return count;
+}
@@ -0,0 +1,366 @@
+//
+//  mask.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define LANE_COUNT (SIMD_WIDTH / 32)
+
+static const char CharsetLower[] = "abcdefghijklmnopqrstuvwxyz";
+static const char CharsetUpper[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+static const char CharsetDigits[] = "0123456789";
+static const char CharsetHexLower[] = "0123456789abcdef";
+static const char CharsetHexUpper[] = "0123456789ABCDEF";
+static const char CharsetSpecial[] = " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+
+typedef struct _CharsetBuilder
+{
+    uint8_t  Bytes[256];
+    uint16_t Size;
+    bool     Seen[256];
+} CharsetBuilder;
+
+static void
+AddBytes(
+    CharsetBuilder* Builder,
+    const char* Bytes
+)
+{
+    for (const uint8_t* next = (const uint8_t*)Bytes; *next; next++)
+    {
+        if (!Builder->Seen[*next])
+        {
+            Builder->Seen[*next] = true;
+            Builder->Bytes[Builder->Size++] = *next;
+        }
+    }
+}
+
+static bool
+AddBuiltin(
+    CharsetBuilder* Builder,
+    const char Name
+)
+/*++
+ The hashcat built in charsets, ?b being every byte value
+--*/
+{
+    switch (Name)
+    {
+    case 'l':
+        AddBytes(Builder, CharsetLower);
+        return true;
+    case 'u':
+        AddBytes(Builder, CharsetUpper);
+        return true;
+    case 'd':
+        AddBytes(Builder, CharsetDigits);
+        return true;
+    case 'h':
+        AddBytes(Builder, CharsetHexLower);
+        return true;
+    case 'H':
+        AddBytes(Builder, CharsetHexUpper);
+        return true;
+    case 's':
+        AddBytes(Builder, CharsetSpecial);
+        return true;
+    case 'a':
+        AddBytes(Builder, CharsetLower);
+        AddBytes(Builder, CharsetUpper);
+        AddBytes(Builder, CharsetDigits);
+        AddBytes(Builder, CharsetSpecial);
+        return true;
+    case 'b':
+        for (size_t value = 0; value < 256; value++)
+        {
+            if (!Builder->Seen[value])
+            {
+                Builder->Seen[value] = true;
+                Builder->Bytes[Builder->Size++] = (uint8_t)value;
+            }
+        }
+        return true;
+    case '?':
+        AddBytes(Builder, "?");
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool
+ParseCustomCharset(
+    CharsetBuilder* Builder,
+    const char* Definition
+)
+/*++
+ A custom charset is a list of bytes which may include built in charsets
+--*/
+{
+    for (const char* next = Definition; *next; next++)
+    {
+        if (*next == '?')
+        {
+            if (!AddBuiltin(Builder, *++next))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            const char single[2] = { *next, 0 };
+            AddBytes(Builder, single);
+        }
+    }
+    return Builder->Size > 0;
+}
+
+bool
+SimdHashMaskParse(
+    SimdHashMask* Mask,
+    const char* Pattern,
+    const char* const Custom[MASK_CUSTOM_CHARSETS]
+)
+/*++
+ Parses a hashcat style mask such as ?u?l?l?l?d?d. Custom may be NULL
+ or hold up to four definitions for ?1 to ?4. Fails on an unknown
+ charset, an empty mask, a mask longer than a single block allows or a
+ keyspace that does not fit in 64 bits
+--*/
+{
+    memset(Mask, 0, sizeof(*Mask));
+    Mask->Keyspace = 1;
+
+    for (const char* next = Pattern; *next; next++)
+    {
+        CharsetBuilder builder;
+        memset(&builder, 0, sizeof(builder));
+
+        if (Mask->Length == MASK_MAX_LENGTH)
+        {
+            return false;
+        }
+
+        if (*next != '?')
+        {
+            const char single[2] = { *next, 0 };
+            AddBytes(&builder, single);
+        }
+        else
+        {
+            const char name = *++next;
+            if (name >= '1' && name < '1' + MASK_CUSTOM_CHARSETS)
+            {
+                const char* definition = Custom != NULL ? Custom[name - '1'] : NULL;
+                if (definition == NULL || !ParseCustomCharset(&builder, definition))
+                {
+                    return false;
+                }
+            }
+            else if (!AddBuiltin(&builder, name))
+            {
+                return false;
+            }
+        }
+
+        if (__builtin_mul_overflow(Mask->Keyspace, builder.Size, &Mask->Keyspace))
+        {
+            return false;
+        }
+        memcpy(Mask->Charset[Mask->Length], builder.Bytes, builder.Size);
+        Mask->CharsetSize[Mask->Length] = builder.Size;
+        Mask->Length++;
+    }
+
+    return Mask->Length > 0;
+}
+
+size_t
+SimdHashMaskCandidate(
+    const SimdHashMask* Mask,
+    const uint64_t Index,
+    uint8_t* Buffer
+)
+/*++
+ Writes candidate Index of the keyspace, where the rightmost position
+ changes fastest, and returns its length
+--*/
+{
+    uint64_t remainder = Index;
+
+    for (size_t position = Mask->Length; position-- > 0;)
+    {
+        const uint16_t size = Mask->CharsetSize[position];
+        Buffer[position] = Mask->Charset[position][remainder % size];
+        remainder /= size;
+    }
+
+    return Mask->Length;
+}
+
+static inline void
+WritePositions(
+    SimdHashMaskGenerator* Generator,
+    const size_t First
+)
+/*++
+ Looks up the bytes of every position from First onwards and stores them
+ straight into the lane interleaved message words
+--*/
+{
+    const SimdHashMask* mask = Generator->Mask;
+
+    for (size_t position = First; position < mask->Length; position++)
+    {
+        SimdValue* word = &Generator->Words[position / 4];
+        const uint8_t* charset = mask->Charset[position];
+        for (size_t lane = 0; lane < LANE_COUNT; lane++)
+        {
+            word->epi32_u8[lane][position % 4] = charset[Generator->Index[position].epi32_u32[lane]];
+        }
+    }
+}
+
+void
+SimdHashMaskGeneratorInit(
+    SimdHashMaskGenerator* Generator,
+    const SimdHashMask* Mask,
+    const uint64_t Start,
+    const uint64_t Count
+)
+/*++
+ Prepares to generate candidates [Start, Start + Count) of the keyspace,
+ clamped to its end, so that disjoint ranges can be handed to different
+ threads or machines
+--*/
+{
+    memset(Generator, 0, sizeof(*Generator));
+    Generator->Mask = Mask;
+    Generator->Next = Start < Mask->Keyspace ? Start : Mask->Keyspace;
+    Generator->End = Count < Mask->Keyspace - Generator->Next ? Generator->Next + Count : Mask->Keyspace;
+
+    // The lane count as a mixed radix number is what every step adds
+    uint64_t step = LANE_COUNT;
+    for (size_t position = Mask->Length; position-- > 0;)
+    {
+        Generator->Step[position] = (uint32_t)(step % Mask->CharsetSize[position]);
+        step /= Mask->CharsetSize[position];
+    }
+
+    // Lane l starts at candidate Start + l, wrapping at the keyspace end
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        uint64_t remainder = (Generator->Next + lane) % Mask->Keyspace;
+        for (size_t position = Mask->Length; position-- > 0;)
+        {
+            Generator->Index[position].epi32_u32[lane] = (uint32_t)(remainder % Mask->CharsetSize[position]);
+            remainder /= Mask->CharsetSize[position];
+        }
+    }
+
+    WritePositions(Generator, 0);
+}
+
+static inline void
+Advance(
+    SimdHashMaskGenerator* Generator
+)
+/*++
+ Adds the lane count to every lane's position indices, from the right,
+ carrying into the next position when an index passes its charset size.
+ The lane loops have a fixed trip count so they compile to vector adds,
+ compares and blends. A position with no step and no carry is skipped,
+ but positions left of it may still have a step when a charset size
+ divides the lane count. Positions left of the last change are untouched
+ and their bytes are not rewritten
+--*/
+{
+    const SimdHashMask* mask = Generator->Mask;
+    uint32_t carry[LANE_COUNT] = { 0 };
+    size_t first = mask->Length;
+
+    for (size_t position = mask->Length; position-- > 0;)
+    {
+        const uint32_t step = Generator->Step[position];
+        const uint32_t size = mask->CharsetSize[position];
+        uint32_t* index = Generator->Index[position].epi32_u32;
+        uint32_t any = step;
+
+        for (size_t lane = 0; lane < LANE_COUNT; lane++)
+        {
+            any |= carry[lane];
+        }
+        if (any == 0)
+        {
+            continue;
+        }
+
+        for (size_t lane = 0; lane < LANE_COUNT; lane++)
+        {
+            const uint32_t value = index[lane] + step + carry[lane];
+            const uint32_t over = value >= size;
+            index[lane] = value - (over ? size : 0);
+            carry[lane] = over;
+        }
+        first = position;
+    }
+
+    WritePositions(Generator, first);
+}
+
+size_t
+SimdHashMaskGeneratorNext(
+    SimdHashMaskGenerator* Generator,
+    SimdHashContext* Context
+)
+/*++
+ Loads the next lane group of candidates into a freshly reset Context
+ and returns how many lanes hold candidates of the range, 0 once it is
+ exhausted. The context is ready for SimdHashFinalize
+--*/
+{
+    const size_t length = Generator->Mask->Length;
+    const size_t dwords = (length + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    assert(Context->Lanes == LANE_COUNT);
+    assert(Context->Algorithm != HashAlgorithmNTLM);
+    assert(length <= GetOptimizedLength(Context->Algorithm));
+
+    if (Generator->Next >= Generator->End)
+    {
+        return 0;
+    }
+
+    for (size_t dw = 0; dw < dwords; dw++)
+    {
+        store_simd(&Context->Buffer[dw].usimd, load_simd(&Generator->Words[dw].usimd));
+    }
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        Context->Offset[lane] = length;
+        Context->BitLength[lane] = length * 8;
+    }
+
+    const uint64_t remaining = Generator->End - Generator->Next;
+    const size_t count = remaining < LANE_COUNT ? (size_t)remaining : LANE_COUNT;
+
+    Generator->Next += count;
+    if (Generator->Next < Generator->End)
+    {
+        Advance(Generator);
+    }
+
+    return count;
+}
@@ -95,8 +95,10 @@ HH(
 }
 
 void
-SimdMd4Transform(
-    SimdHashContext *Context)
+SimdMd4TransformBlock(
+    SimdHashContext *Context,
+    const SimdValue Block[]
+)
 {
     simd_t aO, bO, cO, dO;
     simd_t a = aO = load_simd(&Context->H[0].usimd);
@@ -108,7 +110,7 @@ SimdMd4Transform(
     // Inirialize x with the buffer contents
     for (size_t i = 0; i < 16; i++)
     {
-        x[i] = load_simd(&Context->Buffer[i].usimd);
+        x[i] = load_simd(&Block[i].usimd);
     }
 
     //
@@ -226,6 +228,13 @@ SimdMd4Transform(
     store_simd(&Context->H[1].usimd, add_epi32(bO, b));
     store_simd(&Context->H[2].usimd, add_epi32(cO, c));
     store_simd(&Context->H[3].usimd, add_epi32(dO, d));
+}
+
+void
+SimdMd4Transform(
+    SimdHashContext *Context)
+{
+    SimdMd4TransformBlock(Context, Context->Buffer);
 
     //
     // Reset the offset and buffer
@@ -66,8 +66,10 @@ SimdMd5Init(
 }
 
 void
-SimdMd5Transform(
-    SimdHashContext* Context)
+SimdMd5TransformBlock(
+    SimdHashContext* Context,
+    const SimdValue Block[]
+)
 {
     simd_t f;
     
@@ -85,7 +87,7 @@ SimdMd5Transform(
     for (size_t i = 0; i < 16; i++)
     {
         f = SimdBitwiseChoiceWithControl(c, d, b);
-        simd_t m = load_simd(&Context->Buffer[i].usimd);
+        simd_t m = load_simd(&Block[i].usimd);
         simd_t k = set1_epi32(Md5RoundConstants[i]);
         f = add_epi32(f, add_epi32(a, add_epi32(k, m)));
         a = d;
@@ -99,7 +101,7 @@ SimdMd5Transform(
     {
         f = SimdBitwiseChoiceWithControl(b, c, d);
         uint32_t g = (5 * i + 1) & 15;
-        simd_t m = load_simd(&Context->Buffer[g].usimd);
+        simd_t m = load_simd(&Block[g].usimd);
         simd_t k = set1_epi32(Md5RoundConstants[i]);
         f = add_epi32(f, add_epi32(a, add_epi32(k, m)));
         a = d;
@@ -113,7 +115,7 @@ SimdMd5Transform(
     {
         f = xor_simd(b, xor_simd(c, d));
         uint32_t g = (3 * i + 5) & 15;
-        simd_t m = load_simd(&Context->Buffer[g].usimd);
+        simd_t m = load_simd(&Block[g].usimd);
         simd_t k = set1_epi32(Md5RoundConstants[i]);
         f = add_epi32(f, add_epi32(a, add_epi32(k, m)));
         a = d;
@@ -127,7 +129,7 @@ SimdMd5Transform(
     {
         f = xor_simd(c, or_simd(b, not_simd(d)));
         uint32_t g = (7 * i) & 15;
-        simd_t m = load_simd(&Context->Buffer[g].usimd);
+        simd_t m = load_simd(&Block[g].usimd);
         simd_t k = set1_epi32(Md5RoundConstants[i]);
         f = add_epi32(f, add_epi32(a, add_epi32(k, m)));
         a = d;
@@ -143,6 +145,13 @@ SimdMd5Transform(
     store_simd(&Context->H[1].usimd, add_epi32(bO, b));
     store_simd(&Context->H[2].usimd, add_epi32(cO, c));
     store_simd(&Context->H[3].usimd, add_epi32(dO, d));
+}
+
+void
+SimdMd5Transform(
+    SimdHashContext* Context)
+{
+    SimdMd5TransformBlock(Context, Context->Buffer);
 
     //
     // Reset the offset and buffer
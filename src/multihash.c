@@ -0,0 +1,215 @@
+//
+//  multihash.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+#include "hashcommon.h"
+#include "library.h"
+
+const bool
+SupportsMultiHash(
+    const HashAlgorithm Algorithm
+)
+{
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmMD5:
+    case HashAlgorithmSHA1:
+    case HashAlgorithmSHA256:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static inline bool
+IsBigEndian(
+    const HashAlgorithm Algorithm
+)
+{
+    return Algorithm == HashAlgorithmSHA1 || Algorithm == HashAlgorithmSHA256;
+}
+
+static inline size_t
+BlockCount(
+    const size_t Length
+)
+{
+    // Message, the 0x80 byte and the 64-bit length rounded up to whole blocks
+    return (Length + sizeof(uint64_t)) / MAX_BUFFER_SIZE + 1;
+}
+
+static void
+SimdMultiHashTransform(
+    SimdHashContext* Context,
+    const SimdValue Block[],
+    const size_t Lengths[],
+    const size_t BlockIndex,
+    const size_t ActiveLanes
+)
+/*++
+ Transforms the shared Block, keeping the state of lanes whose
+ message ended in an earlier block
+--*/
+{
+    SimdValue saved[MAX_H_COUNT] __attribute__((__aligned__(VALUE_ALIGN)));
+
+    if (ActiveLanes == Context->Lanes)
+    {
+        SimdHashTransformBlock(Context, Block);
+        return;
+    }
+
+    for (size_t i = 0; i < Context->HSize; i++)
+    {
+        store_simd(&saved[i].usimd, load_simd(&Context->H[i].usimd));
+    }
+
+    SimdHashTransformBlock(Context, Block);
+
+    for (size_t lane = 0; lane < Context->Lanes; lane++)
+    {
+        if (BlockCount(Lengths[lane]) <= BlockIndex)
+        {
+            for (size_t i = 0; i < Context->HSize; i++)
+            {
+                Context->H[i].epi32_u32[lane] = saved[i].epi32_u32[lane];
+            }
+        }
+    }
+}
+
+void
+SimdHashMulti(
+    const size_t AlgorithmCount,
+    const HashAlgorithm Algorithms[],
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    uint8_t* const HashBuffers[]
+)
+/*++
+ Hashes the same inputs with several algorithms. Each block is padded
+ and transposed into lane layout once and every algorithm transforms it
+ in place, back to back, while it is still in cache.
+ Algorithms that cannot share blocks are hashed separately with SimdHash
+--*/
+{
+    SimdHashContext contexts[SimdHashAlgorithmCount] __attribute__((__aligned__(VALUE_ALIGN)));
+    uint8_t* outputs[SimdHashAlgorithmCount];
+    size_t fused = 0;
+    size_t maxBlocks = 0;
+    bool uniform = true;
+
+    assert(AlgorithmCount <= SimdHashAlgorithmCount);
+
+    for (size_t i = 0; i < AlgorithmCount; i++)
+    {
+        if (SupportsMultiHash(Algorithms[i]))
+        {
+            SimdHashInit(&contexts[fused], Algorithms[i]);
+            outputs[fused] = HashBuffers[i];
+            fused++;
+        }
+        else
+        {
+            SimdHash(Algorithms[i], Lengths, Buffers, HashBuffers[i]);
+        }
+    }
+
+    if (fused == 0)
+    {
+        return;
+    }
+
+    const size_t lanes = contexts[0].Lanes;
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        const size_t blocks = BlockCount(Lengths[lane]);
+        maxBlocks = blocks > maxBlocks ? blocks : maxBlocks;
+        if (Lengths[lane] != Lengths[0])
+        {
+            uniform = false;
+        }
+    }
+
+    for (size_t block = 0; block < maxBlocks; block++)
+    {
+        size_t activeLanes = 0;
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            if (BlockCount(Lengths[lane]) > block)
+            {
+                activeLanes++;
+            }
+        }
+
+        // Transpose the block once into the first context's buffer, which
+        // every context then reads in place
+        SimdHashLoadPaddedBlock(&contexts[0], Lengths, Buffers, block, uniform);
+        const SimdValue* shared = contexts[0].Buffer;
+        const bool bigEndian = IsBigEndian(contexts[0].Algorithm);
+
+        for (size_t i = 0; i < fused; i++)
+        {
+            if (IsBigEndian(contexts[i].Algorithm) == bigEndian)
+            {
+                SimdMultiHashTransform(&contexts[i], shared, Lengths, block, activeLanes);
+            }
+        }
+
+        // Only the length words differ for the other byte order, so swap
+        // them in place for the lanes that end here and run the rest
+        bool swapped = false;
+        for (size_t i = 0; i < fused; i++)
+        {
+            if (IsBigEndian(contexts[i].Algorithm) == bigEndian)
+            {
+                continue;
+            }
+
+            if (!swapped)
+            {
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    if (BlockCount(Lengths[lane]) == block + 1)
+                    {
+                        const uint64_t bitLength = (uint64_t)Lengths[lane] * 8;
+                        SimdHashWriteBuffer64(
+                            &contexts[0],
+                            contexts[0].BufferSize - sizeof(uint64_t),
+                            lane,
+                            bigEndian ? bitLength : __builtin_bswap64(bitLength)
+                        );
+                    }
+                }
+                swapped = true;
+            }
+            SimdMultiHashTransform(&contexts[i], shared, Lengths, block, activeLanes);
+        }
+    }
+
+    for (size_t i = 0; i < fused; i++)
+    {
+        SimdHashContext* ctx = &contexts[i];
+        if (IsBigEndian(ctx->Algorithm))
+        {
+            for (size_t h = 0; h < ctx->HSize; h++)
+            {
+                store_simd(&ctx->H[h].usimd, bswap_epi32(load_simd(&ctx->H[h].usimd)));
+            }
+        }
+        SimdHashGetHashes(ctx, outputs[i]);
+    }
+}
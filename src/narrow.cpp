@@ -0,0 +1,118 @@
+//
+//  narrow.cpp
+//  SimdHash
+//
+//  Created by Kryc on 19/10/2026.
+//  Copyright © 2026 Kryc. All rights reserved.
+//
+
+// Narrower vector engines for partially filled batches. The C kernels
+// are built for the single width of simd_t, so a batch of three inputs
+// on an AVX-512 build still pays for a 16 lane transform. This
+// translation unit instantiates Engine for the narrower instruction sets
+// the library is compiled with and exposes them to the C dispatch.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "simdhash.h"
+#include "SimdHashEngine.hpp"
+
+namespace
+{
+
+#pragma clang unsafe_buffer_usage begin
+
+template <typename Isa, HashAlgorithm Algorithm>
+void
+HashNarrow(
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    uint8_t* HashBuffers
+)
+/*++
+ Hashes Count inputs with the Isa::Lanes wide engine. The unused lanes
+ hash an empty message and their digests are dropped
+--*/
+{
+    using Narrow = simdhash::Engine<Isa, Algorithm>;
+    size_t lengths[Narrow::Lanes];
+    const uint8_t* buffers[Narrow::Lanes];
+    uint8_t hashes[Narrow::Lanes * Narrow::DigestSize];
+
+    for (size_t lane = 0; lane < Narrow::Lanes; lane++)
+    {
+        lengths[lane] = lane < Count ? Lengths[lane] : 0;
+        buffers[lane] = lane < Count ? Buffers[lane] : Buffers[0];
+    }
+
+    Narrow::Hash(lengths, buffers, hashes);
+    memcpy(HashBuffers, hashes, Count * Narrow::DigestSize);
+}
+
+template <typename Isa>
+bool
+HashNarrow(
+    const HashAlgorithm Algorithm,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    uint8_t* HashBuffers
+)
+{
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+        HashNarrow<Isa, HashAlgorithmMD4>(Count, Lengths, Buffers, HashBuffers);
+        return true;
+    case HashAlgorithmMD5:
+        HashNarrow<Isa, HashAlgorithmMD5>(Count, Lengths, Buffers, HashBuffers);
+        return true;
+    case HashAlgorithmSHA1:
+        HashNarrow<Isa, HashAlgorithmSHA1>(Count, Lengths, Buffers, HashBuffers);
+        return true;
+    case HashAlgorithmSHA256:
+        HashNarrow<Isa, HashAlgorithmSHA256>(Count, Lengths, Buffers, HashBuffers);
+        return true;
+    default:
+        return false;
+    }
+}
+
+#pragma clang unsafe_buffer_usage end
+
+}
+
+bool
+SimdHashNarrow(
+    const HashAlgorithm Algorithm,
+    const size_t Lanes,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const uint8_t* HashBuffers
+)
+{
+    uint8_t* hashes = const_cast<uint8_t*>(HashBuffers);
+
+    if (Count == 0 || Count > Lanes || Lanes >= SimdLanes())
+    {
+        return false;
+    }
+
+    switch (Lanes)
+    {
+#if defined(__SSE2__)
+    case simdhash::isa::Sse2::Lanes:
+        return HashNarrow<simdhash::isa::Sse2>(Algorithm, Count, Lengths, Buffers, hashes);
+#endif
+#if defined(__AVX2__)
+    case simdhash::isa::Avx2::Lanes:
+        return HashNarrow<simdhash::isa::Avx2>(Algorithm, Count, Lengths, Buffers, hashes);
+#endif
+    default:
+        return false;
+    }
+}
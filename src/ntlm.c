@@ -0,0 +1,635 @@
+//
+//  ntlm.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+#include <openssl/md4.h>
+#include <unicode/ustring.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+#include "hashcommon.h"
+#include "library.h"
+
+//
+// Inputs up to this many bytes are converted into a per-lane
+// stack buffer, anything longer is converted on the heap
+//
+#define NTLM_STACK_INPUT_SIZE (128)
+#define NTLM_STACK_BUFFER_SIZE (NTLM_STACK_INPUT_SIZE * sizeof(uint16_t))
+
+static inline size_t
+Utf16WriteChar(
+    uint8_t* Output,
+    const size_t Offset,
+    const uint16_t Value
+)
+{
+    Output[Offset] = Value & 0xff;
+    Output[Offset + 1] = Value >> 8;
+    return Offset + sizeof(uint16_t);
+}
+
+static inline bool
+Utf8IsContinuation(
+    const uint8_t Value
+)
+{
+    return (Value & 0xc0) == 0x80;
+}
+
+#if defined(__SSE2__) || defined(__arm64__) || defined(__aarch64__)
+#define UTF8_SIMD_WINDOW (16)
+
+#if defined(__arm64__) || defined(__aarch64__)
+static inline uint32_t
+Utf8Movemask(
+    const uint8x16_t Value
+)
+/*++
+ Packs the top bit of each byte of a comparison result into a mask
+ --*/
+{
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t bits = vandq_u8(Value, vld1q_u8(weights));
+    return vaddv_u8(vget_low_u8(bits)) | ((uint32_t)vaddv_u8(vget_high_u8(bits)) << 8);
+}
+#endif
+
+static size_t
+Utf8DecodeWindow(
+    const uint8_t* Buffer,
+    const size_t Valid,
+    uint8_t* Output,
+    size_t* Written
+)
+/*++
+ Decodes the complete one, two and three byte sequences at the start
+ of a window of up to 16 bytes. Lead and continuation bytes are
+ classified and checked for overlong encodings and surrogates with
+ vector compares, and every position is decoded into a UTF-16 unit as
+ if it started a sequence. The units at sequence starts are then
+ packed into Output. Returns the number of bytes consumed, or 0 if the
+ window starts with a four byte or malformed sequence, which the
+ scalar decoder then handles.
+ --*/
+{
+    uint8_t window[UTF8_SIMD_WINDOW] __attribute__((__aligned__(16))) = { 0 };
+    uint16_t units[UTF8_SIMD_WINDOW] __attribute__((__aligned__(16)));
+    uint32_t cont, lead2, lead3, lead4, bad;
+
+    memcpy(window, Buffer, Valid);
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v = _mm_load_si128((const __m128i*)window);
+    const __m128i next1 = _mm_srli_si128(v, 1);
+    const __m128i next2 = _mm_srli_si128(v, 2);
+    const __m128i nextTop = _mm_and_si128(next1, _mm_set1_epi8((char)0xe0));
+
+    cont = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xc0)), _mm_set1_epi8((char)0x80)));
+    lead2 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xe0)), _mm_set1_epi8((char)0xc0)));
+    lead3 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xf0)), _mm_set1_epi8((char)0xe0)));
+    lead4 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xf0)), _mm_set1_epi8((char)0xf0)));
+    // C0 and C1 are overlong, E0 80-9F is overlong and ED A0-BF is a surrogate
+    bad = _mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8((char)0xfe)), _mm_set1_epi8((char)0xc0)),
+        _mm_or_si128(
+            _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xe0)), _mm_cmpeq_epi8(nextTop, _mm_set1_epi8((char)0x80))),
+            _mm_and_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xed)), _mm_cmpeq_epi8(nextTop, _mm_set1_epi8((char)0xa0))))));
+
+    for (size_t half = 0; half < 2; half++)
+    {
+        const __m128i b0 = half ? _mm_unpackhi_epi8(v, zero) : _mm_unpacklo_epi8(v, zero);
+        const __m128i b1 = half ? _mm_unpackhi_epi8(next1, zero) : _mm_unpacklo_epi8(next1, zero);
+        const __m128i b2 = half ? _mm_unpackhi_epi8(next2, zero) : _mm_unpacklo_epi8(next2, zero);
+        const __m128i low6 = _mm_set1_epi16(0x3f);
+        const __m128i two = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1f)), 6), _mm_and_si128(b1, low6));
+        const __m128i three = _mm_or_si128(
+            _mm_or_si128(_mm_slli_epi16(b0, 12), _mm_slli_epi16(_mm_and_si128(b1, low6), 6)),
+            _mm_and_si128(b2, low6));
+        const __m128i isTwo = _mm_cmpeq_epi16(_mm_and_si128(b0, _mm_set1_epi16(0xe0)), _mm_set1_epi16(0xc0));
+        const __m128i isThree = _mm_cmpeq_epi16(_mm_and_si128(b0, _mm_set1_epi16(0xf0)), _mm_set1_epi16(0xe0));
+        __m128i unit = _mm_or_si128(_mm_and_si128(isTwo, two), _mm_andnot_si128(isTwo, b0));
+        unit = _mm_or_si128(_mm_and_si128(isThree, three), _mm_andnot_si128(isThree, unit));
+        _mm_store_si128((__m128i*)&units[half * 8], unit);
+    }
+#else
+    const uint8x16_t v = vld1q_u8(window);
+    const uint8x16_t next1 = vextq_u8(v, vdupq_n_u8(0), 1);
+    const uint8x16_t next2 = vextq_u8(v, vdupq_n_u8(0), 2);
+    const uint8x16_t nextTop = vandq_u8(next1, vdupq_n_u8(0xe0));
+
+    cont = Utf8Movemask(vceqq_u8(vandq_u8(v, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80)));
+    lead2 = Utf8Movemask(vceqq_u8(vandq_u8(v, vdupq_n_u8(0xe0)), vdupq_n_u8(0xc0)));
+    lead3 = Utf8Movemask(vceqq_u8(vandq_u8(v, vdupq_n_u8(0xf0)), vdupq_n_u8(0xe0)));
+    lead4 = Utf8Movemask(vceqq_u8(vandq_u8(v, vdupq_n_u8(0xf0)), vdupq_n_u8(0xf0)));
+    // C0 and C1 are overlong, E0 80-9F is overlong and ED A0-BF is a surrogate
+    bad = Utf8Movemask(vorrq_u8(
+        vceqq_u8(vandq_u8(v, vdupq_n_u8(0xfe)), vdupq_n_u8(0xc0)),
+        vorrq_u8(
+            vandq_u8(vceqq_u8(v, vdupq_n_u8(0xe0)), vceqq_u8(nextTop, vdupq_n_u8(0x80))),
+            vandq_u8(vceqq_u8(v, vdupq_n_u8(0xed)), vceqq_u8(nextTop, vdupq_n_u8(0xa0))))));
+
+    for (size_t half = 0; half < 2; half++)
+    {
+        const uint16x8_t b0 = vmovl_u8(half ? vget_high_u8(v) : vget_low_u8(v));
+        const uint16x8_t b1 = vmovl_u8(half ? vget_high_u8(next1) : vget_low_u8(next1));
+        const uint16x8_t b2 = vmovl_u8(half ? vget_high_u8(next2) : vget_low_u8(next2));
+        const uint16x8_t low6 = vdupq_n_u16(0x3f);
+        const uint16x8_t two = vorrq_u16(vshlq_n_u16(vandq_u16(b0, vdupq_n_u16(0x1f)), 6), vandq_u16(b1, low6));
+        const uint16x8_t three = vorrq_u16(
+            vorrq_u16(vshlq_n_u16(b0, 12), vshlq_n_u16(vandq_u16(b1, low6), 6)),
+            vandq_u16(b2, low6));
+        const uint16x8_t isTwo = vceqq_u16(vandq_u16(b0, vdupq_n_u16(0xe0)), vdupq_n_u16(0xc0));
+        const uint16x8_t isThree = vceqq_u16(vandq_u16(b0, vdupq_n_u16(0xf0)), vdupq_n_u16(0xe0));
+        vst1q_u16(&units[half * 8], vbslq_u16(isThree, three, vbslq_u16(isTwo, two, b0)));
+    }
+#endif
+
+    // Stop before the first four byte sequence
+    size_t limit = Valid;
+    const uint32_t starts = ~cont & ((1u << Valid) - 1);
+    if (lead4 & starts)
+    {
+        limit = __builtin_ctz(lead4 & starts);
+    }
+
+    // and before a sequence that runs past the end of the window
+    const uint32_t inWindow = starts & ((1u << limit) - 1);
+    if (inWindow == 0)
+    {
+        return 0;
+    }
+    const size_t last = 31 - __builtin_clz(inWindow);
+    const size_t lastLength = (lead3 >> last) & 1 ? 3 : (lead2 >> last) & 1 ? 2 : 1;
+    if (last + lastLength > limit)
+    {
+        limit = last;
+    }
+
+    // Every continuation byte must be the one its lead byte expects
+    const uint32_t mask = (1u << limit) - 1;
+    const uint32_t expected = ((((lead2 | lead3) & mask) << 1) | ((lead3 & mask) << 2)) & 0xffff;
+    if (limit == 0 || (cont & mask) != expected || (bad & starts & mask) != 0)
+    {
+        return 0;
+    }
+
+    size_t out = *Written;
+    for (uint32_t pending = starts & mask; pending != 0; pending &= pending - 1)
+    {
+        out = Utf16WriteChar(Output, out, units[__builtin_ctz(pending)]);
+    }
+    *Written = out;
+
+    return limit;
+}
+#endif
+
+size_t
+Utf8ToUtf16le(
+    const uint8_t* Buffer,
+    const size_t Length,
+    uint8_t* Output
+)
+/*++
+ Converts well-formed UTF-8 to UTF-16LE. Output must hold at least
+ Length * 2 bytes. Runs of 16 ASCII bytes are widened with a single
+ zero-extend unpack, and one, two and three byte sequences are decoded
+ a window at a time by Utf8DecodeWindow. Four byte sequences and
+ malformed input are decoded one code point at a time. Returns the
+ number of bytes written to Output, or (size_t)-1 if the input is not
+ well-formed UTF-8.
+ --*/
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < Length)
+    {
+#if defined(__SSE2__)
+        while (Length - in >= 16)
+        {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*)&Buffer[in]);
+            if (_mm_movemask_epi8(chunk) != 0)
+            {
+                break;
+            }
+            const __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128((__m128i*)&Output[out], _mm_unpacklo_epi8(chunk, zero));
+            _mm_storeu_si128((__m128i*)&Output[out + 16], _mm_unpackhi_epi8(chunk, zero));
+            in += 16;
+            out += 32;
+        }
+#elif defined(__arm64__) || defined(__aarch64__)
+        while (Length - in >= 16)
+        {
+            const uint8x16_t chunk = vld1q_u8(&Buffer[in]);
+            if (vmaxvq_u8(chunk) >= 0x80)
+            {
+                break;
+            }
+            const uint8x16x2_t wide = vzipq_u8(chunk, vdupq_n_u8(0));
+            vst1q_u8(&Output[out], wide.val[0]);
+            vst1q_u8(&Output[out + 16], wide.val[1]);
+            in += 16;
+            out += 32;
+        }
+#endif
+        if (in == Length)
+        {
+            break;
+        }
+
+#if defined(UTF8_SIMD_WINDOW)
+        const size_t window = Length - in < UTF8_SIMD_WINDOW ? Length - in : UTF8_SIMD_WINDOW;
+        const size_t consumed = Utf8DecodeWindow(&Buffer[in], window, Output, &out);
+        if (consumed != 0)
+        {
+            in += consumed;
+            continue;
+        }
+#endif
+
+        const uint8_t lead = Buffer[in];
+        const size_t remaining = Length - in;
+        uint32_t codepoint;
+
+        if (lead < 0x80)
+        {
+            out = Utf16WriteChar(Output, out, lead);
+            in++;
+            continue;
+        }
+        else if (lead >= 0xc2 && lead <= 0xdf)
+        {
+            if (remaining < 2 || !Utf8IsContinuation(Buffer[in + 1]))
+            {
+                return (size_t)-1;
+            }
+            codepoint = ((lead & 0x1f) << 6) | (Buffer[in + 1] & 0x3f);
+            in += 2;
+        }
+        else if (lead >= 0xe0 && lead <= 0xef)
+        {
+            if (remaining < 3 || !Utf8IsContinuation(Buffer[in + 1]) || !Utf8IsContinuation(Buffer[in + 2]))
+            {
+                return (size_t)-1;
+            }
+            // Reject overlong encodings and surrogates
+            if ((lead == 0xe0 && Buffer[in + 1] < 0xa0) ||
+                (lead == 0xed && Buffer[in + 1] > 0x9f))
+            {
+                return (size_t)-1;
+            }
+            codepoint = ((lead & 0x0f) << 12) | ((Buffer[in + 1] & 0x3f) << 6) | (Buffer[in + 2] & 0x3f);
+            in += 3;
+        }
+        else if (lead >= 0xf0 && lead <= 0xf4)
+        {
+            if (remaining < 4 || !Utf8IsContinuation(Buffer[in + 1]) ||
+                !Utf8IsContinuation(Buffer[in + 2]) || !Utf8IsContinuation(Buffer[in + 3]))
+            {
+                return (size_t)-1;
+            }
+            // Reject overlong encodings and code points above U+10FFFF
+            if ((lead == 0xf0 && Buffer[in + 1] < 0x90) ||
+                (lead == 0xf4 && Buffer[in + 1] > 0x8f))
+            {
+                return (size_t)-1;
+            }
+            codepoint = ((lead & 0x07) << 18) | ((Buffer[in + 1] & 0x3f) << 12) |
+                ((Buffer[in + 2] & 0x3f) << 6) | (Buffer[in + 3] & 0x3f);
+            in += 4;
+        }
+        else
+        {
+            return (size_t)-1;
+        }
+
+        if (codepoint >= 0x10000)
+        {
+            // Encode as a surrogate pair
+            codepoint -= 0x10000;
+            out = Utf16WriteChar(Output, out, 0xd800 | (codepoint >> 10));
+            out = Utf16WriteChar(Output, out, 0xdc00 | (codepoint & 0x3ff));
+        }
+        else
+        {
+            out = Utf16WriteChar(Output, out, codepoint);
+        }
+    }
+
+    return out;
+}
+
+static uint8_t*
+NtlmConvertIcu(
+    const uint8_t* Buffer,
+    const size_t Length,
+    size_t* OutputLength
+)
+/*++
+ Last resort conversion for input that is not well-formed UTF-8.
+ Uses the ICU lenient converter so that the result matches what
+ the library has always produced for such input.
+ Returns a heap buffer the caller must free, or NULL on failure.
+ --*/
+{
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t newLength;
+    uint8_t* output;
+
+    u_strFromUTF8Lenient(NULL, 0, &newLength, (const char*)Buffer, Length, &status);
+    if (status != U_BUFFER_OVERFLOW_ERROR && status != U_STRING_NOT_TERMINATED_WARNING)
+    {
+        return NULL;
+    }
+
+    output = malloc((newLength + 1) * sizeof(UChar));
+    if (output == NULL)
+    {
+        return NULL;
+    }
+
+    // The preflight length is only an upper bound for malformed input,
+    // so take the length of what was actually converted
+    status = U_ZERO_ERROR;
+    u_strFromUTF8Lenient((UChar*)output, newLength + 1, &newLength, (const char*)Buffer, Length, &status);
+    if (U_FAILURE(status))
+    {
+        free(output);
+        return NULL;
+    }
+
+    *OutputLength = (size_t)newLength * sizeof(UChar);
+    return output;
+}
+
+static const uint8_t*
+NtlmConvert(
+    const uint8_t* Buffer,
+    const size_t Length,
+    uint8_t* Scratch,
+    const size_t ScratchSize,
+    size_t* OutputLength,
+    uint8_t** Allocation
+)
+/*++
+ Converts a single input to UTF-16LE, using Scratch when it is large
+ enough. If heap memory is needed it is returned in Allocation and
+ must be freed by the caller. If every conversion fails the original
+ input is returned so that the lane still produces a digest.
+ --*/
+{
+    uint8_t* output = Scratch;
+    size_t written;
+
+    *Allocation = NULL;
+
+    if (Length * sizeof(uint16_t) > ScratchSize)
+    {
+        output = malloc(Length * sizeof(uint16_t));
+        if (output == NULL)
+        {
+            *OutputLength = Length;
+            return Buffer;
+        }
+        *Allocation = output;
+    }
+
+    written = Utf8ToUtf16le(Buffer, Length, output);
+    if (written != (size_t)-1)
+    {
+        *OutputLength = written;
+        return output;
+    }
+
+    free(*Allocation);
+    *Allocation = NtlmConvertIcu(Buffer, Length, OutputLength);
+    if (*Allocation == NULL)
+    {
+        *OutputLength = Length;
+        return Buffer;
+    }
+
+    return *Allocation;
+}
+
+void
+SimdNtlmUpdate(
+    SimdHashContext* Context,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[]
+)
+{
+    uint8_t scratch[MAX_LANES][NTLM_STACK_BUFFER_SIZE];
+    uint8_t* allocations[MAX_LANES];
+    const uint8_t* newBuffers[MAX_LANES];
+    size_t newLengths[MAX_LANES];
+
+    for (size_t lane = 0; lane < Context->Lanes; lane++)
+    {
+        newBuffers[lane] = NtlmConvert(
+            Buffers[lane],
+            Lengths[lane],
+            scratch[lane],
+            sizeof(scratch[lane]),
+            &newLengths[lane],
+            &allocations[lane]
+        );
+    }
+
+    SimdHashUpdateInternal(
+        Context,
+        newLengths,
+        newBuffers
+    );
+
+    for (size_t lane = 0; lane < Context->Lanes; lane++)
+    {
+        free(allocations[lane]);
+    }
+}
+
+static inline void
+SimdNtlmWidenAscii(
+    SimdHashContext* Context,
+    const size_t Index,
+    const simd_t Value
+)
+/*++
+ Zero-extends four ASCII bytes per lane into two UTF-16LE dwords
+ and stores them straight into the interleaved buffer
+ --*/
+{
+    const simd_t lowMask = set1_epi32(0x000000ff);
+    const simd_t highMask = set1_epi32(0x00ff0000);
+    // b0 b1 b2 b3 -> (b0 0 b1 0) (b2 0 b3 0)
+    simd_t lo = or_simd(and_simd(Value, lowMask), and_simd(slli_epi32(Value, 8), highMask));
+    simd_t hi = or_simd(and_simd(srli_epi32(Value, 16), lowMask), and_simd(srli_epi32(Value, 8), highMask));
+    store_simd(&Context->Buffer[Index * 2].usimd, lo);
+    store_simd(&Context->Buffer[Index * 2 + 1].usimd, hi);
+}
+
+static inline void
+SimdNtlmWriteLane(
+    SimdHashContext* Context,
+    const size_t Lane,
+    const size_t Length,
+    const uint8_t* Buffer
+)
+{
+    uint8_t wide[NTLM_OPTIMIZED_BUFFER_SIZE * sizeof(uint16_t) * 2];
+    size_t wideLength = Utf8ToUtf16le(Buffer, Length, wide);
+
+    if (wideLength == (size_t)-1)
+    {
+        uint8_t* converted = NtlmConvertIcu(Buffer, Length, &wideLength);
+        if (converted == NULL)
+        {
+            // Match the general path which hashes the raw input
+            wideLength = Length;
+            memcpy(wide, Buffer, Length);
+        }
+        else
+        {
+            wideLength = wideLength > sizeof(wide) ? sizeof(wide) : wideLength;
+            memcpy(wide, converted, wideLength);
+            free(converted);
+        }
+    }
+
+    assert(wideLength <= MD4_OPTIMIZED_BUFFER_SIZE);
+
+    for (size_t i = 0; i < MD4_OPTIMIZED_BUFFER_SIZE / sizeof(uint32_t) + 1; i++)
+    {
+        Context->Buffer[i].epi32_u32[Lane] = 0;
+    }
+    for (size_t i = 0; i < wideLength; i++)
+    {
+        SimdHashWriteBuffer8(Context, i, Lane, wide[i]);
+    }
+
+    Context->Offset[Lane] += wideLength;
+    Context->BitLength[Lane] += wideLength * 8;
+}
+
+void
+SimdNtlmUpdateOptimized(
+    SimdHashContext* Context,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[]
+)
+{
+    const size_t lanes = Context->Lanes;
+
+    // Check if all lanes have the same length
+    const size_t len0 = Lengths[0];
+    bool uniform = true;
+    for (size_t i = 1; i < lanes; i++)
+    {
+        if (Lengths[i] != len0)
+        {
+            uniform = false;
+            break;
+        }
+    }
+
+    if (!uniform)
+    {
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            assert(Lengths[lane] <= NTLM_OPTIMIZED_BUFFER_SIZE);
+            SimdNtlmWriteLane(Context, lane, Lengths[lane], Buffers[lane]);
+        }
+        return;
+    }
+
+    assert(len0 <= NTLM_OPTIMIZED_BUFFER_SIZE);
+    const size_t fullDwords = len0 / 4;
+    const size_t tailBytes = len0 & 3;
+    simd_t seen = set1_epi32(0);
+
+    // Gather four input bytes per lane, widen them in-register and
+    // store the resulting eight UTF-16LE bytes per lane
+    for (size_t dw = 0; dw < fullDwords; dw++)
+    {
+        const size_t byteOff = dw * 4;
+        SimdValue v __attribute__((__aligned__(VALUE_ALIGN)));
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            memcpy(&v.epi32_u32[lane], &Buffers[lane][byteOff], sizeof(uint32_t));
+        }
+        simd_t value = load_simd(&v.usimd);
+        seen = or_simd(seen, value);
+        SimdNtlmWidenAscii(Context, dw, value);
+    }
+
+    if (tailBytes)
+    {
+        const size_t tailStart = fullDwords * 4;
+        SimdValue v __attribute__((__aligned__(VALUE_ALIGN)));
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            v.epi32_u32[lane] = 0;
+            for (size_t b = 0; b < tailBytes; b++)
+            {
+                v.epi32_u8[lane][b] = Buffers[lane][tailStart + b];
+            }
+        }
+        simd_t value = load_simd(&v.usimd);
+        seen = or_simd(seen, value);
+        SimdNtlmWidenAscii(Context, fullDwords, value);
+    }
+
+    SimdValue high __attribute__((__aligned__(VALUE_ALIGN)));
+    store_simd(&high.usimd, and_simd(seen, set1_epi32(0x80808080)));
+
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        if (high.epi32_u32[lane] != 0)
+        {
+            // Not ASCII, rewrite this lane with the full decoder
+            SimdNtlmWriteLane(Context, lane, len0, Buffers[lane]);
+        }
+        else
+        {
+            Context->Offset[lane] += len0 * 2;
+            Context->BitLength[lane] += len0 * 16;
+        }
+    }
+}
+
+void
+NTLMSingle(
+    const uint8_t* const Buffer,
+    const size_t Length,
+    const uint8_t* HashBuffer
+)
+{
+    uint8_t scratch[NTLM_STACK_BUFFER_SIZE];
+    uint8_t* allocation;
+    size_t newLength;
+
+    const uint8_t* converted = NtlmConvert(
+        Buffer,
+        Length,
+        scratch,
+        sizeof(scratch),
+        &newLength,
+        &allocation
+    );
+
+    MD4(converted, newLength, (uint8_t*) HashBuffer);
+    free(allocation);
+}
@@ -0,0 +1,487 @@
+//
+//  rules.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define LANE_COUNT (SIMD_WIDTH / 32)
+#define BLOCK_BYTES (MAX_BUFFER_SIZE_DWORDS * VALUE_ALIGN)
+
+typedef enum _RuleCode
+{
+    RuleNoop = ':',
+    RuleLower = 'l',
+    RuleUpper = 'u',
+    RuleCapitalize = 'c',
+    RuleInvertCapitalize = 'C',
+    RuleToggleAll = 't',
+    RuleToggleAt = 'T',
+    RuleReverse = 'r',
+    RuleDuplicate = 'd',
+    RuleAppend = '$',
+    RulePrepend = '^',
+    RuleDeleteFirst = '[',
+    RuleDeleteLast = ']',
+    RuleDeleteAt = 'D',
+    RuleTruncate = '\'',
+    RuleReplace = 's'
+} RuleCode;
+
+static inline bool
+ParsePosition(
+    const char Value,
+    uint8_t* Position
+)
+/*++
+ Positions are 0-9 then A-Z for 10 to 35
+--*/
+{
+    if (Value >= '0' && Value <= '9')
+    {
+        *Position = Value - '0';
+        return true;
+    }
+    if (Value >= 'A' && Value <= 'Z')
+    {
+        *Position = Value - 'A' + 10;
+        return true;
+    }
+    return false;
+}
+
+bool
+SimdHashRuleCompile(
+    SimdHashRule* Rule,
+    const char* Text
+)
+/*++
+ Compiles a hashcat style rule line such as "c $1 $2 so0" into a list of
+ operations. Spaces between operations are ignored. Supported are
+ : l u c C t TN r d $X ^X [ ] DN 'N and sXY
+--*/
+{
+    memset(Rule, 0, sizeof(*Rule));
+
+    for (const char* next = Text; *next; next++)
+    {
+        SimdHashRuleOp op = { (uint8_t)*next, 0, 0 };
+
+        switch (*next)
+        {
+        case ' ':
+        case RuleNoop:
+            continue;
+        case RuleLower:
+        case RuleUpper:
+        case RuleCapitalize:
+        case RuleInvertCapitalize:
+        case RuleToggleAll:
+        case RuleReverse:
+        case RuleDuplicate:
+        case RuleDeleteFirst:
+        case RuleDeleteLast:
+            break;
+        case RuleToggleAt:
+        case RuleDeleteAt:
+        case RuleTruncate:
+            if (!ParsePosition(*++next, &op.A))
+            {
+                return false;
+            }
+            break;
+        case RuleAppend:
+        case RulePrepend:
+            if (*++next == 0)
+            {
+                return false;
+            }
+            op.A = (uint8_t)*next;
+            break;
+        case RuleReplace:
+            if (next[1] == 0 || next[2] == 0)
+            {
+                return false;
+            }
+            op.A = (uint8_t)*++next;
+            op.B = (uint8_t)*++next;
+            break;
+        default:
+            return false;
+        }
+
+        if (Rule->Count == RULE_MAX_OPS)
+        {
+            return false;
+        }
+        Rule->Ops[Rule->Count++] = op;
+    }
+
+    return true;
+}
+
+void
+SimdHashRuleLoad(
+    SimdHashRuleWords* Words,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[]
+)
+/*++
+ Interleaves one lane group of base words, which are then mangled by
+ every rule without being read from memory again. Words longer than
+ RULE_MAX_LENGTH are loaded as rejected
+--*/
+{
+    memset(Words, 0, sizeof(*Words));
+
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        const size_t length = Lengths[lane];
+        if (length > RULE_MAX_LENGTH)
+        {
+            Words->Rejected |= 1ull << lane;
+            continue;
+        }
+        for (size_t i = 0; i < length; i++)
+        {
+            Words->Words[i / 4].epi32_u8[lane][i % 4] = Buffers[lane][i];
+        }
+        Words->Lengths[lane] = (uint32_t)length;
+    }
+}
+
+//
+// Whole block operations. These run over every byte of every lane with a
+// fixed trip count so that they compile to vector compares and blends.
+// No operation reads past a lane's length, so bytes there are only
+// cleared once before hashing
+//
+static inline void
+ChangeCase(
+    SimdValue* Words,
+    const uint8_t First,
+    const uint8_t Last,
+    const uint8_t Flip
+)
+{
+    uint8_t* bytes = (uint8_t*)Words;
+
+    for (size_t i = 0; i < BLOCK_BYTES; i++)
+    {
+        const uint8_t value = bytes[i];
+        bytes[i] = value ^ ((uint8_t)(value - First) <= (uint8_t)(Last - First) ? Flip : 0);
+    }
+}
+
+static inline void
+ToggleCase(
+    SimdValue* Words
+)
+{
+    uint8_t* bytes = (uint8_t*)Words;
+
+    for (size_t i = 0; i < BLOCK_BYTES; i++)
+    {
+        const uint8_t value = bytes[i];
+        const uint8_t folded = value | 0x20;
+        bytes[i] = value ^ ((uint8_t)(folded - 'a') <= 'z' - 'a' ? 0x20 : 0);
+    }
+}
+
+static inline void
+Replace(
+    SimdValue* Words,
+    const uint8_t From,
+    const uint8_t To
+)
+{
+    uint8_t* bytes = (uint8_t*)Words;
+
+    for (size_t i = 0; i < BLOCK_BYTES; i++)
+    {
+        bytes[i] = bytes[i] == From ? To : bytes[i];
+    }
+}
+
+static inline void
+ToggleAt(
+    SimdValue* Words,
+    const uint32_t Lengths[],
+    const size_t Position
+)
+/*++
+ One byte of one dword in every lane, masked by the lane lengths
+--*/
+{
+    if (Position >= RULE_MAX_LENGTH)
+    {
+        return;
+    }
+
+    SimdValue* word = &Words[Position / 4];
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        const uint8_t value = word->epi32_u8[lane][Position % 4];
+        const bool letter = (uint8_t)((value | 0x20) - 'a') <= 'z' - 'a';
+        word->epi32_u8[lane][Position % 4] = value ^ (letter && Position < Lengths[lane] ? 0x20 : 0);
+    }
+}
+
+static inline void
+ClearTail(
+    SimdValue* Words,
+    const uint32_t Lengths[]
+)
+{
+    for (size_t dw = 0; dw < MAX_BUFFER_SIZE_DWORDS; dw++)
+    {
+        for (size_t lane = 0; lane < LANE_COUNT; lane++)
+        {
+            const uint32_t start = (uint32_t)dw * 4;
+            const uint32_t bytes = Lengths[lane] > start ? Lengths[lane] - start : 0;
+            const uint32_t mask = bytes >= 4 ? UINT32_MAX : (1u << (bytes * 8)) - 1;
+            Words[dw].epi32_u32[lane] &= mask;
+        }
+    }
+}
+
+//
+// Per lane operations. These move bytes within a lane, which in the
+// interleaved layout means strided accesses inside the L1 resident block
+//
+static inline uint8_t
+GetByte(
+    const SimdValue* Words,
+    const size_t Lane,
+    const size_t Position
+)
+{
+    return Words[Position / 4].epi32_u8[Lane][Position % 4];
+}
+
+static inline void
+SetByte(
+    SimdValue* Words,
+    const size_t Lane,
+    const size_t Position,
+    const uint8_t Value
+)
+{
+    Words[Position / 4].epi32_u8[Lane][Position % 4] = Value;
+}
+
+static void
+ApplyLaneOp(
+    const SimdHashRuleOp* Op,
+    SimdValue* Words,
+    uint32_t* Length,
+    uint64_t* Rejected,
+    const size_t Lane
+)
+{
+    const uint32_t length = *Length;
+
+    switch (Op->Code)
+    {
+    case RuleReverse:
+        for (uint32_t i = 0; i < length / 2; i++)
+        {
+            const uint8_t low = GetByte(Words, Lane, i);
+            SetByte(Words, Lane, i, GetByte(Words, Lane, length - 1 - i));
+            SetByte(Words, Lane, length - 1 - i, low);
+        }
+        break;
+    case RuleDuplicate:
+        if (length * 2 > RULE_MAX_LENGTH)
+        {
+            *Rejected |= 1ull << Lane;
+            break;
+        }
+        for (uint32_t i = 0; i < length; i++)
+        {
+            SetByte(Words, Lane, length + i, GetByte(Words, Lane, i));
+        }
+        *Length = length * 2;
+        break;
+    case RuleAppend:
+        if (length + 1 > RULE_MAX_LENGTH)
+        {
+            *Rejected |= 1ull << Lane;
+            break;
+        }
+        SetByte(Words, Lane, length, Op->A);
+        *Length = length + 1;
+        break;
+    case RulePrepend:
+        if (length + 1 > RULE_MAX_LENGTH)
+        {
+            *Rejected |= 1ull << Lane;
+            break;
+        }
+        for (uint32_t i = length; i > 0; i--)
+        {
+            SetByte(Words, Lane, i, GetByte(Words, Lane, i - 1));
+        }
+        SetByte(Words, Lane, 0, Op->A);
+        *Length = length + 1;
+        break;
+    case RuleDeleteFirst:
+    case RuleDeleteAt:
+        {
+            const uint32_t position = Op->Code == RuleDeleteFirst ? 0 : Op->A;
+            if (position >= length)
+            {
+                break;
+            }
+            for (uint32_t i = position; i + 1 < length; i++)
+            {
+                SetByte(Words, Lane, i, GetByte(Words, Lane, i + 1));
+            }
+            *Length = length - 1;
+        }
+        break;
+    default:
+        assert(false);
+        break;
+    }
+}
+
+uint64_t
+SimdHashRuleApply(
+    const SimdHashRule* Rule,
+    const SimdHashRuleWords* Words,
+    SimdHashContext* Context
+)
+/*++
+ Mangles a loaded lane group with Rule directly in the message buffer of
+ a freshly reset context, leaving it ready for SimdHashFinalize. Returns
+ the mask of lanes whose candidate was not rejected for growing past
+ RULE_MAX_LENGTH
+--*/
+{
+    SimdValue* words = Context->Buffer;
+    uint32_t lengths[LANE_COUNT];
+    uint64_t rejected = Words->Rejected;
+
+    assert(Context->Lanes == LANE_COUNT);
+    assert(Context->Algorithm != HashAlgorithmNTLM);
+    assert(RULE_MAX_LENGTH <= GetOptimizedLength(Context->Algorithm));
+
+    for (size_t dw = 0; dw < MAX_BUFFER_SIZE_DWORDS; dw++)
+    {
+        store_simd(&words[dw].usimd, load_simd(&Words->Words[dw].usimd));
+    }
+    memcpy(lengths, Words->Lengths, sizeof(lengths));
+
+    for (size_t i = 0; i < Rule->Count; i++)
+    {
+        const SimdHashRuleOp* op = &Rule->Ops[i];
+
+        switch (op->Code)
+        {
+        case RuleLower:
+            ChangeCase(words, 'A', 'Z', 0x20);
+            break;
+        case RuleUpper:
+            ChangeCase(words, 'a', 'z', 0x20);
+            break;
+        case RuleCapitalize:
+            ChangeCase(words, 'A', 'Z', 0x20);
+            ToggleAt(words, lengths, 0);
+            break;
+        case RuleInvertCapitalize:
+            ChangeCase(words, 'a', 'z', 0x20);
+            ToggleAt(words, lengths, 0);
+            break;
+        case RuleToggleAll:
+            ToggleCase(words);
+            break;
+        case RuleToggleAt:
+            ToggleAt(words, lengths, op->A);
+            break;
+        case RuleReplace:
+            Replace(words, op->A, op->B);
+            break;
+        case RuleTruncate:
+            for (size_t lane = 0; lane < LANE_COUNT; lane++)
+            {
+                lengths[lane] = lengths[lane] < op->A ? lengths[lane] : op->A;
+            }
+            break;
+        case RuleDeleteLast:
+            for (size_t lane = 0; lane < LANE_COUNT; lane++)
+            {
+                lengths[lane] -= lengths[lane] > 0;
+            }
+            break;
+        default:
+            for (size_t lane = 0; lane < LANE_COUNT; lane++)
+            {
+                if (!(rejected & (1ull << lane)))
+                {
+                    ApplyLaneOp(op, words, &lengths[lane], &rejected, lane);
+                }
+            }
+            break;
+        }
+    }
+
+    ClearTail(words, lengths);
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        Context->Offset[lane] = lengths[lane];
+        Context->BitLength[lane] = (uint64_t)lengths[lane] * 8;
+    }
+
+    const uint64_t all = LANE_COUNT == 64 ? UINT64_MAX : (1ull << LANE_COUNT) - 1;
+    return all & ~rejected;
+}
+
+size_t
+SimdHashRuleApplySingle(
+    const SimdHashRule* Rule,
+    const uint8_t* Word,
+    const size_t Length,
+    uint8_t* Output
+)
+/*++
+ Scalar counterpart of SimdHashRuleApply for recovering the plaintext of
+ a hit. Output must hold RULE_MAX_LENGTH bytes. Returns the candidate
+ length or SIZE_MAX if the rule rejects the word
+--*/
+{
+    SimdHashRuleWords words;
+    SimdHashContext ctx;
+    size_t lengths[MAX_LANES] = { 0 };
+    const uint8_t* buffers[MAX_LANES];
+
+    // A single lane of the vector path keeps the two in step
+    for (size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        buffers[lane] = Word;
+    }
+    lengths[0] = Length;
+
+    SimdHashRuleLoad(&words, lengths, buffers);
+    SimdHashResetContext(&ctx, HashAlgorithmMD5);
+    if (!(SimdHashRuleApply(Rule, &words, &ctx) & 1))
+    {
+        return SIZE_MAX;
+    }
+
+    for (size_t i = 0; i < ctx.Offset[0]; i++)
+    {
+        Output[i] = GetByte(ctx.Buffer, 0, i);
+    }
+    return ctx.Offset[0];
+}
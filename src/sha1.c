@@ -44,8 +44,9 @@ SimdSha1Init(
 }
 
 void
-SimdSha1Transform(
+SimdSha1TransformBlock(
     SimdHashContext* Context,
+    const SimdValue Block[],
     const bool Finalize
 )
 {
@@ -57,7 +58,7 @@ SimdSha1Transform(
     // Load and change endianness from little endian buffer
     for (size_t i = 0; i < SHA1_BUFFER_SIZE_DWORDS; i++)
     {
-        messageSchedule[i] = bswap_epi32(load_simd(&Context->Buffer[i].usimd));
+        messageSchedule[i] = bswap_epi32(load_simd(&Block[i].usimd));
     }
     
     for (size_t i = SHA1_BUFFER_SIZE_DWORDS; i < SHA1_MESSAGE_SCHEDULE_SIZE_DWORDS; i++)
@@ -140,6 +141,15 @@ SimdSha1Transform(
         store_simd(&Context->H[3].usimd, add_epi32(dO, d));
         store_simd(&Context->H[4].usimd, add_epi32(eO, e));
     }
+}
+
+void
+SimdSha1Transform(
+    SimdHashContext* Context,
+    const bool Finalize
+)
+{
+    SimdSha1TransformBlock(Context, Context->Buffer, Finalize);
 
     //
     // Reset the offset and buffer
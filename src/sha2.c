@@ -145,8 +145,9 @@ SimdCalculateTemp1(
 }
 
 void
-SimdSha256Transform(
+SimdSha256TransformBlock(
     SimdHashContext* Context,
+    const SimdValue Block[],
     const bool Finalize
 )
 {
@@ -158,7 +159,7 @@ SimdSha256Transform(
     for (size_t i = 0; i < SHA256_BUFFER_SIZE_DWORDS; i++)
     {
         // Load and change endianness from little endian buffer
-        messageSchedule[i] = bswap_epi32(load_simd(&Context->Buffer[i].usimd));
+        messageSchedule[i] = bswap_epi32(load_simd(&Block[i].usimd));
     }
     
     for (size_t i = SHA256_BUFFER_SIZE_DWORDS; i < SHA256_MESSAGE_SCHEDULE_SIZE_DWORDS; i++)
@@ -225,6 +226,15 @@ SimdSha256Transform(
         store_simd(&Context->H[6].usimd, add_epi32(gO, g));
         store_simd(&Context->H[7].usimd, add_epi32(hO, h));
     }
+}
+
+void
+SimdSha256Transform(
+    SimdHashContext* Context,
+    const bool Finalize
+)
+{
+    SimdSha256TransformBlock(Context, Context->Buffer, Finalize);
 
     //
     // Reset the offset and buffer
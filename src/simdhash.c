@@ -6,13 +6,10 @@
 //  Copyright © 2024 Gareth Evans. All rights reserved.
 //
 
-#include <alloca.h>
 #include <string.h>
 #include <openssl/md4.h>
 #include <openssl/md5.h>
 #include <openssl/sha.h>
-#include <unicode/ucnv.h>
-#include <unicode/ustring.h>
 
 #include "simdhash.h"
 #include "simdcommon.h"
@@ -163,8 +160,9 @@ GetOptimizedLength(
     switch (Algorithm)
     {
     case HashAlgorithmMD4:
-    // case HashAlgorithmNTLM:
         return MD4_OPTIMIZED_BUFFER_SIZE;
+    case HashAlgorithmNTLM:
+        return NTLM_OPTIMIZED_BUFFER_SIZE;
     case HashAlgorithmMD5:
         return MD5_OPTIMIZED_BUFFER_SIZE;
     case HashAlgorithmSHA1:
@@ -176,6 +174,30 @@ GetOptimizedLength(
     }
 }
 
+const size_t
+GetOptimizedTwoBlockLength(
+    const HashAlgorithm Algorithm
+)
+/*++
+ Returns the longest input SimdHashOptimizedTwoBlock can pad directly
+ into two blocks, or zero if the algorithm has no two-block path
+--*/
+{
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+        return MD4_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE;
+    case HashAlgorithmMD5:
+        return MD5_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE;
+    case HashAlgorithmSHA1:
+        return SHA1_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE;
+    case HashAlgorithmSHA256:
+        return SHA256_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE;
+    default:
+        return 0;
+    }
+}
+
 const bool
 SupportsOptimization(
     const HashAlgorithm Algorithm)
@@ -186,10 +208,10 @@ SupportsOptimization(
     case HashAlgorithmMD5:
     case HashAlgorithmSHA1:
     case HashAlgorithmSHA256:
+    case HashAlgorithmNTLM:
         return true;
     case HashAlgorithmSHA384:
     case HashAlgorithmSHA512:
-    case HashAlgorithmNTLM:
     case HashAlgorithmUndefined:
     case HashAlgorithmFNV1_32:
     case HashAlgorithmFNV1a_32:
@@ -297,6 +319,38 @@ void SimdHashTransform(
     }
 }
 
+void
+SimdHashTransformBlock(
+    SimdHashContext* Context,
+    const SimdValue Block[]
+)
+/*++
+ Compresses Block into the state of Context without reading or clearing
+ the context's own buffer, so a block transposed once can be shared by
+ several contexts
+--*/
+{
+    switch (Context->Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmNTLM:
+        SimdMd4TransformBlock(Context, Block);
+        break;
+    case HashAlgorithmMD5:
+        SimdMd5TransformBlock(Context, Block);
+        break;
+    case HashAlgorithmSHA1:
+        SimdSha1TransformBlock(Context, Block, false);
+        break;
+    case HashAlgorithmSHA256:
+        SimdSha256TransformBlock(Context, Block, false);
+        break;
+    default:
+        assert(false);
+        break;
+    }
+}
+
 void
 CopyContextLane(
     SimdHashContext* Destination,
@@ -398,7 +452,12 @@ SimdHashUpdateOptimized(
     const uint8_t* const Buffers[]
 )
 {
-    assert(Context->Algorithm != HashAlgorithmNTLM);
+    if (Context->Algorithm == HashAlgorithmNTLM)
+    {
+        SimdNtlmUpdateOptimized(Context, Lengths, Buffers);
+        return;
+    }
+
     const size_t lanes = Context->Lanes;
 
     // Check if all lanes have the same length
@@ -480,63 +539,6 @@ SimdHashUpdateOptimized(
     }
 }
 
-static void
-SimdHashUpdateNTLM(
-    SimdHashContext* Context,
-    const size_t Lengths[],
-    const uint8_t* const Buffers[]
-)
-{
-    size_t newLengths[MAX_LANES];
-    uint8_t* newBuffers[MAX_LANES];
-
-    UErrorCode status = U_ZERO_ERROR;
-
-    for (size_t i = 0; i < Context->Lanes; i++)
-    {
-        int32_t newLength;
-        u_strFromUTF8Lenient(NULL, 0, &newLength, (const char*)Buffers[i], Lengths[i], &status);
-        if (status != U_BUFFER_OVERFLOW_ERROR && status != U_STRING_NOT_TERMINATED_WARNING)
-        { 
-            fprintf(stderr, "Error: %s\n", u_errorName(status));
-            // Fallback to hash the provided input
-            newBuffers[i] = (uint8_t*)Buffers[i];
-            newLengths[i] = Lengths[i];
-            continue;
-        }
-
-        // Reset the status and allocate memory
-        status = U_ZERO_ERROR;
-        newBuffers[i] = (uint8_t*)alloca((newLength + 1) * sizeof(UChar));
-        if (newBuffers[i] == NULL) {
-            fprintf(stderr, "Memory allocation error\n");
-            // Fallback to hash the provided input
-            newBuffers[i] = (uint8_t*)Buffers[i];
-            newLengths[i] = Lengths[i];
-            continue;
-        }
-
-        // Convert UTF-8 to UTF-16
-        u_strFromUTF8Lenient((UChar*)newBuffers[i], newLength + 1, NULL, (const char*)Buffers[i], Lengths[i], &status);
-        if (U_FAILURE(status)) {
-            fprintf(stderr, "Conversion error: %s\n", u_errorName(status));
-            // Fallback to hash the provided input
-            newBuffers[i] = (uint8_t*)Buffers[i];
-            newLengths[i] = Lengths[i];
-            continue;
-        }
-
-        newLengths[i] = (size_t)newLength * sizeof(UChar);
-    }
-
-    // Call the internal SimdHash update function
-    SimdHashUpdateInternal(
-        Context,
-        newLengths,
-        (const uint8_t**)newBuffers
-    );
-}
-
 void
 SimdHashUpdate(
     SimdHashContext* Context,
@@ -557,7 +559,7 @@ SimdHashUpdate(
         );
         break;
     case HashAlgorithmNTLM:
-        SimdHashUpdateNTLM(
+        SimdNtlmUpdate(
             Context,
             Lengths,
             Buffers
@@ -657,47 +659,194 @@ SimdHashGetHashes2D(
     }
 }
 
+#if defined(__AVX512F__)
+static inline void
+Transpose16x16(
+    const SimdValue* Rows,
+    uint32_t* Output,
+    const size_t Stride
+)
+/*++
+ Transposes 16 rows of 16 lanes so that each lane's 16 dwords are
+ written contiguously to Output + Lane * Stride
+--*/
+{
+    __m512i r[16], t[16], u[16];
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        r[i] = _mm512_loadu_si512(&Rows[i].usimd);
+    }
+
+    // Interleave dwords then qwords. Within each 128-bit block b of
+    // u[4 * g + j] sit rows 4g..4g+3 of lane 4b+j
+    for (size_t i = 0; i < 16; i += 2)
+    {
+        t[i] = _mm512_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm512_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    for (size_t g = 0; g < 16; g += 4)
+    {
+        u[g + 0] = _mm512_unpacklo_epi64(t[g + 0], t[g + 2]);
+        u[g + 1] = _mm512_unpackhi_epi64(t[g + 0], t[g + 2]);
+        u[g + 2] = _mm512_unpacklo_epi64(t[g + 1], t[g + 3]);
+        u[g + 3] = _mm512_unpackhi_epi64(t[g + 1], t[g + 3]);
+    }
+
+    // Transpose the 128-bit blocks across the four row groups
+    for (size_t j = 0; j < 4; j++)
+    {
+        const __m512i v0 = _mm512_shuffle_i32x4(u[j], u[4 + j], 0x44);
+        const __m512i v1 = _mm512_shuffle_i32x4(u[j], u[4 + j], 0xee);
+        const __m512i v2 = _mm512_shuffle_i32x4(u[8 + j], u[12 + j], 0x44);
+        const __m512i v3 = _mm512_shuffle_i32x4(u[8 + j], u[12 + j], 0xee);
+        _mm512_storeu_si512(Output + (0 + j) * Stride, _mm512_shuffle_i32x4(v0, v2, 0x88));
+        _mm512_storeu_si512(Output + (4 + j) * Stride, _mm512_shuffle_i32x4(v0, v2, 0xdd));
+        _mm512_storeu_si512(Output + (8 + j) * Stride, _mm512_shuffle_i32x4(v1, v3, 0x88));
+        _mm512_storeu_si512(Output + (12 + j) * Stride, _mm512_shuffle_i32x4(v1, v3, 0xdd));
+    }
+}
+#endif
+
+#if defined(__AVX2__)
+static inline void
+Transpose8x8(
+    const SimdValue* Rows,
+    const size_t Lane,
+    uint32_t* Output,
+    const size_t Stride
+)
+/*++
+ Transposes 8 rows of lanes Lane..Lane+7 so that each lane's 8 dwords
+ are written contiguously to Output + Lane * Stride
+--*/
+{
+    __m256i r[8], t[8], u[8];
+
+    for (size_t i = 0; i < 8; i++)
+    {
+        r[i] = _mm256_loadu_si256((const __m256i*)&Rows[i].epi32_u32[Lane]);
+    }
+    for (size_t i = 0; i < 8; i += 2)
+    {
+        t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    for (size_t g = 0; g < 8; g += 4)
+    {
+        u[g + 0] = _mm256_unpacklo_epi64(t[g + 0], t[g + 2]);
+        u[g + 1] = _mm256_unpackhi_epi64(t[g + 0], t[g + 2]);
+        u[g + 2] = _mm256_unpacklo_epi64(t[g + 1], t[g + 3]);
+        u[g + 3] = _mm256_unpackhi_epi64(t[g + 1], t[g + 3]);
+    }
+
+    Output += Lane * Stride;
+    for (size_t j = 0; j < 4; j++)
+    {
+        _mm256_storeu_si256((__m256i*)(Output + j * Stride), _mm256_permute2x128_si256(u[j], u[4 + j], 0x20));
+        _mm256_storeu_si256((__m256i*)(Output + (4 + j) * Stride), _mm256_permute2x128_si256(u[j], u[4 + j], 0x31));
+    }
+}
+#endif
+
+#if defined(__SSE2__) || defined(__arm64__) || defined(__aarch64__)
+static inline void
+Transpose4x4(
+    const SimdValue* Rows,
+    const size_t Lane,
+    uint32_t* Output,
+    const size_t Stride
+)
+/*++
+ Transposes 4 rows of lanes Lane..Lane+3 so that each lane's 4 dwords
+ are written contiguously to Output + Lane * Stride
+--*/
+{
+    Output += Lane * Stride;
+#if defined(__arm64__) || defined(__aarch64__)
+    const uint32x4x2_t t01 = vtrnq_u32(vld1q_u32(&Rows[0].epi32_u32[Lane]), vld1q_u32(&Rows[1].epi32_u32[Lane]));
+    const uint32x4x2_t t23 = vtrnq_u32(vld1q_u32(&Rows[2].epi32_u32[Lane]), vld1q_u32(&Rows[3].epi32_u32[Lane]));
+    vst1q_u32(Output + 0 * Stride, vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+    vst1q_u32(Output + 1 * Stride, vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+    vst1q_u32(Output + 2 * Stride, vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+    vst1q_u32(Output + 3 * Stride, vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+#else
+    const __m128i r0 = _mm_loadu_si128((const __m128i*)&Rows[0].epi32_u32[Lane]);
+    const __m128i r1 = _mm_loadu_si128((const __m128i*)&Rows[1].epi32_u32[Lane]);
+    const __m128i r2 = _mm_loadu_si128((const __m128i*)&Rows[2].epi32_u32[Lane]);
+    const __m128i r3 = _mm_loadu_si128((const __m128i*)&Rows[3].epi32_u32[Lane]);
+    const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    _mm_storeu_si128((__m128i*)(Output + 0 * Stride), _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128((__m128i*)(Output + 1 * Stride), _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128((__m128i*)(Output + 2 * Stride), _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128((__m128i*)(Output + 3 * Stride), _mm_unpackhi_epi64(t2, t3));
+#endif
+}
+#endif
+
 static inline void
 WriteSimdArrayToLinearBuffer(
     const SimdValue* Array,
     const size_t CountDwords,
     const uint8_t* HashBuffers
 )
+/*++
+ Writes the lane interleaved Array out as one contiguous run of
+ CountDwords dwords per lane, using the widest square in-register
+ transpose that fits the remaining rows
+--*/
 {
-#if defined __AVX512F__ && defined AVXSCATTER
-    for (size_t i = 0; i < CountDwords; i++)
-    {
-        __m512i h = _mm512_load_si512(&Array[i].usimd);
-        __m512i index = _mm512_setr_epi32(
-            (CountDwords * 0) + i,
-            (CountDwords * 1) + i,
-            (CountDwords * 2) + i,
-            (CountDwords * 3) + i,
-            (CountDwords * 4) + i,
-            (CountDwords * 5) + i,
-            (CountDwords * 6) + i,
-            (CountDwords * 7) + i,
-            (CountDwords * 8) + i,
-            (CountDwords * 9) + i,
-            (CountDwords * 10) + i,
-            (CountDwords * 11) + i,
-            (CountDwords * 12) + i,
-            (CountDwords * 13) + i,
-            (CountDwords * 14) + i,
-            (CountDwords * 15) + i
-        );
-        _mm512_i32scatter_epi32(HashBuffers, index, h, 4);
-    }
-#else
     uint32_t* buffer = (uint32_t*) HashBuffers;
-    for (size_t i = 0; i < CountDwords; i++)
+    const size_t lanes = SimdLanes();
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    for (; i + 16 <= CountDwords; i += 16)
     {
-        for (size_t l = 0; l < SimdLanes(); l++)
+        Transpose16x16(&Array[i], buffer + i, CountDwords);
+    }
+#endif
+#if defined(__AVX2__)
+    for (; i + 8 <= CountDwords; i += 8)
+    {
+        for (size_t l = 0; l < lanes; l += 8)
         {
-            buffer[(l * CountDwords) + i] = Array[i].epi32_u32[l];
+            Transpose8x8(&Array[i], l, buffer + i, CountDwords);
         }
     }
 #endif
+#if defined(__SSE2__) || defined(__arm64__) || defined(__aarch64__)
+    for (; i + 4 <= CountDwords; i += 4)
+    {
+        for (size_t l = 0; l < lanes; l += 4)
+        {
+            Transpose4x4(&Array[i], l, buffer + i, CountDwords);
+        }
+    }
+#endif
+    for (; i < CountDwords; i++)
+    {
+        for (size_t l = 0; l < lanes; l++)
+        {
+            buffer[(l * CountDwords) + i] = Array[i].epi32_u32[l];
+        }
+    }
+}
+
+static inline void
+WriteSimdArrayToSoABuffer(
+    const SimdValue* Array,
+    const size_t CountDwords,
+    uint8_t* HashBuffers
+)
+/*++
+ Writes the Array unchanged: dword i of every lane is contiguous
+--*/
+{
+    memcpy(HashBuffers, Array, CountDwords * SimdLanes() * sizeof(uint32_t));
 }
 
 void
@@ -709,6 +858,38 @@ SimdHashGetHashes(
     WriteSimdArrayToLinearBuffer(Context->H, Context->HSize, HashBuffers);
 }
 
+void
+SimdHashGetHashesSoA(
+    SimdHashContext* Context,
+    uint8_t* HashBuffers
+)
+{
+    WriteSimdArrayToSoABuffer(Context->H, Context->HSize, HashBuffers);
+}
+
+static void
+SimdHashExtendEntropy(
+    SimdHashContext* Context,
+    SimdValue* Buffer,
+    const size_t CountDwords
+)
+{
+    for (size_t i = 0; i < Context->HSize; i++)
+    {
+        Buffer[i].usimd = load_simd(&Context->H[i].usimd);
+    }
+
+    for (size_t i = Context->HSize; i < CountDwords; i++)
+    {
+        // s0 := (w[i-15] rightrotate  7) xor (w[i-15] rightrotate 18) xor (w[i-15] rightshift  3)
+        // s1 := (w[i-2] rightrotate 17) xor (w[i-2] rightrotate 19) xor (w[i-2] rightshift 10)
+        // w[i] := w[i-16] + s0 + w[i-7] + s1
+        simd_t s0 = xor_simd(xor_simd(rotr_epi32(Buffer[i - Context->HSize].usimd, 7), rotr_epi32(Buffer[i - Context->HSize].usimd, 18)), srli_epi32(Buffer[i - Context->HSize].usimd, 3));
+        simd_t s1 = xor_simd(xor_simd(rotr_epi32(Buffer[i - 2].usimd, 17), rotr_epi32(Buffer[i - 2].usimd, 19)), srli_epi32(Buffer[i - 2].usimd, 10));
+        Buffer[i].usimd = add_epi32(add_epi32(s0, s1), Buffer[i - 3].usimd);
+    }
+}
+
 void
 SimdHashExtendEntropyAndGetHashes(
     SimdHashContext* Context,
@@ -727,24 +908,30 @@ SimdHashExtendEntropyAndGetHashes(
     }
 
     SimdValue buffer[CountDwords];
+    SimdHashExtendEntropy(Context, buffer, CountDwords);
 
-    for (size_t i = 0; i < Context->HSize; i++)
-    {
-        buffer[i].usimd = load_simd(&Context->H[i].usimd);
-    }
+    // Output to the hash buffers
+    WriteSimdArrayToLinearBuffer(buffer, CountDwords, HashBuffers);
+}
 
-    for (size_t i = Context->HSize; i < CountDwords; i++)
+void
+SimdHashExtendEntropyAndGetHashesSoA(
+    SimdHashContext* Context,
+    uint8_t* HashBuffers,
+    size_t CountDwords
+)
+{
+    assert(CountDwords >= Context->HSize);
+
+    if (CountDwords == Context->HSize)
     {
-        // s0 := (w[i-15] rightrotate  7) xor (w[i-15] rightrotate 18) xor (w[i-15] rightshift  3)
-        // s1 := (w[i-2] rightrotate 17) xor (w[i-2] rightrotate 19) xor (w[i-2] rightshift 10)
-        // w[i] := w[i-16] + s0 + w[i-7] + s1
-        simd_t s0 = xor_simd(xor_simd(rotr_epi32(buffer[i - Context->HSize].usimd, 7), rotr_epi32(buffer[i - Context->HSize].usimd, 18)), srli_epi32(buffer[i - Context->HSize].usimd, 3));
-        simd_t s1 = xor_simd(xor_simd(rotr_epi32(buffer[i - 2].usimd, 17), rotr_epi32(buffer[i - 2].usimd, 19)), srli_epi32(buffer[i - 2].usimd, 10));
-        buffer[i].usimd = add_epi32(add_epi32(s0, s1), buffer[i - 3].usimd);
+        WriteSimdArrayToSoABuffer(Context->H, Context->HSize, HashBuffers);
+        return;
     }
 
-    // Output to the hash buffers
-    WriteSimdArrayToLinearBuffer(buffer, CountDwords, HashBuffers);
+    SimdValue buffer[CountDwords];
+    SimdHashExtendEntropy(Context, buffer, CountDwords);
+    WriteSimdArrayToSoABuffer(buffer, CountDwords, HashBuffers);
 }
 
 void
@@ -885,6 +1072,19 @@ SimdHashOptimized(
     case HashAlgorithmMD5:
     case HashAlgorithmSHA1:
     case HashAlgorithmSHA256:
+        {
+            // Inputs that spill past the first block take the two-block path
+            const size_t optimizedLength = GetOptimizedLength(Algorithm);
+            for (size_t lane = 0; lane < SimdLanes(); lane++)
+            {
+                if (Lengths[lane] > optimizedLength)
+                {
+                    SimdHashOptimizedTwoBlock(Algorithm, Lengths, Buffers, HashBuffers);
+                    return;
+                }
+            }
+        }
+        // Fall through
     case HashAlgorithmNTLM:
         {
             SimdHashContext ctx;
@@ -923,45 +1123,228 @@ SimdHashOptimized(
 }
 
 void
-NTLMSingle(
-    const uint8_t* const Buffer,
-    const size_t Length,
-    const uint8_t* HashBuffer
+SimdHashOptimizedTwoBlock(
+    HashAlgorithm Algorithm,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const uint8_t* HashBuffers
 )
+/*++
+ Hashes inputs of up to GetOptimizedTwoBlockLength bytes by padding them
+ straight into one or two blocks. Lanes that fit in the first block keep
+ their state from the first transform
+--*/
 {
-    UErrorCode status = U_ZERO_ERROR;
-    int32_t newLength;
-    uint8_t* buffer;
-
-    u_strFromUTF8Lenient(NULL, 0, &newLength, (const char*)Buffer, Length, &status);
-    if (status != U_BUFFER_OVERFLOW_ERROR && status != U_STRING_NOT_TERMINATED_WARNING)
-    { 
-        fprintf(stderr, "Error: %s\n", u_errorName(status));
-        // Fallback to hash the provided input
-        MD4(Buffer, Length, (uint8_t*) Buffer);
+    switch(Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmMD5:
+    case HashAlgorithmSHA1:
+    case HashAlgorithmSHA256:
+        break;
+    default:
+        SimdHash(Algorithm, Lengths, Buffers, HashBuffers);
         return;
     }
 
-    // Reset the status and allocate memory
-    status = U_ZERO_ERROR;
-    buffer = (uint8_t*)alloca((newLength + 1) * sizeof(UChar));
-    if (buffer == NULL) {
-        fprintf(stderr, "Memory allocation error\n");
-        // Fallback to hash the provided input
-        MD4(Buffer, Length, (uint8_t*) HashBuffer);
+    SimdHashContext ctx;
+    SimdValue firstBlockH[MAX_H_COUNT] __attribute__((__aligned__(VALUE_ALIGN)));
+    const size_t optimizedLength = GetOptimizedLength(Algorithm);
+    bool uniform = true;
+    size_t twoBlockLanes = 0;
+
+    SimdHashInit(&ctx, Algorithm);
+
+    for (size_t lane = 0; lane < ctx.Lanes; lane++)
+    {
+        assert(Lengths[lane] <= GetOptimizedTwoBlockLength(Algorithm));
+        if (Lengths[lane] != Lengths[0])
+        {
+            uniform = false;
+        }
+        if (Lengths[lane] > optimizedLength)
+        {
+            twoBlockLanes++;
+        }
+    }
+
+    SimdHashLoadPaddedBlock(&ctx, Lengths, Buffers, 0, uniform);
+    SimdHashTransform(&ctx);
+
+    if (twoBlockLanes)
+    {
+        if (twoBlockLanes != ctx.Lanes)
+        {
+            for (size_t i = 0; i < ctx.HSize; i++)
+            {
+                store_simd(&firstBlockH[i].usimd, load_simd(&ctx.H[i].usimd));
+            }
+        }
+
+        SimdHashLoadPaddedBlock(&ctx, Lengths, Buffers, 1, uniform);
+        SimdHashTransform(&ctx);
+
+        if (twoBlockLanes != ctx.Lanes)
+        {
+            // Restore the lanes that were complete after the first block
+            for (size_t lane = 0; lane < ctx.Lanes; lane++)
+            {
+                if (Lengths[lane] <= optimizedLength)
+                {
+                    for (size_t i = 0; i < ctx.HSize; i++)
+                    {
+                        ctx.H[i].epi32_u32[lane] = firstBlockH[i].epi32_u32[lane];
+                    }
+                }
+            }
+        }
+    }
+
+    if (Algorithm == HashAlgorithmSHA1 || Algorithm == HashAlgorithmSHA256)
+    {
+        for (size_t i = 0; i < ctx.HSize; i++)
+        {
+            store_simd(&ctx.H[i].usimd, bswap_epi32(load_simd(&ctx.H[i].usimd)));
+        }
+    }
+
+    SimdHashGetHashes(&ctx, HashBuffers);
+}
+
+const size_t
+GetSingleCrossover(
+    const HashAlgorithm Algorithm
+)
+/*++
+ Returns the largest number of inputs that finish sooner hashed one at a
+ time through OpenSSL than with the narrowest vector engine that holds
+ them. Measured with simdhashtest_perf --occupancy: a lone MD4 or MD5
+ input hashes in about 60% of the four lane engine's time, and a second
+ input doubles that while the engine's cost stays flat. OpenSSL SHA1 and
+ SHA256 only win for long lone inputs, so they always use the engines
+--*/
+{
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmMD5:
+        return 1;
+    case HashAlgorithmSHA384:
+    case HashAlgorithmSHA512:
+        return SimdLanes();
+    default:
+        return 0;
+    }
+}
+
+const size_t
+GetNarrowLanes(
+    const HashAlgorithm Algorithm,
+    const size_t Count
+)
+/*++
+ Returns the lane count of the narrowest engine that holds Count
+ inputs and is narrower than SimdLanes(), or 0 if there is none. Every
+ narrower engine that fits beats the full width transform, whose cost
+ does not fall with occupancy
+--*/
+{
+    static const size_t widths[] = {
+#if defined(__SSE2__)
+        4,
+#endif
+#if defined(__AVX2__)
+        8,
+#endif
+        0
+    };
+
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmMD5:
+    case HashAlgorithmSHA1:
+    case HashAlgorithmSHA256:
+        break;
+    default:
+        return 0;
+    }
+
+    for (size_t i = 0; widths[i] != 0 && widths[i] < SimdLanes(); i++)
+    {
+        if (Count <= widths[i])
+        {
+            return widths[i];
+        }
+    }
+    return 0;
+}
+
+void
+SimdHashAdaptive(
+    HashAlgorithm Algorithm,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const uint8_t* HashBuffers
+)
+/*++
+ Hashes Count (up to SimdLanes) inputs, choosing the cheapest kernel for
+ the occupancy: single hashes for very small batches, then the narrowest
+ vector engine that holds them, otherwise the optimized or general SIMD
+ path with the unused lanes left empty. Only Count digests are written
+ to HashBuffers
+--*/
+{
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    const size_t hashWidth = GetHashWidth(Algorithm);
+    size_t maxLength = 0;
+    size_t narrowLanes;
+
+    assert(Count <= SimdLanes());
+
+    if (Count == 0)
+    {
         return;
     }
 
-    // Convert UTF-8 to UTF-16
-    u_strFromUTF8Lenient((UChar*)buffer, newLength + 1, NULL, (const char*)Buffer, Length, &status);
-    if (U_FAILURE(status)) {
-        fprintf(stderr, "Conversion error: %s\n", u_errorName(status));
-        // Fallback to hash the provided input
-        MD4(Buffer, Length, (uint8_t*) HashBuffer);
+    if (Count <= GetSingleCrossover(Algorithm))
+    {
+        for (size_t i = 0; i < Count; i++)
+        {
+            SimdHashSingle(Algorithm, Lengths[i], Buffers[i], &HashBuffers[i * hashWidth]);
+        }
+        return;
+    }
+
+    narrowLanes = GetNarrowLanes(Algorithm, Count);
+    if (narrowLanes != 0 &&
+        SimdHashNarrow(Algorithm, narrowLanes, Count, Lengths, Buffers, HashBuffers))
+    {
         return;
     }
 
-    MD4(buffer, newLength * sizeof(UChar), (uint8_t*) HashBuffer);
+    for (size_t lane = 0; lane < SimdLanes(); lane++)
+    {
+        lengths[lane] = lane < Count ? Lengths[lane] : 0;
+        buffers[lane] = lane < Count ? Buffers[lane] : Buffers[0];
+        maxLength = lengths[lane] > maxLength ? lengths[lane] : maxLength;
+    }
+
+    if (SupportsOptimization(Algorithm) &&
+        (maxLength <= GetOptimizedLength(Algorithm) ||
+         maxLength <= GetOptimizedTwoBlockLength(Algorithm)))
+    {
+        SimdHashOptimized(Algorithm, lengths, buffers, hashes);
+    }
+    else
+    {
+        SimdHash(Algorithm, lengths, buffers, hashes);
+    }
+
+    memcpy((uint8_t*)HashBuffers, hashes, Count * hashWidth);
 }
 
 void
@@ -22,16 +22,20 @@
 #define MD4_BUFFER_SIZE (64)
 #define MD4_BUFFER_SIZE_DWORDS (MD4_BUFFER_SIZE / 4)
 #define MD4_OPTIMIZED_BUFFER_SIZE ((MD4_BUFFER_SIZE - sizeof(uint64_t)) - 1)
+#define MD4_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE ((2 * MD4_BUFFER_SIZE - sizeof(uint64_t)) - 1)
 #define MD4_H_COUNT (4)
 #define MD4_SIZE (MD4_H_COUNT * 4)
+#define NTLM_OPTIMIZED_BUFFER_SIZE (MD4_OPTIMIZED_BUFFER_SIZE / sizeof(uint16_t))
 #define MD5_BUFFER_SIZE (64)
 #define MD5_BUFFER_SIZE_DWORDS (MD5_BUFFER_SIZE / 4)
 #define MD5_OPTIMIZED_BUFFER_SIZE ((MD5_BUFFER_SIZE - sizeof(uint64_t)) - 1)
+#define MD5_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE ((2 * MD5_BUFFER_SIZE - sizeof(uint64_t)) - 1)
 #define MD5_H_COUNT (4)
 #define MD5_SIZE (MD5_H_COUNT * 4)
 #define SHA1_BUFFER_SIZE (64)
 #define SHA1_BUFFER_SIZE_DWORDS (SHA1_BUFFER_SIZE / 4)
 #define SHA1_OPTIMIZED_BUFFER_SIZE ((SHA1_BUFFER_SIZE - sizeof(uint64_t)) - 1)
+#define SHA1_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE ((2 * SHA1_BUFFER_SIZE - sizeof(uint64_t)) - 1)
 #define SHA1_H_COUNT (5)
 #define SHA1_SIZE (SHA1_H_COUNT * 4)
 #define SHA1_MESSAGE_SCHEDULE_SIZE (320)
@@ -39,6 +43,7 @@
 #define SHA256_BUFFER_SIZE (64)
 #define SHA256_BUFFER_SIZE_DWORDS (SHA256_BUFFER_SIZE / 4)
 #define SHA256_OPTIMIZED_BUFFER_SIZE ((SHA256_BUFFER_SIZE - sizeof(uint64_t)) - 1)
+#define SHA256_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE ((2 * SHA256_BUFFER_SIZE - sizeof(uint64_t)) - 1)
 #define SHA256_H_COUNT (8)
 #define SHA256_SIZE (SHA256_H_COUNT * 4)
 #define SHA256_MESSAGE_SCHEDULE_SIZE (256)
@@ -55,6 +60,7 @@
 #define MAX_BUFFER_SIZE (SHA256_BUFFER_SIZE)
 #define MAX_BUFFER_SIZE_DWORDS (MAX_BUFFER_SIZE / 4)
 #define MAX_OPTIMIZED_BUFFER_SIZE (SHA256_OPTIMIZED_BUFFER_SIZE)
+#define MAX_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE (SHA256_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE)
 
 #define FNV32_SIZE (4)
 #define FNV32_H_COUNT (1)
@@ -236,6 +242,10 @@ const size_t
 GetOptimizedLength(
 	const HashAlgorithm Algorithm);
 
+const size_t
+GetOptimizedTwoBlockLength(
+    const HashAlgorithm Algorithm);
+
 const bool
 SupportsOptimization(
     const HashAlgorithm Algorithm);
@@ -316,6 +326,558 @@ SimdHashOptimized(
     const uint8_t* const Buffers[],
     const uint8_t* HashBuffers);
 
+void
+SimdHashOptimizedTwoBlock(
+    HashAlgorithm Algorithm,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const uint8_t* HashBuffers);
+
+//
+// Occupancy aware hashing of partially filled batches
+//
+const size_t
+GetSingleCrossover(
+    const HashAlgorithm Algorithm);
+
+void
+SimdHashAdaptive(
+    HashAlgorithm Algorithm,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const uint8_t* HashBuffers);
+
+//
+// Narrower vector engines for partial batches. SimdHashNarrow hashes
+// Count inputs with the Lanes wide engine and returns false when
+// there is no such engine narrower than SimdLanes() for Algorithm
+//
+const size_t
+GetNarrowLanes(
+    const HashAlgorithm Algorithm,
+    const size_t Count);
+
+bool
+SimdHashNarrow(
+    const HashAlgorithm Algorithm,
+    const size_t Lanes,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const uint8_t* HashBuffers);
+
+//
+// Length bucketed hashing of arbitrarily many inputs
+//
+void
+SimdHashMany(
+    const HashAlgorithm Algorithm,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    uint8_t* HashBuffers);
+
+//
+// Fused multi-algorithm hashing
+//
+const bool
+SupportsMultiHash(
+    const HashAlgorithm Algorithm);
+
+void
+SimdHashMulti(
+    const size_t AlgorithmCount,
+    const HashAlgorithm Algorithms[],
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    uint8_t* const HashBuffers[]);
+
+//
+// Pooled state for many independent streams. H is held as structure of
+// arrays, H[i * Capacity + Stream], and full blocks from different
+// streams are transformed together a lane group at a time
+//
+typedef struct _SimdHashStreamPool
+{
+    HashAlgorithm Algorithm;
+    size_t    Capacity;
+    size_t    HSize;
+    size_t    HashSize;
+    size_t    BufferSize;
+    uint32_t  InitialH[MAX_H_COUNT];
+    uint32_t* H;
+    uint8_t*  Pending;
+    uint32_t* PendingLength;
+    uint64_t* BitLength;
+    size_t*   Ready;
+    size_t    ReadyCount;
+} SimdHashStreamPool;
+
+bool
+SimdHashStreamPoolInit(
+    SimdHashStreamPool* Pool,
+    const HashAlgorithm Algorithm,
+    const size_t Capacity);
+
+void
+SimdHashStreamPoolDestroy(
+    SimdHashStreamPool* Pool);
+
+void
+SimdHashStreamReset(
+    SimdHashStreamPool* Pool,
+    const size_t Stream);
+
+void
+SimdHashStreamUpdate(
+    SimdHashStreamPool* Pool,
+    const size_t Stream,
+    const size_t Length,
+    const uint8_t* Buffer);
+
+void
+SimdHashStreamPoolFlush(
+    SimdHashStreamPool* Pool);
+
+void
+SimdHashStreamFinalize(
+    SimdHashStreamPool* Pool,
+    const size_t Count,
+    const size_t Streams[],
+    uint8_t* HashBuffers);
+
+//
+// Arena backed candidate batch in the lane interleaved layout of
+// SimdHashContext::Buffer. Dword i of candidate c is held at
+// Words[(c / Lanes) * WidthDwords + i].epi32_u32[c % Lanes]
+//
+typedef struct _SimdHashBatch
+{
+    SimdValue* Words;
+    uint64_t*  Lengths;
+    size_t     Width;
+    size_t     WidthDwords;
+    size_t     Lanes;
+    size_t     Groups;
+    size_t     Capacity;
+    size_t     Count;
+    void*      Arena;
+    size_t     ArenaSize;
+    bool       Mapped;
+} SimdHashBatch;
+
+static inline size_t
+SimdHashBatchGroupCount(
+    const SimdHashBatch* Batch
+)
+{
+    return (Batch->Count + Batch->Lanes - 1) / Batch->Lanes;
+}
+
+bool
+SimdHashBatchInit(
+    SimdHashBatch* Batch,
+    const size_t Width,
+    const size_t Capacity,
+    const bool HugePages);
+
+void
+SimdHashBatchDestroy(
+    SimdHashBatch* Batch);
+
+void
+SimdHashBatchClear(
+    SimdHashBatch* Batch);
+
+void
+SimdHashBatchSet(
+    SimdHashBatch* Batch,
+    const size_t Index,
+    const size_t Length,
+    const uint8_t* Buffer);
+
+bool
+SimdHashBatchAdd(
+    SimdHashBatch* Batch,
+    const size_t Length,
+    const uint8_t* Buffer);
+
+SimdValue*
+SimdHashBatchGroupWords(
+    const SimdHashBatch* Batch,
+    const size_t Group);
+
+void
+SimdHashUpdateBatch(
+    SimdHashContext* Context,
+    const SimdHashBatch* Batch,
+    const size_t Group);
+
+void
+SimdHashBatchHash(
+    const HashAlgorithm Algorithm,
+    const SimdHashBatch* Batch,
+    uint8_t* HashBuffers);
+
+//
+// Thread local context pool. Contexts are cache aligned and reset from a
+// clean copy per algorithm; release them on the thread that acquired them
+//
+SimdHashContext*
+SimdHashAcquireContext(
+    const HashAlgorithm Algorithm);
+
+void
+SimdHashReleaseContext(
+    SimdHashContext* Context);
+
+void
+SimdHashResetContext(
+    SimdHashContext* Context,
+    const HashAlgorithm Algorithm);
+
+//
+// Newline splitting of an in-memory wordlist. Lines are handed out as
+// (pointer, length) pairs into the original data, ready for the lane
+// group hashers without a copy
+//
+typedef struct _SimdHashLineSplitter
+{
+    const uint8_t* Data;
+    size_t    Size;
+    size_t    Base;
+    size_t    Scan;
+    uint64_t  Newlines;
+    size_t    LineStart;
+    size_t    MinLength;
+    size_t    MaxLength;
+    bool      Final;
+} SimdHashLineSplitter;
+
+void
+SimdHashLineSplitterInit(
+    SimdHashLineSplitter* Splitter,
+    const uint8_t* Data,
+    const size_t Size,
+    const size_t MinLength,
+    const size_t MaxLength,
+    const bool Final);
+
+size_t
+SimdHashLineSplitterNext(
+    SimdHashLineSplitter* Splitter,
+    const size_t Count,
+    size_t Lengths[],
+    const uint8_t* Buffers[]);
+
+//
+// Memory mapped wordlist
+//
+typedef struct _SimdHashWordlist
+{
+    SimdHashLineSplitter Splitter;
+    const uint8_t* Mapping;
+    size_t    Size;
+    size_t    Readahead;
+} SimdHashWordlist;
+
+bool
+SimdHashWordlistOpen(
+    SimdHashWordlist* Wordlist,
+    const char* Path,
+    const size_t MinLength,
+    const size_t MaxLength);
+
+void
+SimdHashWordlistClose(
+    SimdHashWordlist* Wordlist);
+
+size_t
+SimdHashWordlistNext(
+    SimdHashWordlist* Wordlist,
+    const size_t Count,
+    size_t Lengths[],
+    const uint8_t* Buffers[]);
+
+//
+// Pipelined reader for plain, gzip or zstd wordlists. A background thread
+// decompresses into a ring of blocks holding whole lines; consumers take a
+// block at a time and split it into lane groups with its Splitter
+//
+typedef struct _SimdHashInputBlock
+{
+    uint8_t*  Data;
+    size_t    Size;
+    SimdHashLineSplitter Splitter;
+} SimdHashInputBlock;
+
+typedef struct _SimdHashCompressedReader SimdHashCompressedReader;
+
+SimdHashCompressedReader*
+SimdHashCompressedOpen(
+    const char* Path,
+    const size_t MinLength,
+    const size_t MaxLength,
+    const size_t BlockCount,
+    const size_t BlockSize);
+
+SimdHashInputBlock*
+SimdHashCompressedAcquire(
+    SimdHashCompressedReader* Reader);
+
+void
+SimdHashCompressedRelease(
+    SimdHashCompressedReader* Reader,
+    SimdHashInputBlock* Block);
+
+bool
+SimdHashCompressedFailed(
+    SimdHashCompressedReader* Reader);
+
+void
+SimdHashCompressedClose(
+    SimdHashCompressedReader* Reader);
+
+//
+// Mask attack generator. Candidates are produced a lane group at a time
+// straight into the interleaved message words, rightmost position fastest
+//
+#define MASK_MAX_LENGTH (MAX_OPTIMIZED_BUFFER_SIZE)
+#define MASK_CUSTOM_CHARSETS (4)
+
+typedef struct _SimdHashMask
+{
+    size_t    Length;
+    uint64_t  Keyspace;
+    uint16_t  CharsetSize[MASK_MAX_LENGTH];
+    uint8_t   Charset[MASK_MAX_LENGTH][256];
+} SimdHashMask;
+
+typedef struct _SimdHashMaskGenerator
+{
+    const SimdHashMask* Mask;
+    uint64_t  Next;
+    uint64_t  End;
+    uint32_t  Step[MASK_MAX_LENGTH];
+    SimdValue Index[MASK_MAX_LENGTH];
+    SimdValue Words[MAX_BUFFER_SIZE_DWORDS];
+} SimdHashMaskGenerator;
+
+bool
+SimdHashMaskParse(
+    SimdHashMask* Mask,
+    const char* Pattern,
+    const char* const Custom[MASK_CUSTOM_CHARSETS]);
+
+size_t
+SimdHashMaskCandidate(
+    const SimdHashMask* Mask,
+    const uint64_t Index,
+    uint8_t* Buffer);
+
+void
+SimdHashMaskGeneratorInit(
+    SimdHashMaskGenerator* Generator,
+    const SimdHashMask* Mask,
+    const uint64_t Start,
+    const uint64_t Count);
+
+size_t
+SimdHashMaskGeneratorNext(
+    SimdHashMaskGenerator* Generator,
+    SimdHashContext* Context);
+
+//
+// Rule engine. A lane group of base words is interleaved once and every
+// compiled rule mangles a copy of it in the context's message buffer
+//
+#define RULE_MAX_LENGTH (MAX_OPTIMIZED_BUFFER_SIZE)
+#define RULE_MAX_OPS (32)
+
+typedef struct _SimdHashRuleOp
+{
+    uint8_t   Code;
+    uint8_t   A;
+    uint8_t   B;
+} SimdHashRuleOp;
+
+typedef struct _SimdHashRule
+{
+    size_t    Count;
+    SimdHashRuleOp Ops[RULE_MAX_OPS];
+} SimdHashRule;
+
+typedef struct _SimdHashRuleWords
+{
+    SimdValue Words[MAX_BUFFER_SIZE_DWORDS];
+    uint32_t  Lengths[MAX_LANES];
+    uint64_t  Rejected;
+} SimdHashRuleWords;
+
+bool
+SimdHashRuleCompile(
+    SimdHashRule* Rule,
+    const char* Text);
+
+void
+SimdHashRuleLoad(
+    SimdHashRuleWords* Words,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[]);
+
+uint64_t
+SimdHashRuleApply(
+    const SimdHashRule* Rule,
+    const SimdHashRuleWords* Words,
+    SimdHashContext* Context);
+
+size_t
+SimdHashRuleApplySingle(
+    const SimdHashRule* Rule,
+    const uint8_t* Word,
+    const size_t Length,
+    uint8_t* Output);
+
+//
+// Markov candidate generator. Per position bigram counts trained from a
+// wordlist order each position's bytes by likelihood given the previous
+// byte, and candidate indices enumerate those ranks most likely first
+//
+#define MARKOV_MAX_LENGTH (MAX_OPTIMIZED_BUFFER_SIZE)
+
+typedef struct _SimdHashMarkovStats SimdHashMarkovStats;
+
+typedef struct _SimdHashMarkovChain
+{
+    size_t    Length;
+    size_t    Threshold;
+    uint64_t  Keyspace;
+    uint8_t*  Table;
+} SimdHashMarkovChain;
+
+typedef struct _SimdHashMarkovGenerator
+{
+    const SimdHashMarkovChain* Chain;
+    uint64_t  Next;
+    uint64_t  End;
+    bool      Started;
+    uint32_t  Step[MARKOV_MAX_LENGTH];
+    uint32_t  Ranks[MAX_LANES][MARKOV_MAX_LENGTH];
+    uint8_t   Candidates[MAX_LANES][MARKOV_MAX_LENGTH];
+} SimdHashMarkovGenerator;
+
+SimdHashMarkovStats*
+SimdHashMarkovCreate(
+    void);
+
+void
+SimdHashMarkovDestroy(
+    SimdHashMarkovStats* Stats);
+
+void
+SimdHashMarkovTrain(
+    SimdHashMarkovStats* Stats,
+    const uint8_t* Word,
+    const size_t Length);
+
+bool
+SimdHashMarkovTrainFile(
+    SimdHashMarkovStats* Stats,
+    const char* Path);
+
+bool
+SimdHashMarkovChainInit(
+    SimdHashMarkovChain* Chain,
+    const SimdHashMarkovStats* Stats,
+    const size_t Length,
+    const size_t Threshold,
+    const char* Charset);
+
+void
+SimdHashMarkovChainDestroy(
+    SimdHashMarkovChain* Chain);
+
+size_t
+SimdHashMarkovCandidate(
+    const SimdHashMarkovChain* Chain,
+    const uint64_t Index,
+    uint8_t* Buffer);
+
+void
+SimdHashMarkovGeneratorInit(
+    SimdHashMarkovGenerator* Generator,
+    const SimdHashMarkovChain* Chain,
+    const uint64_t Start,
+    const uint64_t Count);
+
+size_t
+SimdHashMarkovGeneratorNext(
+    SimdHashMarkovGenerator* Generator,
+    size_t Lengths[],
+    const uint8_t* Buffers[]);
+
+//
+// Combinator generator. Each left word's prefix is loaded once, with its
+// full blocks run into a shared midstate, and only right words are
+// written per lane group
+//
+typedef struct _SimdHashCombinator
+{
+    SimdHashContext Midstate;
+    SimdValue Words[MAX_BUFFER_SIZE_DWORDS];
+    HashAlgorithm Algorithm;
+    size_t    LeftCount;
+    const size_t* LeftLengths;
+    const uint8_t* const* Left;
+    size_t    RightCount;
+    const size_t* RightLengths;
+    const uint8_t* const* Right;
+    const uint8_t* Separator;
+    size_t    SeparatorLength;
+    size_t    MinLength;
+    size_t    MaxLength;
+    uint64_t  Keyspace;
+    uint64_t  Next;
+    uint64_t  End;
+    uint64_t  Current;
+    size_t    PrefixBlocks;
+    size_t    TailLength;
+    size_t    LaneLength[MAX_LANES];
+    uint64_t  Index[MAX_LANES];
+} SimdHashCombinator;
+
+bool
+SimdHashCombinatorInit(
+    SimdHashCombinator* Combinator,
+    const HashAlgorithm Algorithm,
+    const size_t LeftCount,
+    const size_t LeftLengths[],
+    const uint8_t* const Left[],
+    const size_t RightCount,
+    const size_t RightLengths[],
+    const uint8_t* const Right[],
+    const char* Separator,
+    const size_t MinLength,
+    const size_t MaxLength);
+
+void
+SimdHashCombinatorSeek(
+    SimdHashCombinator* Combinator,
+    const uint64_t Start,
+    const uint64_t Count);
+
+size_t
+SimdHashCombinatorCandidate(
+    const SimdHashCombinator* Combinator,
+    const uint64_t Index,
+    uint8_t* Buffer);
+
+size_t
+SimdHashCombinatorNext(
+    SimdHashCombinator* Combinator,
+    SimdHashContext* Context);
+
 //
 // MD4
 //
@@ -325,12 +887,39 @@ void SimdMd4Init(
 void SimdMd4Transform(
     SimdHashContext* Context);
 
+void SimdMd4TransformBlock(
+    SimdHashContext* Context,
+    const SimdValue Block[]);
+
 void SimdMd4Finalize(
     SimdHashContext* Context);
 
 void SimdMd4FinalizeOptimized(
     SimdHashContext* Context);
 
+//
+// NTLM
+//
+void SimdNtlmUpdate(
+    SimdHashContext* Context,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[]);
+
+void SimdNtlmUpdateOptimized(
+    SimdHashContext* Context,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[]);
+
+void NTLMSingle(
+    const uint8_t* const Buffer,
+    const size_t Length,
+    const uint8_t* HashBuffer);
+
+size_t Utf8ToUtf16le(
+    const uint8_t* Buffer,
+    const size_t Length,
+    uint8_t* Output);
+
 //
 // MD5
 //
@@ -340,6 +929,10 @@ void SimdMd5Init(
 void SimdMd5Transform(
     SimdHashContext* Context);
 
+void SimdMd5TransformBlock(
+    SimdHashContext* Context,
+    const SimdValue Block[]);
+
 void SimdMd5Finalize(
     SimdHashContext* Context);
 
@@ -356,6 +949,11 @@ void SimdSha1Transform(
     SimdHashContext* Context,
     const bool Finalize);
 
+void SimdSha1TransformBlock(
+    SimdHashContext* Context,
+    const SimdValue Block[],
+    const bool Finalize);
+
 void SimdSha1Finalize(
     SimdHashContext* Context);
 
@@ -372,6 +970,11 @@ void SimdSha256Transform(
     SimdHashContext* Context,
     const bool Finalize);
 
+void SimdSha256TransformBlock(
+    SimdHashContext* Context,
+    const SimdValue Block[],
+    const bool Finalize);
+
 void SimdSha256Finalize(
     SimdHashContext* Context);
 
@@ -510,9 +1113,98 @@ SimdHashExtendEntropyAndGetHashes(
     uint8_t* HashBuffers,
     size_t Length);
 
+//
+// Structure of arrays output: dword i of every lane is contiguous,
+// HashBuffers[(i * SimdLanes() + lane) * 4], for SIMD consumers
+//
+void
+SimdHashGetHashesSoA(
+    SimdHashContext* Context,
+    uint8_t* HashBuffers);
+
+void
+SimdHashExtendEntropyAndGetHashesSoA(
+    SimdHashContext* Context,
+    uint8_t* HashBuffers,
+    size_t Length);
+
+//
+// Hex and base64 encoding. The batch encoders write one NUL terminated
+// string per digest, each starting Stride characters after the last
+//
+static inline size_t
+SimdHashHexStride(
+    const size_t HashSize
+)
+{
+    return HashSize * 2 + 1;
+}
+
+static inline size_t
+SimdHashBase64Stride(
+    const size_t HashSize
+)
+{
+    return ((HashSize + 2) / 3) * 4 + 1;
+}
+
+size_t
+SimdHashEncodeHex(
+    const uint8_t* Input,
+    const size_t Length,
+    char* Output,
+    const bool Uppercase);
+
+size_t
+SimdHashDecodeHex(
+    const char* Input,
+    const size_t Length,
+    uint8_t* Output);
+
+size_t
+SimdHashEncodeBase64(
+    const uint8_t* Input,
+    const size_t Length,
+    char* Output);
+
+void
+SimdHashEncodeHashesHex(
+    const uint8_t* HashBuffers,
+    const size_t HashSize,
+    const size_t Count,
+    char* Output,
+    const bool Uppercase);
+
+void
+SimdHashEncodeHashesBase64(
+    const uint8_t* HashBuffers,
+    const size_t HashSize,
+    const size_t Count,
+    char* Output);
+
+void
+SimdHashGetHashesHex(
+    SimdHashContext* Context,
+    char* Output,
+    const bool Uppercase);
+
+void
+SimdHashGetHashesBase64(
+    SimdHashContext* Context,
+    char* Output);
+
 //
 // SimdHash Internal
 //
+void
+SimdHashTransform(
+    SimdHashContext* Context);
+
+void
+SimdHashTransformBlock(
+    SimdHashContext* Context,
+    const SimdValue Block[]);
+
 void
 CopyContextLane(
     SimdHashContext* Destination,
@@ -0,0 +1,281 @@
+//
+//  streampool.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+bool
+SimdHashStreamPoolInit(
+    SimdHashStreamPool* Pool,
+    const HashAlgorithm Algorithm,
+    const size_t Capacity
+)
+/*++
+ Allocates state for Capacity streams, identified by 0..Capacity-1.
+ Only the algorithms with a 64 byte block transform are supported
+--*/
+{
+    SimdHashContext ctx;
+
+    memset(Pool, 0, sizeof(*Pool));
+
+    switch (Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmMD5:
+    case HashAlgorithmSHA1:
+    case HashAlgorithmSHA256:
+        break;
+    default:
+        return false;
+    }
+
+    SimdHashInit(&ctx, Algorithm);
+    Pool->Algorithm = Algorithm;
+    Pool->Capacity = Capacity;
+    Pool->HSize = ctx.HSize;
+    Pool->HashSize = ctx.HashSize;
+    Pool->BufferSize = ctx.BufferSize;
+    for (size_t i = 0; i < ctx.HSize; i++)
+    {
+        Pool->InitialH[i] = ctx.H[i].epi32_u32[0];
+    }
+
+    Pool->H = malloc(Capacity * Pool->HSize * sizeof(uint32_t));
+    Pool->Pending = malloc(Capacity * Pool->BufferSize);
+    Pool->PendingLength = malloc(Capacity * sizeof(uint32_t));
+    Pool->BitLength = malloc(Capacity * sizeof(uint64_t));
+    Pool->Ready = malloc(Capacity * sizeof(size_t));
+    if (Pool->H == NULL || Pool->Pending == NULL || Pool->PendingLength == NULL ||
+        Pool->BitLength == NULL || Pool->Ready == NULL)
+    {
+        SimdHashStreamPoolDestroy(Pool);
+        return false;
+    }
+
+    for (size_t stream = 0; stream < Capacity; stream++)
+    {
+        SimdHashStreamReset(Pool, stream);
+    }
+
+    return true;
+}
+
+void
+SimdHashStreamPoolDestroy(
+    SimdHashStreamPool* Pool
+)
+{
+    free(Pool->H);
+    free(Pool->Pending);
+    free(Pool->PendingLength);
+    free(Pool->BitLength);
+    free(Pool->Ready);
+    memset(Pool, 0, sizeof(*Pool));
+}
+
+void
+SimdHashStreamReset(
+    SimdHashStreamPool* Pool,
+    const size_t Stream
+)
+/*++
+ Returns Stream to its initial state. A full block the stream still has
+ queued is dropped with it, so the next flush cannot transform whatever
+ the stream is given after the reset
+--*/
+{
+    assert(Stream < Pool->Capacity);
+
+    for (size_t i = 0; i < Pool->ReadyCount; i++)
+    {
+        if (Pool->Ready[i] == Stream)
+        {
+            Pool->Ready[i] = Pool->Ready[--Pool->ReadyCount];
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < Pool->HSize; i++)
+    {
+        Pool->H[i * Pool->Capacity + Stream] = Pool->InitialH[i];
+    }
+    Pool->PendingLength[Stream] = 0;
+    Pool->BitLength[Stream] = 0;
+}
+
+static void
+GatherStreams(
+    const SimdHashStreamPool* Pool,
+    SimdHashContext* Context,
+    const size_t Count,
+    const size_t Streams[]
+)
+/*++
+ Loads the state and pending bytes of up to SimdLanes streams into the
+ lanes of Context. Unused lanes are left empty, as are the bytes after
+ the pending ones since finalization relies on a zeroed buffer
+--*/
+{
+    SimdHashInit(Context, Pool->Algorithm);
+
+    for (size_t lane = 0; lane < Count; lane++)
+    {
+        const size_t stream = Streams[lane];
+        const uint8_t* pending = &Pool->Pending[stream * Pool->BufferSize];
+        const size_t pendingLength = Pool->PendingLength[stream];
+
+        for (size_t i = 0; i < Pool->HSize; i++)
+        {
+            Context->H[i].epi32_u32[lane] = Pool->H[i * Pool->Capacity + stream];
+        }
+        for (size_t i = 0; i < pendingLength / sizeof(uint32_t); i++)
+        {
+            memcpy(&Context->Buffer[i].epi32_u32[lane], &pending[i * sizeof(uint32_t)], sizeof(uint32_t));
+        }
+        if (pendingLength % sizeof(uint32_t))
+        {
+            uint32_t tail = 0;
+            const size_t i = pendingLength / sizeof(uint32_t);
+            memcpy(&tail, &pending[i * sizeof(uint32_t)], pendingLength % sizeof(uint32_t));
+            Context->Buffer[i].epi32_u32[lane] = tail;
+        }
+        Context->Offset[lane] = pendingLength;
+        Context->BitLength[lane] = Pool->BitLength[stream];
+    }
+}
+
+static void
+ScatterStreams(
+    SimdHashStreamPool* Pool,
+    const SimdHashContext* Context,
+    const size_t Count,
+    const size_t Streams[]
+)
+{
+    for (size_t lane = 0; lane < Count; lane++)
+    {
+        const size_t stream = Streams[lane];
+        for (size_t i = 0; i < Pool->HSize; i++)
+        {
+            Pool->H[i * Pool->Capacity + stream] = Context->H[i].epi32_u32[lane];
+        }
+        Pool->PendingLength[stream] = 0;
+    }
+}
+
+void
+SimdHashStreamPoolFlush(
+    SimdHashStreamPool* Pool
+)
+/*++
+ Transforms every stream that has a full block pending, SimdLanes
+ streams per transform
+--*/
+{
+    SimdHashContext ctx;
+    const size_t lanes = SimdLanes();
+
+    for (size_t i = 0; i < Pool->ReadyCount; i += lanes)
+    {
+        const size_t count = Pool->ReadyCount - i < lanes ? Pool->ReadyCount - i : lanes;
+        GatherStreams(Pool, &ctx, count, &Pool->Ready[i]);
+        SimdHashTransform(&ctx);
+        ScatterStreams(Pool, &ctx, count, &Pool->Ready[i]);
+    }
+
+    Pool->ReadyCount = 0;
+}
+
+void
+SimdHashStreamUpdate(
+    SimdHashStreamPool* Pool,
+    const size_t Stream,
+    const size_t Length,
+    const uint8_t* Buffer
+)
+/*++
+ Appends Length bytes to Stream. Full blocks are queued and transformed
+ together with those of other streams once a lane group is ready, or
+ when this stream needs its pending block cleared
+--*/
+{
+    size_t remaining = Length;
+
+    assert(Stream < Pool->Capacity);
+
+    while (remaining)
+    {
+        uint32_t pending = Pool->PendingLength[Stream];
+
+        if (pending == Pool->BufferSize)
+        {
+            // Still waiting on the last full block
+            SimdHashStreamPoolFlush(Pool);
+            pending = 0;
+        }
+
+        const size_t space = Pool->BufferSize - pending;
+        const size_t toCopy = remaining < space ? remaining : space;
+        memcpy(&Pool->Pending[Stream * Pool->BufferSize + pending], Buffer, toCopy);
+        Pool->PendingLength[Stream] = pending + (uint32_t)toCopy;
+        Pool->BitLength[Stream] += toCopy * 8;
+        Buffer += toCopy;
+        remaining -= toCopy;
+
+        if (Pool->PendingLength[Stream] == Pool->BufferSize)
+        {
+            Pool->Ready[Pool->ReadyCount++] = Stream;
+            if (Pool->ReadyCount == SimdLanes())
+            {
+                SimdHashStreamPoolFlush(Pool);
+            }
+        }
+    }
+}
+
+void
+SimdHashStreamFinalize(
+    SimdHashStreamPool* Pool,
+    const size_t Count,
+    const size_t Streams[],
+    uint8_t* HashBuffers
+)
+/*++
+ Finalizes Count streams, SimdLanes at a time, writing their digests to
+ HashBuffers in the order given. The streams are reset for reuse.
+ A stream must not appear twice in Streams
+--*/
+{
+    SimdHashContext ctx;
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    const size_t lanes = SimdLanes();
+
+    // Finalize needs every pending block to be a partial one
+    SimdHashStreamPoolFlush(Pool);
+
+    for (size_t i = 0; i < Count; i += lanes)
+    {
+        const size_t count = Count - i < lanes ? Count - i : lanes;
+        GatherStreams(Pool, &ctx, count, &Streams[i]);
+        SimdHashFinalize(&ctx);
+        SimdHashGetHashes(&ctx, hashes);
+        memcpy(&HashBuffers[i * Pool->HashSize], hashes, count * Pool->HashSize);
+
+        for (size_t lane = 0; lane < count; lane++)
+        {
+            SimdHashStreamReset(Pool, Streams[i + lane]);
+        }
+    }
+}
@@ -0,0 +1,275 @@
+//
+//  wordlist.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "simdhash.h"
+#include "simdcommon.h"
+
+#define SPLIT_CHUNK_SIZE (64)
+#define READAHEAD_WINDOW (8 * 1024 * 1024)
+
+static const uint8_t EmptyLine = 0;
+
+static inline uint64_t
+NewlineMask(
+    const uint8_t* Data,
+    const size_t Length
+)
+/*++
+ One bit per byte of the chunk, set where the byte is a newline. Full
+ chunks are compared a vector at a time, the tail of the input bytewise
+--*/
+{
+    uint64_t mask = 0;
+
+    if (Length == SPLIT_CHUNK_SIZE)
+    {
+#if defined(__AVX512BW__)
+        return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(Data), _mm512_set1_epi8('\n'));
+#elif defined(__AVX2__)
+        const __m256i newline = _mm256_set1_epi8('\n');
+        const uint32_t lo = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)Data), newline));
+        const uint32_t hi = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(Data + 32)), newline));
+        return ((uint64_t)hi << 32) | lo;
+#elif defined(__SSE2__)
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (size_t i = 0; i < SPLIT_CHUNK_SIZE; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128((const __m128i*)(Data + i));
+            mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)) << i;
+        }
+        return mask;
+#elif defined(__arm64__) || defined(__aarch64__)
+        const uint8x16_t newline = vdupq_n_u8('\n');
+        for (size_t i = 0; i < SPLIT_CHUNK_SIZE; i += 16)
+        {
+            // Narrow the byte compare to a nibble per byte
+            const uint8x16_t eq = vceqq_u8(vld1q_u8(Data + i), newline);
+            uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+            for (size_t j = 0; nibbles; j++, nibbles >>= 4)
+            {
+                mask |= (uint64_t)(nibbles & 1) << (i + j);
+            }
+        }
+        return mask;
+#endif
+    }
+
+    for (size_t i = 0; i < Length; i++)
+    {
+        mask |= (uint64_t)(Data[i] == '\n') << i;
+    }
+    return mask;
+}
+
+void
+SimdHashLineSplitterInit(
+    SimdHashLineSplitter* Splitter,
+    const uint8_t* Data,
+    const size_t Size,
+    const size_t MinLength,
+    const size_t MaxLength,
+    const bool Final
+)
+/*++
+ Splits Data on newlines, dropping a trailing carriage return and any
+ line outside [MinLength, MaxLength]. Unless Final is set, bytes after
+ the last newline are left unconsumed for the caller to carry over
+--*/
+{
+    Splitter->Data = Data;
+    Splitter->Size = Size;
+    Splitter->Base = 0;
+    Splitter->Scan = 0;
+    Splitter->Newlines = 0;
+    Splitter->LineStart = 0;
+    Splitter->MinLength = MinLength;
+    Splitter->MaxLength = MaxLength;
+    Splitter->Final = Final;
+}
+
+static inline bool
+AcceptLine(
+    const SimdHashLineSplitter* Splitter,
+    const size_t Start,
+    const size_t End,
+    size_t* Length
+)
+{
+    size_t length = End - Start;
+
+    if (length > 0 && Splitter->Data[End - 1] == '\r')
+    {
+        length--;
+    }
+    *Length = length;
+    return length >= Splitter->MinLength && length <= Splitter->MaxLength;
+}
+
+size_t
+SimdHashLineSplitterNext(
+    SimdHashLineSplitter* Splitter,
+    const size_t Count,
+    size_t Lengths[],
+    const uint8_t* Buffers[]
+)
+/*++
+ Fills up to Count lines, pointing into Data, and returns how many were
+ found. Entries past the returned count are set to empty inputs so that
+ the arrays can be handed straight to the lane group hashers
+--*/
+{
+    size_t found = 0;
+
+    while (found < Count)
+    {
+        while (Splitter->Newlines == 0 && Splitter->Scan < Splitter->Size)
+        {
+            const size_t remaining = Splitter->Size - Splitter->Scan;
+            const size_t length = remaining < SPLIT_CHUNK_SIZE ? remaining : SPLIT_CHUNK_SIZE;
+            Splitter->Base = Splitter->Scan;
+            Splitter->Newlines = NewlineMask(Splitter->Data + Splitter->Scan, length);
+            Splitter->Scan += length;
+        }
+
+        size_t end;
+        if (Splitter->Newlines != 0)
+        {
+            end = Splitter->Base + __builtin_ctzll(Splitter->Newlines);
+            Splitter->Newlines &= Splitter->Newlines - 1;
+        }
+        else if (Splitter->Final && Splitter->LineStart < Splitter->Size)
+        {
+            end = Splitter->Size;
+        }
+        else
+        {
+            break;
+        }
+
+        size_t length;
+        if (AcceptLine(Splitter, Splitter->LineStart, end, &length))
+        {
+            Lengths[found] = length;
+            Buffers[found] = Splitter->Data + Splitter->LineStart;
+            found++;
+        }
+        Splitter->LineStart = end + 1;
+    }
+
+    if (Splitter->LineStart > Splitter->Size)
+    {
+        Splitter->LineStart = Splitter->Size;
+    }
+
+    for (size_t i = found; i < Count; i++)
+    {
+        Lengths[i] = 0;
+        Buffers[i] = &EmptyLine;
+    }
+
+    return found;
+}
+
+bool
+SimdHashWordlistOpen(
+    SimdHashWordlist* Wordlist,
+    const char* Path,
+    const size_t MinLength,
+    const size_t MaxLength
+)
+/*++
+ Maps the whole file read only. Candidates handed out by
+ SimdHashWordlistNext point into the mapping and stay valid until close
+--*/
+{
+    struct stat info;
+    int fd;
+
+    memset(Wordlist, 0, sizeof(*Wordlist));
+
+    fd = open(Path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    Wordlist->Size = (size_t)info.st_size;
+    if (Wordlist->Size > 0)
+    {
+        void* mapping = mmap(NULL, Wordlist->Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+        Wordlist->Mapping = (const uint8_t*)mapping;
+        madvise(mapping, Wordlist->Size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    SimdHashLineSplitterInit(&Wordlist->Splitter, Wordlist->Mapping, Wordlist->Size, MinLength, MaxLength, true);
+    return true;
+}
+
+void
+SimdHashWordlistClose(
+    SimdHashWordlist* Wordlist
+)
+{
+    if (Wordlist->Mapping != NULL)
+    {
+        munmap((void*)Wordlist->Mapping, Wordlist->Size);
+    }
+    memset(Wordlist, 0, sizeof(*Wordlist));
+}
+
+size_t
+SimdHashWordlistNext(
+    SimdHashWordlist* Wordlist,
+    const size_t Count,
+    size_t Lengths[],
+    const uint8_t* Buffers[]
+)
+/*++
+ Returns the next Count candidates. Pages ahead of the split position
+ are requested a window at a time so that faulting them in overlaps with
+ hashing
+--*/
+{
+    const size_t position = Wordlist->Splitter.Scan;
+
+    if (Wordlist->Mapping != NULL &&
+        position + READAHEAD_WINDOW / 2 >= Wordlist->Readahead &&
+        Wordlist->Readahead < Wordlist->Size)
+    {
+        const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        const size_t start = Wordlist->Readahead & ~(pageSize - 1);
+        const size_t end = Wordlist->Readahead + READAHEAD_WINDOW;
+        const size_t length = (end < Wordlist->Size ? end : Wordlist->Size) - start;
+        madvise((void*)(Wordlist->Mapping + start), length, MADV_WILLNEED);
+        Wordlist->Readahead = start + length;
+    }
+
+    return SimdHashLineSplitterNext(&Wordlist->Splitter, Count, Lengths, Buffers);
+}
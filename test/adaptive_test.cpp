@@ -0,0 +1,120 @@
+//
+// adaptive_test.cpp
+// Tests for occupancy aware hashing of partial batches (SimdHashAdaptive)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class AdaptiveTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+TEST_P(AdaptiveTest, EveryOccupancyMatchesSingle) {
+    const HashAlgorithm algo = GetParam();
+    const size_t lanes = SimdLanes();
+    const size_t digestLen = GetHashWidth(algo);
+
+    ASSERT_LE(GetSingleCrossover(algo), lanes);
+
+    uint8_t buffers[MAX_LANES][200];
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    srand(32);
+    // Short inputs take the optimized path, long ones the general path
+    for (size_t maxLength : {(size_t)40, (size_t)100, (size_t)200}) {
+        for (size_t count = 0; count <= lanes; count++) {
+            for (size_t i = 0; i < count; i++) {
+                lengths[i] = ((size_t)rand()) % maxLength;
+                for (size_t j = 0; j < lengths[i]; j++) {
+                    buffers[i][j] = (uint8_t)(rand() & 0xff);
+                }
+                bufferptrs[i] = buffers[i];
+            }
+
+            // Digests past Count must not be written
+            std::vector<uint8_t> hashes(MAX_LANES * MAX_HASH_SIZE, 0xa5);
+            SimdHashAdaptive(algo, count, lengths, bufferptrs, hashes.data());
+
+            for (size_t i = 0; i < count; i++) {
+                uint8_t expected[MAX_HASH_SIZE];
+                SimdHashSingle(algo, lengths[i], bufferptrs[i], expected);
+                ASSERT_EQ(0, memcmp(&hashes[i * digestLen], expected, digestLen))
+                    << "count=" << count << " lane=" << i << " length=" << lengths[i];
+            }
+            for (size_t i = count * digestLen; i < hashes.size(); i++) {
+                ASSERT_EQ(hashes[i], 0xa5) << "count=" << count << " byte=" << i;
+            }
+        }
+    }
+}
+
+TEST_P(AdaptiveTest, NarrowEnginesMatchSingle) {
+    const HashAlgorithm algo = GetParam();
+    const size_t digestLen = GetHashWidth(algo);
+
+    uint8_t buffers[8][150];
+    const uint8_t* bufferptrs[8];
+    size_t lengths[8];
+
+    srand(33);
+    for (size_t narrow : {(size_t)4, (size_t)8}) {
+        for (size_t count = 1; count <= narrow; count++) {
+            // Mixed lengths across one, two and three blocks
+            for (size_t i = 0; i < count; i++) {
+                lengths[i] = ((size_t)rand()) % 150;
+                for (size_t j = 0; j < lengths[i]; j++) {
+                    buffers[i][j] = (uint8_t)(rand() & 0xff);
+                }
+                bufferptrs[i] = buffers[i];
+            }
+
+            std::vector<uint8_t> hashes(MAX_LANES * MAX_HASH_SIZE, 0xa5);
+            if (!SimdHashNarrow(algo, narrow, count, lengths, bufferptrs, hashes.data())) {
+                continue;
+            }
+            ASSERT_LT(narrow, SimdLanes());
+
+            for (size_t i = 0; i < count; i++) {
+                uint8_t expected[MAX_HASH_SIZE];
+                SimdHashSingle(algo, lengths[i], bufferptrs[i], expected);
+                ASSERT_EQ(0, memcmp(&hashes[i * digestLen], expected, digestLen))
+                    << "narrow=" << narrow << " count=" << count << " lane=" << i;
+            }
+            for (size_t i = count * digestLen; i < hashes.size(); i++) {
+                ASSERT_EQ(hashes[i], 0xa5) << "narrow=" << narrow << " count=" << count;
+            }
+        }
+    }
+}
+
+TEST(Adaptive, NarrowLanesHoldTheBatch) {
+    for (size_t count = 1; count <= SimdLanes(); count++) {
+        const size_t narrow = GetNarrowLanes(HashAlgorithmMD5, count);
+        if (narrow != 0) {
+            EXPECT_GE(narrow, count);
+            EXPECT_LT(narrow, SimdLanes());
+        }
+    }
+    EXPECT_EQ(0u, GetNarrowLanes(HashAlgorithmSHA512, 1));
+    EXPECT_EQ(0u, GetNarrowLanes(HashAlgorithmMD5, SimdLanes()));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Adaptive, AdaptiveTest,
+    ::testing::Values(
+        HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256,
+        HashAlgorithmSHA512, HashAlgorithmNTLM, HashAlgorithmFNV1a_32
+    ),
+    AlgoName
+);
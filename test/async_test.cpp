@@ -0,0 +1,124 @@
+//
+// async_test.cpp
+// Tests for the coroutine hashing API (simdhash::async_hash)
+//
+
+#include <gtest/gtest.h>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "SimdHashAsync.hpp"
+
+// Minimal eagerly started, self destroying coroutine for the tests
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object(void) { return {}; }
+        std::suspend_never initial_suspend(void) noexcept { return {}; }
+        std::suspend_never final_suspend(void) noexcept { return {}; }
+        void return_void(void) {}
+        void unhandled_exception(void) { std::abort(); }
+    };
+};
+
+class AsyncTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static simdhash::Digest Expected(HashAlgorithm algo, std::span<const uint8_t> input) {
+    simdhash::Digest digest(GetHashWidth(algo));
+    SimdHashSingle(algo, input.size(), input.data(), digest.data());
+    return digest;
+}
+
+static Detached HashOnce(HashAlgorithm algo, std::string input, simdhash::Digest& result) {
+    result = co_await simdhash::async_hash(algo, std::string_view(input));
+}
+
+static Detached HashChain(HashAlgorithm algo, std::vector<uint8_t> seed, size_t rounds, simdhash::Digest& result) {
+    // Hash the previous digest, so each round depends on the last
+    std::vector<uint8_t> value = seed;
+    for (size_t i = 0; i < rounds; i++) {
+        value = co_await simdhash::async_hash(algo, std::span<const uint8_t>(value));
+    }
+    result = value;
+}
+
+TEST_P(AsyncTest, SingleAwait) {
+    const HashAlgorithm algo = GetParam();
+    simdhash::Digest result;
+
+    HashOnce(algo, "hello world", result);
+    EXPECT_TRUE(result.empty());
+    EXPECT_EQ(1u, simdhash::DefaultExecutor().Run());
+
+    const std::string_view input("hello world");
+    EXPECT_EQ(Expected(algo, std::span<const uint8_t>((const uint8_t*)input.data(), input.size())), result);
+}
+
+TEST_P(AsyncTest, ManyCoroutinesAreBatched) {
+    const HashAlgorithm algo = GetParam();
+    const size_t count = 3 * SimdLanes() + 1;
+    const size_t rounds = 4;
+    std::vector<std::vector<uint8_t>> seeds(count);
+    std::vector<simdhash::Digest> results(count);
+    simdhash::HashExecutor& executor = simdhash::DefaultExecutor();
+
+    srand(7);
+    for (size_t i = 0; i < count; i++) {
+        seeds[i].resize(((size_t)rand()) % 100);
+        for (auto& byte : seeds[i]) {
+            byte = (uint8_t)(rand() & 0xff);
+        }
+        HashChain(algo, seeds[i], rounds, results[i]);
+    }
+
+    const size_t groupsBefore = executor.GetGroupCount();
+    EXPECT_EQ(count, executor.GetPendingCount());
+    EXPECT_EQ(count * rounds, executor.Run());
+    EXPECT_EQ(0u, executor.GetPendingCount());
+
+    // Every round fills whole lane groups
+    const size_t groupsPerRound = (count + SimdLanes() - 1) / SimdLanes();
+    EXPECT_EQ(groupsPerRound * rounds, executor.GetGroupCount() - groupsBefore);
+
+    for (size_t i = 0; i < count; i++) {
+        std::vector<uint8_t> expected = seeds[i];
+        for (size_t r = 0; r < rounds; r++) {
+            expected = Expected(algo, expected);
+        }
+        EXPECT_EQ(expected, results[i]) << "index=" << i;
+    }
+}
+
+TEST(Async, MixedAlgorithms) {
+    simdhash::HashExecutor& executor = simdhash::DefaultExecutor();
+    const HashAlgorithm algos[] = { HashAlgorithmMD5, HashAlgorithmSHA256, HashAlgorithmSHA1 };
+    std::vector<simdhash::Digest> results(30);
+    std::vector<std::string> inputs(30);
+
+    for (size_t i = 0; i < results.size(); i++) {
+        inputs[i] = "input" + std::to_string(i);
+        HashOnce(algos[i % 3], inputs[i], results[i]);
+    }
+    EXPECT_EQ(results.size(), executor.Run());
+
+    for (size_t i = 0; i < results.size(); i++) {
+        EXPECT_EQ(Expected(algos[i % 3], std::span<const uint8_t>((const uint8_t*)inputs[i].data(), inputs[i].size())), results[i]);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Async, AsyncTest,
+    ::testing::Values(
+        HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256,
+        HashAlgorithmSHA512, HashAlgorithmNTLM, HashAlgorithmFNV1a_64
+    ),
+    AlgoName
+);
@@ -0,0 +1,72 @@
+//
+// batch_test.cpp
+// Tests for the length bucketed batch scheduler (SimdHashMany)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class BatchTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static void CheckMany(HashAlgorithm algo, size_t count, size_t maxLength, unsigned seed) {
+    const size_t digestLen = GetHashWidth(algo);
+    std::vector<std::vector<uint8_t>> inputs(count);
+    std::vector<const uint8_t*> bufferptrs(count);
+    std::vector<size_t> lengths(count);
+
+    srand(seed);
+    for (size_t i = 0; i < count; i++) {
+        lengths[i] = ((size_t)rand()) % (maxLength + 1);
+        inputs[i].resize(lengths[i] + 1);
+        for (size_t j = 0; j < lengths[i]; j++) {
+            inputs[i][j] = (uint8_t)(rand() & 0xff);
+        }
+        bufferptrs[i] = inputs[i].data();
+    }
+
+    std::vector<uint8_t> hashes(count * digestLen);
+    SimdHashMany(algo, count, lengths.data(), bufferptrs.data(), hashes.data());
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t expected[MAX_HASH_SIZE];
+        SimdHashSingle(algo, lengths[i], bufferptrs[i], expected);
+        ASSERT_EQ(0, memcmp(&hashes[i * digestLen], expected, digestLen))
+            << "count=" << count << " index=" << i << " length=" << lengths[i];
+    }
+}
+
+TEST_P(BatchTest, SmallBatches) {
+    for (size_t count = 0; count <= 3 * MAX_LANES; count++) {
+        CheckMany(GetParam(), count, 130, (unsigned)count);
+    }
+}
+
+TEST_P(BatchTest, LargeShortInputs) {
+    // Exact length buckets on the optimized path
+    CheckMany(GetParam(), 3000, 50, 33);
+}
+
+TEST_P(BatchTest, LargeMixedInputs) {
+    // Block count buckets, including lengths past the last bucket
+    CheckMany(GetParam(), 2000, 20000, 34);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Batch, BatchTest,
+    ::testing::Values(
+        HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256,
+        HashAlgorithmSHA512, HashAlgorithmFNV1a_64
+    ),
+    AlgoName
+);
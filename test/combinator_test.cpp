@@ -0,0 +1,180 @@
+//
+// combinator_test.cpp
+// Tests for the two wordlist combinator generator
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class CombinatorTest : public ::testing::TestWithParam<HashAlgorithm> {
+protected:
+    struct List {
+        std::vector<std::string> Words;
+        std::vector<size_t> Lengths;
+        std::vector<const uint8_t*> Buffers;
+
+        explicit List(std::vector<std::string> words) : Words(std::move(words)) {
+            for (const auto& word : Words) {
+                Lengths.push_back(word.size());
+                Buffers.push_back((const uint8_t*)word.data());
+            }
+        }
+    };
+
+    // Drains [start, start + count) and checks every digest, returning
+    // the candidate indices seen
+    static std::vector<uint64_t> Drain(SimdHashCombinator& combinator, uint64_t start, uint64_t count) {
+        const HashAlgorithm algo = combinator.Algorithm;
+        const size_t digestLen = GetHashWidth(algo);
+        std::vector<uint8_t> hashes(SimdLanes() * digestLen);
+        uint8_t expected[MAX_HASH_SIZE];
+        uint8_t buffer[512];
+        std::vector<uint64_t> seen;
+        SimdHashContext ctx;
+        size_t found;
+
+        SimdHashCombinatorSeek(&combinator, start, count);
+        SimdHashResetContext(&ctx, algo);
+        while ((found = SimdHashCombinatorNext(&combinator, &ctx)) > 0) {
+            SimdHashFinalize(&ctx);
+            SimdHashGetHashes(&ctx, hashes.data());
+            for (size_t lane = 0; lane < found; lane++) {
+                const size_t length = SimdHashCombinatorCandidate(&combinator, combinator.Index[lane], buffer);
+                SimdHashSingle(algo, length, buffer, expected);
+                EXPECT_EQ(memcmp(&hashes[lane * digestLen], expected, digestLen), 0)
+                    << std::string((const char*)buffer, length);
+                seen.push_back(combinator.Index[lane]);
+            }
+            SimdHashResetContext(&ctx, algo);
+        }
+        return seen;
+    }
+};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+TEST_P(CombinatorTest, AllPairs) {
+    List left({ "pass", "", "correct", "horse", std::string(40, 'x') });
+    List right({ "word", "1", "", "battery", "staple", "2024!", std::string(20, 'y') });
+    SimdHashCombinator combinator;
+
+    ASSERT_TRUE(SimdHashCombinatorInit(&combinator, GetParam(),
+        left.Words.size(), left.Lengths.data(), left.Buffers.data(),
+        right.Words.size(), right.Lengths.data(), right.Buffers.data(),
+        "-", 0, SIZE_MAX));
+    EXPECT_EQ(combinator.Keyspace, 35u);
+
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < combinator.Keyspace; i++) {
+        expected.push_back(i);
+    }
+    EXPECT_EQ(Drain(combinator, 0, UINT64_MAX), expected);
+}
+
+TEST_P(CombinatorTest, TailsPastOneBlock) {
+    // Tails from 55 bytes up to several blocks past the prefix tail
+    List left({ std::string(50, 'a'), std::string(63, 'b'), std::string(100, 'c'), "" });
+    List right({ "12345678", "", "x", std::string(14, 'y'), std::string(64, 'z'), std::string(150, 'w') });
+    SimdHashCombinator combinator;
+
+    ASSERT_TRUE(SimdHashCombinatorInit(&combinator, GetParam(),
+        left.Words.size(), left.Lengths.data(), left.Buffers.data(),
+        right.Words.size(), right.Lengths.data(), right.Buffers.data(),
+        nullptr, 0, SIZE_MAX));
+
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < combinator.Keyspace; i++) {
+        expected.push_back(i);
+    }
+    EXPECT_EQ(Drain(combinator, 0, UINT64_MAX), expected);
+}
+
+TEST_P(CombinatorTest, LengthLimits) {
+    List left({ "a", "bb", "ccc", "dddd" });
+    List right({ "1", "22", "333", "4444", "55555" });
+    SimdHashCombinator combinator;
+
+    ASSERT_TRUE(SimdHashCombinatorInit(&combinator, GetParam(),
+        left.Words.size(), left.Lengths.data(), left.Buffers.data(),
+        right.Words.size(), right.Lengths.data(), right.Buffers.data(),
+        nullptr, 4, 6));
+
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < combinator.Keyspace; i++) {
+        const size_t length = left.Lengths[i / 5] + right.Lengths[i % 5];
+        if (length >= 4 && length <= 6) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(Drain(combinator, 0, UINT64_MAX), expected);
+}
+
+TEST_P(CombinatorTest, MidstatePrefix) {
+    // Prefixes of one and two full blocks plus a tail
+    List left({ std::string(64, 'a'), std::string(70, 'b'), std::string(130, 'c'), "d" });
+    std::vector<std::string> words;
+    for (size_t i = 0; i < 50; i++) {
+        words.push_back(std::to_string(i * 7919));
+    }
+    List right(words);
+    SimdHashCombinator combinator;
+
+    ASSERT_TRUE(SimdHashCombinatorInit(&combinator, GetParam(),
+        left.Words.size(), left.Lengths.data(), left.Buffers.data(),
+        right.Words.size(), right.Lengths.data(), right.Buffers.data(),
+        ":", 0, SIZE_MAX));
+    EXPECT_EQ(Drain(combinator, 0, UINT64_MAX).size(), combinator.Keyspace);
+}
+
+TEST_P(CombinatorTest, Partitions) {
+    std::vector<std::string> leftWords, rightWords;
+    for (size_t i = 0; i < 30; i++) {
+        leftWords.push_back(std::string(i % 9, (char)('a' + i % 26)));
+        rightWords.push_back(std::to_string(i * i));
+    }
+    List left(leftWords);
+    List right(rightWords);
+    SimdHashCombinator combinator;
+
+    ASSERT_TRUE(SimdHashCombinatorInit(&combinator, GetParam(),
+        left.Words.size(), left.Lengths.data(), left.Buffers.data(),
+        right.Words.size(), right.Lengths.data(), right.Buffers.data(),
+        nullptr, 0, SIZE_MAX));
+
+    std::vector<uint64_t> seen;
+    for (uint64_t start = 0; start < combinator.Keyspace; start += 37) {
+        for (uint64_t index : Drain(combinator, start, 37)) {
+            EXPECT_GE(index, start);
+            EXPECT_LT(index, start + 37);
+            seen.push_back(index);
+        }
+    }
+    EXPECT_EQ(seen.size(), combinator.Keyspace);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Algorithms,
+    CombinatorTest,
+    ::testing::Values(HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256),
+    AlgoName
+);
+
+TEST(Combinator, Unsupported) {
+    SimdHashCombinator combinator;
+    EXPECT_FALSE(SimdHashCombinatorInit(&combinator, HashAlgorithmNTLM, 0, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0));
+    EXPECT_FALSE(SimdHashCombinatorInit(&combinator, HashAlgorithmSHA512, 0, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0));
+
+    SimdHashContext ctx;
+    ASSERT_TRUE(SimdHashCombinatorInit(&combinator, HashAlgorithmMD5, 0, nullptr, nullptr, 0, nullptr, nullptr, nullptr, 0, 0));
+    SimdHashResetContext(&ctx, HashAlgorithmMD5);
+    EXPECT_EQ(SimdHashCombinatorNext(&combinator, &ctx), 0u);
+}
@@ -0,0 +1,251 @@
+//
+// compressed_test.cpp
+// Tests for the pipelined plain, gzip and zstd wordlist reader
+//
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#ifdef SIMDHASH_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SIMDHASH_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+extern "C" {
+#include "simdhash.h"
+}
+
+static std::string RandomWordlist(size_t lines, size_t maxLength, unsigned seed, std::vector<std::string>& expected) {
+    std::string data;
+    srand(seed);
+    for (size_t i = 0; i < lines; i++) {
+        std::string line;
+        const size_t length = 1 + ((size_t)rand()) % maxLength;
+        for (size_t j = 0; j < length; j++) {
+            line.push_back((char)('0' + rand() % 75));
+        }
+        expected.push_back(line);
+        data += line;
+        data += (rand() % 3 == 0) ? "\r\n" : "\n";
+    }
+    return data;
+}
+
+class CompressedTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/simdhash_compressed_XXXXXX";
+        const int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        m_Path = path;
+    }
+    void TearDown() override { unlink(m_Path.c_str()); }
+
+    void WriteFile(const std::string& data) {
+        FILE* file = fopen(m_Path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        fwrite(data.data(), 1, data.size(), file);
+        fclose(file);
+    }
+
+    // Drains the reader from several threads, returning every line seen
+    std::vector<std::string> ReadAll(SimdHashCompressedReader* reader, size_t threads) {
+        std::vector<std::string> lines;
+        std::mutex lock;
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&]() {
+                const size_t lanes = SimdLanes();
+                std::vector<size_t> lengths(lanes);
+                std::vector<const uint8_t*> buffers(lanes);
+                SimdHashInputBlock* block;
+                while ((block = SimdHashCompressedAcquire(reader)) != nullptr) {
+                    size_t found;
+                    while ((found = SimdHashLineSplitterNext(&block->Splitter, lanes, lengths.data(), buffers.data())) > 0) {
+                        std::lock_guard<std::mutex> guard(lock);
+                        for (size_t i = 0; i < found; i++) {
+                            lines.emplace_back((const char*)buffers[i], lengths[i]);
+                        }
+                    }
+                    SimdHashCompressedRelease(reader, block);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return lines;
+    }
+
+    void CheckReader(const std::vector<std::string>& expected, size_t blockSize, size_t threads) {
+        SimdHashCompressedReader* reader = SimdHashCompressedOpen(m_Path.c_str(), 0, SIZE_MAX, 4, blockSize);
+        ASSERT_NE(reader, nullptr);
+        auto lines = ReadAll(reader, threads);
+        EXPECT_FALSE(SimdHashCompressedFailed(reader));
+        SimdHashCompressedClose(reader);
+
+        auto sorted = expected;
+        std::sort(lines.begin(), lines.end());
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_EQ(lines, sorted);
+    }
+
+    std::string m_Path;
+};
+
+TEST_F(CompressedTest, Plain) {
+    std::vector<std::string> expected;
+    WriteFile(RandomWordlist(20000, 30, 1, expected));
+    CheckReader(expected, 256, 1);
+    CheckReader(expected, 4096, 4);
+}
+
+TEST_F(CompressedTest, OverlongLinesDropped) {
+    // Lines that cannot fit in a block are skipped whole, including one
+    // at the start, one of exactly a block and one ending the file
+    const size_t blockSize = 64;
+    std::vector<std::string> expected;
+    std::string data = std::string(200, 'a') + "\n";
+    for (size_t i = 0; i < 50; i++) {
+        const std::string word = "word" + std::to_string(i);
+        expected.push_back(word);
+        data += word + "\n";
+        if (i % 10 == 3) {
+            data += std::string(blockSize * (1 + i % 3), 'x') + "\n";
+        }
+        if (i == 20) {
+            data += std::string(blockSize, 'y') + "\r\n";
+        }
+    }
+    data += std::string(150, 'z');
+    WriteFile(data);
+    CheckReader(expected, blockSize, 1);
+    CheckReader(expected, blockSize, 3);
+}
+
+TEST_F(CompressedTest, OrderWithOneConsumer) {
+    std::vector<std::string> expected;
+    WriteFile(RandomWordlist(5000, 40, 2, expected));
+
+    SimdHashCompressedReader* reader = SimdHashCompressedOpen(m_Path.c_str(), 0, SIZE_MAX, 2, 300);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(ReadAll(reader, 1), expected);
+    SimdHashCompressedClose(reader);
+}
+
+TEST_F(CompressedTest, HashLaneGroups) {
+    std::vector<std::string> expected;
+    WriteFile(RandomWordlist(3000, MAX_OPTIMIZED_BUFFER_SIZE, 3, expected));
+
+    SimdHashCompressedReader* reader = SimdHashCompressedOpen(m_Path.c_str(), 0, MAX_OPTIMIZED_BUFFER_SIZE, 3, 1024);
+    ASSERT_NE(reader, nullptr);
+
+    const size_t lanes = SimdLanes();
+    std::vector<size_t> lengths(lanes);
+    std::vector<const uint8_t*> buffers(lanes);
+    std::vector<uint8_t> hashes(lanes * MD5_SIZE);
+    uint8_t single[MD5_SIZE];
+    size_t index = 0;
+    SimdHashInputBlock* block;
+
+    while ((block = SimdHashCompressedAcquire(reader)) != nullptr) {
+        size_t found;
+        while ((found = SimdHashLineSplitterNext(&block->Splitter, lanes, lengths.data(), buffers.data())) > 0) {
+            SimdHashOptimized(HashAlgorithmMD5, lengths.data(), buffers.data(), hashes.data());
+            for (size_t lane = 0; lane < found; lane++, index++) {
+                ASSERT_LT(index, expected.size());
+                SimdHashSingle(HashAlgorithmMD5, expected[index].size(), (const uint8_t*)expected[index].data(), single);
+                ASSERT_EQ(memcmp(&hashes[lane * MD5_SIZE], single, MD5_SIZE), 0) << expected[index];
+            }
+        }
+        SimdHashCompressedRelease(reader, block);
+    }
+    EXPECT_EQ(index, expected.size());
+    SimdHashCompressedClose(reader);
+}
+
+TEST_F(CompressedTest, CloseEarly) {
+    std::vector<std::string> expected;
+    WriteFile(RandomWordlist(50000, 20, 4, expected));
+
+    SimdHashCompressedReader* reader = SimdHashCompressedOpen(m_Path.c_str(), 0, SIZE_MAX, 2, 128);
+    ASSERT_NE(reader, nullptr);
+    SimdHashInputBlock* block = SimdHashCompressedAcquire(reader);
+    ASSERT_NE(block, nullptr);
+    SimdHashCompressedRelease(reader, block);
+    SimdHashCompressedClose(reader);
+}
+
+TEST_F(CompressedTest, Missing) {
+    EXPECT_EQ(SimdHashCompressedOpen("/nonexistent/simdhash/wordlist.gz", 0, SIZE_MAX, 4, 4096), nullptr);
+    EXPECT_EQ(SimdHashCompressedOpen(m_Path.c_str(), 0, SIZE_MAX, 4, 0), nullptr);
+}
+
+#ifdef SIMDHASH_HAVE_ZLIB
+TEST_F(CompressedTest, Gzip) {
+    std::vector<std::string> expected;
+    const std::string data = RandomWordlist(20000, 30, 5, expected);
+
+    gzFile file = gzopen(m_Path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    gzwrite(file, data.data(), (unsigned)data.size());
+    gzclose(file);
+
+    CheckReader(expected, 512, 1);
+    CheckReader(expected, 8192, 3);
+}
+
+TEST_F(CompressedTest, CorruptGzip) {
+    std::vector<std::string> expected;
+    const std::string data = RandomWordlist(20000, 30, 6, expected);
+
+    gzFile file = gzopen(m_Path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    gzwrite(file, data.data(), (unsigned)data.size());
+    gzclose(file);
+
+    // Flip bytes in the middle of the deflate stream
+    FILE* raw = fopen(m_Path.c_str(), "r+b");
+    ASSERT_NE(raw, nullptr);
+    fseek(raw, 0, SEEK_END);
+    const long size = ftell(raw);
+    fseek(raw, size / 2, SEEK_SET);
+    const uint8_t garbage[16] = { 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00,
+                                  0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00 };
+    fwrite(garbage, 1, sizeof(garbage), raw);
+    fclose(raw);
+
+    SimdHashCompressedReader* reader = SimdHashCompressedOpen(m_Path.c_str(), 0, SIZE_MAX, 4, 1024);
+    ASSERT_NE(reader, nullptr);
+    ReadAll(reader, 2);
+    EXPECT_TRUE(SimdHashCompressedFailed(reader));
+    SimdHashCompressedClose(reader);
+}
+#endif
+
+#ifdef SIMDHASH_HAVE_ZSTD
+TEST_F(CompressedTest, Zstd) {
+    std::vector<std::string> expected;
+    const std::string data = RandomWordlist(20000, 30, 7, expected);
+    std::string compressed(ZSTD_compressBound(data.size()), '\0');
+    const size_t size = ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), 3);
+    ASSERT_FALSE(ZSTD_isError(size));
+    compressed.resize(size);
+    WriteFile(compressed);
+
+    CheckReader(expected, 512, 1);
+    CheckReader(expected, 8192, 3);
+}
+#endif
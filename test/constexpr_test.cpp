@@ -0,0 +1,157 @@
+//
+// constexpr_test.cpp
+// Tests for the compile time hash functions in SimdHash.hpp
+//
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "SimdHash.hpp"
+
+using namespace simdhash::literals;
+
+// Evaluated by the compiler
+static_assert(simdhash::constant::Fnv1a_64(std::string_view("")) == 0xcbf29ce484222325ULL);
+static_assert(simdhash::constant::Fnv1a_32(std::string_view("a")) == 0xe40c292c);
+static_assert("a"_fnv1a_64 == 0xaf63dc4c8601ec8cULL);
+static_assert("abc"_md5[0] == 0x90 && "abc"_md5[15] == 0x72);
+static_assert("abc"_sha1[0] == 0xa9 && "abc"_sha1[19] == 0x9d);
+static_assert("abc"_sha256[0] == 0xba && "abc"_sha256[31] == 0xad);
+
+static std::string TestString(size_t length) {
+    std::string s(length, '\0');
+    for (size_t i = 0; i < length; i++) {
+        s[i] = (char)((i * 131 + length * 7) & 0xff);
+    }
+    return s;
+}
+
+template <size_t N>
+static void ExpectRuntime(HashAlgorithm algo, const std::string& input, const std::array<uint8_t, N>& value) {
+    uint8_t expected[MAX_HASH_SIZE];
+    ASSERT_EQ(GetHashWidth(algo), N);
+    SimdHashSingle(algo, input.size(), (const uint8_t*)input.data(), expected);
+    EXPECT_EQ(0, memcmp(expected, value.data(), N)) << HashAlgorithmToString(algo) << " length=" << input.size();
+}
+
+template <typename T>
+static std::array<uint8_t, sizeof(T)> IntegerBytes(T value) {
+    std::array<uint8_t, sizeof(T)> bytes;
+    memcpy(bytes.data(), &value, sizeof(T));
+    return bytes;
+}
+
+TEST(Constexpr, FnvMatchesScalar) {
+    for (size_t length = 0; length < 100; length++) {
+        const std::string input = TestString(length);
+        const uint8_t* data = (const uint8_t*)input.data();
+        uint32_t hash32;
+        uint64_t hash64;
+
+        Fnv1_32Single(data, length, (uint8_t*)&hash32);
+        EXPECT_EQ(hash32, simdhash::constant::Fnv1_32(input));
+        Fnv1a_32Single(data, length, (uint8_t*)&hash32);
+        EXPECT_EQ(hash32, simdhash::constant::Fnv1a_32(input));
+        Fnv1_64Single(data, length, (uint8_t*)&hash64);
+        EXPECT_EQ(hash64, simdhash::constant::Fnv1_64(input));
+        Fnv1a_64Single(data, length, (uint8_t*)&hash64);
+        EXPECT_EQ(hash64, simdhash::constant::Fnv1a_64(input));
+    }
+}
+
+TEST(Constexpr, FnvMatchesSingle) {
+    for (size_t length = 0; length < 100; length += 3) {
+        const std::string input = TestString(length);
+        ExpectRuntime(HashAlgorithmFNV1_32, input, IntegerBytes(simdhash::constant::Fnv1_32(input)));
+        ExpectRuntime(HashAlgorithmFNV1a_32, input, IntegerBytes(simdhash::constant::Fnv1a_32(input)));
+        ExpectRuntime(HashAlgorithmFNV1_64, input, IntegerBytes(simdhash::constant::Fnv1_64(input)));
+        ExpectRuntime(HashAlgorithmFNV1a_64, input, IntegerBytes(simdhash::constant::Fnv1a_64(input)));
+    }
+}
+
+TEST(Constexpr, DigestsMatchRuntime) {
+    // Covers the one and two block padding boundaries
+    for (size_t length = 0; length < 200; length++) {
+        const std::string input = TestString(length);
+        ExpectRuntime(HashAlgorithmMD5, input, simdhash::constant::Md5(input));
+        ExpectRuntime(HashAlgorithmSHA1, input, simdhash::constant::Sha1(input));
+        ExpectRuntime(HashAlgorithmSHA256, input, simdhash::constant::Sha256(input));
+    }
+}
+
+template <typename Function>
+static void ExpectSimdBatch(HashAlgorithm algo, size_t maxLength, Function constant) {
+    // Every lane has a different length so the SIMD kernels see a mix of
+    // block counts and padding positions in one batch
+    const size_t lanes = SimdLanes();
+    const size_t width = GetHashWidth(algo);
+    std::string inputs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+
+    for (size_t first = 0; first <= maxLength; first += lanes) {
+        for (size_t lane = 0; lane < lanes; lane++) {
+            inputs[lane] = TestString((first + lane * 7) % (maxLength + 1));
+            lengths[lane] = inputs[lane].size();
+            buffers[lane] = (const uint8_t*)inputs[lane].data();
+        }
+
+        SimdHash(algo, lengths, buffers, hashes);
+        for (size_t lane = 0; lane < lanes; lane++) {
+            const auto expected = constant(inputs[lane]);
+            ASSERT_EQ(width, expected.size());
+            EXPECT_EQ(0, memcmp(&hashes[lane * width], expected.data(), width))
+                << HashAlgorithmToString(algo) << " length=" << lengths[lane];
+        }
+
+        size_t longest = 0;
+        for (size_t lane = 0; lane < lanes; lane++) {
+            longest = lengths[lane] > longest ? lengths[lane] : longest;
+        }
+        if (SupportsOptimization(algo) && longest <= GetOptimizedTwoBlockLength(algo)) {
+            SimdHashOptimized(algo, lengths, buffers, hashes);
+            for (size_t lane = 0; lane < lanes; lane++) {
+                EXPECT_EQ(0, memcmp(&hashes[lane * width], constant(inputs[lane]).data(), width))
+                    << HashAlgorithmToString(algo) << " optimized length=" << lengths[lane];
+            }
+        }
+    }
+}
+
+TEST(Constexpr, MatchesSimdKernels) {
+    using namespace simdhash::constant;
+    ExpectSimdBatch(HashAlgorithmMD5, 200, [](const std::string& s) { return Md5(s); });
+    ExpectSimdBatch(HashAlgorithmSHA1, 200, [](const std::string& s) { return Sha1(s); });
+    ExpectSimdBatch(HashAlgorithmSHA256, 200, [](const std::string& s) { return Sha256(s); });
+    ExpectSimdBatch(HashAlgorithmFNV1_32, 100, [](const std::string& s) { return IntegerBytes(Fnv1_32(s)); });
+    ExpectSimdBatch(HashAlgorithmFNV1a_32, 100, [](const std::string& s) { return IntegerBytes(Fnv1a_32(s)); });
+    ExpectSimdBatch(HashAlgorithmFNV1_64, 100, [](const std::string& s) { return IntegerBytes(Fnv1_64(s)); });
+    ExpectSimdBatch(HashAlgorithmFNV1a_64, 100, [](const std::string& s) { return IntegerBytes(Fnv1a_64(s)); });
+}
+
+TEST(Constexpr, LiteralsMatchRuntime) {
+    constexpr auto md5 = "The quick brown fox jumps over the lazy dog"_md5;
+    constexpr auto sha1 = "The quick brown fox jumps over the lazy dog"_sha1;
+    constexpr auto sha256 = "The quick brown fox jumps over the lazy dog"_sha256;
+    constexpr uint64_t fnv = "metric.requests.total"_fnv1a_64;
+    const std::string fox = "The quick brown fox jumps over the lazy dog";
+
+    ExpectRuntime(HashAlgorithmMD5, fox, md5);
+    ExpectRuntime(HashAlgorithmSHA1, fox, sha1);
+    ExpectRuntime(HashAlgorithmSHA256, fox, sha256);
+    ExpectRuntime(HashAlgorithmFNV1a_64, "metric.requests.total", IntegerBytes(fnv));
+
+    // Usable as a case label
+    switch (simdhash::constant::Fnv1a_64(std::string_view("dispatch.key"))) {
+    case "dispatch.key"_fnv1a_64:
+        break;
+    default:
+        FAIL();
+    }
+}
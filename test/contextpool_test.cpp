@@ -0,0 +1,165 @@
+//
+// contextpool_test.cpp
+// Tests for the thread local context pool and its RAII handle
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simdhash.h"
+#include "SimdHash.hpp"
+
+class ContextPoolTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static void HashAndCheck(SimdHashContext* ctx, HashAlgorithm algo, const std::string& prefix) {
+    const size_t digestLen = GetHashWidth(algo);
+    std::vector<std::string> inputs(SimdLanes());
+    std::vector<size_t> lengths(SimdLanes());
+    std::vector<const uint8_t*> buffers(SimdLanes());
+    std::vector<uint8_t> hashes(SimdLanes() * digestLen);
+    uint8_t expected[MAX_HASH_SIZE];
+
+    for (size_t lane = 0; lane < SimdLanes(); lane++) {
+        inputs[lane] = prefix + std::string(lane * 5, (char)('a' + lane));
+        lengths[lane] = inputs[lane].size();
+        buffers[lane] = (const uint8_t*)inputs[lane].data();
+    }
+
+    SimdHashUpdate(ctx, lengths.data(), buffers.data());
+    SimdHashFinalize(ctx);
+    SimdHashGetHashes(ctx, hashes.data());
+
+    for (size_t lane = 0; lane < SimdLanes(); lane++) {
+        SimdHashSingle(algo, lengths[lane], buffers[lane], expected);
+        ASSERT_EQ(memcmp(&hashes[lane * digestLen], expected, digestLen), 0) << "lane " << lane;
+    }
+}
+
+TEST_P(ContextPoolTest, ResetMatchesInit) {
+    const HashAlgorithm algo = GetParam();
+    SimdHashContext init;
+    SimdHashContext reset;
+
+    SimdHashInit(&init, algo);
+    memset(&reset, 0xa5, sizeof(reset));
+    SimdHashResetContext(&reset, algo);
+
+    EXPECT_EQ(reset.Algorithm, init.Algorithm);
+    EXPECT_EQ(reset.HSize, init.HSize);
+    EXPECT_EQ(reset.Lanes, init.Lanes);
+    if (algo == HashAlgorithmSHA384 || algo == HashAlgorithmSHA512) {
+        // The OpenSSL data block is left uninitialised, compare the state
+        for (size_t lane = 0; lane < init.Lanes; lane++) {
+            EXPECT_EQ(memcmp(reset.ShaCtx[lane].h, init.ShaCtx[lane].h, sizeof(init.ShaCtx[lane].h)), 0);
+            EXPECT_EQ(reset.ShaCtx[lane].Nl, init.ShaCtx[lane].Nl);
+            EXPECT_EQ(reset.ShaCtx[lane].num, init.ShaCtx[lane].num);
+            EXPECT_EQ(reset.ShaCtx[lane].md_len, init.ShaCtx[lane].md_len);
+        }
+    } else {
+        EXPECT_EQ(reset.HashSize, init.HashSize);
+        EXPECT_EQ(memcmp(reset.H, init.H, init.HSize * sizeof(init.H[0])), 0);
+        EXPECT_EQ(reset.BufferSize, init.BufferSize);
+        EXPECT_EQ(memcmp(reset.Buffer, init.Buffer, sizeof(init.Buffer)), 0);
+        EXPECT_EQ(memcmp(reset.Offset, init.Offset, sizeof(init.Offset)), 0);
+        EXPECT_EQ(memcmp(reset.BitLength, init.BitLength, sizeof(init.BitLength)), 0);
+    }
+}
+
+TEST_P(ContextPoolTest, AcquireHashReset) {
+    const HashAlgorithm algo = GetParam();
+    SimdHashContext* ctx = SimdHashAcquireContext(algo);
+
+    ASSERT_NE(ctx, nullptr);
+    EXPECT_EQ(((uintptr_t)ctx) % 64, 0u);
+    HashAndCheck(ctx, algo, "first");
+    SimdHashResetContext(ctx, algo);
+    HashAndCheck(ctx, algo, "a much longer second prefix that spills into another block ");
+    SimdHashReleaseContext(ctx);
+}
+
+TEST_P(ContextPoolTest, Handle) {
+    const HashAlgorithm algo = GetParam();
+    SimdHashContext* first;
+    {
+        simdhash::PooledContext ctx(algo);
+        first = ctx.Get();
+        HashAndCheck(ctx, algo, "handle");
+        ctx.Reset();
+        HashAndCheck(ctx, algo, "again");
+    }
+
+    // The released context is the next one handed out
+    simdhash::PooledContext ctx(algo);
+    EXPECT_EQ(ctx.Get(), first);
+    EXPECT_EQ(ctx->Algorithm, algo);
+    HashAndCheck(ctx, algo, "reused");
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Algorithms,
+    ContextPoolTest,
+    ::testing::ValuesIn(simdhash::SimdHashAlgorithms),
+    AlgoName
+);
+
+TEST(ContextPool, ExhaustPool) {
+    std::vector<SimdHashContext*> contexts;
+    std::set<SimdHashContext*> unique;
+
+    for (size_t i = 0; i < 40; i++) {
+        SimdHashContext* ctx = SimdHashAcquireContext(HashAlgorithmMD5);
+        ASSERT_NE(ctx, nullptr);
+        EXPECT_EQ(((uintptr_t)ctx) % 64, 0u);
+        contexts.push_back(ctx);
+        unique.insert(ctx);
+    }
+    EXPECT_EQ(unique.size(), contexts.size());
+
+    HashAndCheck(contexts.back(), HashAlgorithmMD5, "overflow");
+    for (auto* ctx : contexts) {
+        SimdHashReleaseContext(ctx);
+    }
+    SimdHashReleaseContext(nullptr);
+}
+
+TEST(ContextPool, MoveHandle) {
+    simdhash::PooledContext a(HashAlgorithmSHA1);
+    SimdHashContext* raw = a.Get();
+    simdhash::PooledContext b(std::move(a));
+
+    EXPECT_EQ(a.Get(), nullptr);
+    EXPECT_EQ(b.Get(), raw);
+    b.Reset(HashAlgorithmSHA256);
+    HashAndCheck(b, HashAlgorithmSHA256, "moved");
+}
+
+TEST(ContextPool, ThreadLocal) {
+    SimdHashContext* mine = SimdHashAcquireContext(HashAlgorithmSHA256);
+    std::vector<std::thread> threads;
+    std::vector<SimdHashContext*> theirs(4);
+
+    for (size_t t = 0; t < theirs.size(); t++) {
+        threads.emplace_back([&theirs, t]() {
+            simdhash::PooledContext ctx(HashAlgorithmSHA256);
+            theirs[t] = ctx.Get();
+            HashAndCheck(ctx, HashAlgorithmSHA256, "thread" + std::to_string(t));
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto* ctx : theirs) {
+        EXPECT_NE(ctx, mine);
+    }
+    SimdHashReleaseContext(mine);
+}
@@ -0,0 +1,141 @@
+//
+// encode_test.cpp
+// Tests for the hex and base64 digest encoders
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+static std::string ReferenceHex(const uint8_t* data, size_t length, bool upper) {
+    const char* alphabet = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < length; i++) {
+        out += alphabet[data[i] >> 4];
+        out += alphabet[data[i] & 0xf];
+    }
+    return out;
+}
+
+static std::string ReferenceBase64(const uint8_t* data, size_t length) {
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        uint32_t v = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out += alphabet[(v >> 18) & 63];
+        out += alphabet[(v >> 12) & 63];
+        out += alphabet[(v >> 6) & 63];
+        out += alphabet[v & 63];
+    }
+    if (length - i == 1) {
+        uint32_t v = data[i] << 16;
+        out += alphabet[(v >> 18) & 63];
+        out += alphabet[(v >> 12) & 63];
+        out += "==";
+    } else if (length - i == 2) {
+        uint32_t v = (data[i] << 16) | (data[i + 1] << 8);
+        out += alphabet[(v >> 18) & 63];
+        out += alphabet[(v >> 12) & 63];
+        out += alphabet[(v >> 6) & 63];
+        out += '=';
+    }
+    return out;
+}
+
+static std::vector<uint8_t> RandomBytes(size_t length, unsigned seed) {
+    std::vector<uint8_t> bytes(length);
+    srand(seed);
+    for (auto& b : bytes) {
+        b = (uint8_t)(rand() & 0xff);
+    }
+    return bytes;
+}
+
+TEST(Encode, HexMatchesReference) {
+    for (size_t len = 0; len <= 100; len++) {
+        auto bytes = RandomBytes(len, (unsigned)len);
+        for (bool upper : {false, true}) {
+            std::string out(len * 2, '\0');
+            ASSERT_EQ(SimdHashEncodeHex(bytes.data(), len, out.data(), upper), len * 2);
+            EXPECT_EQ(out, ReferenceHex(bytes.data(), len, upper)) << "Length " << len;
+        }
+    }
+}
+
+TEST(Encode, Base64MatchesReference) {
+    EXPECT_EQ(ReferenceBase64((const uint8_t*)"foobar", 6), "Zm9vYmFy");
+    for (size_t len = 0; len <= 100; len++) {
+        auto bytes = RandomBytes(len, (unsigned)len + 1000);
+        std::string out(SimdHashBase64Stride(len), '\0');
+        const size_t written = SimdHashEncodeBase64(bytes.data(), len, out.data());
+        ASSERT_EQ(written + 1, SimdHashBase64Stride(len));
+        out.resize(written);
+        EXPECT_EQ(out, ReferenceBase64(bytes.data(), len)) << "Length " << len;
+    }
+}
+
+TEST(Encode, HexDecodeRoundTrip) {
+    for (size_t len = 0; len <= 100; len++) {
+        auto bytes = RandomBytes(len, (unsigned)len + 2000);
+        for (bool upper : {false, true}) {
+            std::string hex = ReferenceHex(bytes.data(), len, upper);
+            std::vector<uint8_t> decoded(len);
+            ASSERT_EQ(SimdHashDecodeHex(hex.data(), hex.size(), decoded.data()), len);
+            EXPECT_EQ(decoded, bytes) << "Length " << len;
+        }
+    }
+}
+
+TEST(Encode, HexDecodeRejectsInvalid) {
+    std::string hex = ReferenceHex(RandomBytes(32, 7).data(), 32, false);
+    std::vector<uint8_t> decoded(32);
+    EXPECT_EQ(SimdHashDecodeHex(hex.data(), hex.size() - 1, decoded.data()), (size_t)-1);
+    // Every position, covering both the vector and scalar tails
+    for (size_t pos = 0; pos < hex.size(); pos++) {
+        for (char bad : {'g', 'G', '/', ':', '@', '`', ' ', '\x80'}) {
+            std::string broken = hex;
+            broken[pos] = bad;
+            EXPECT_EQ(SimdHashDecodeHex(broken.data(), broken.size(), decoded.data()), (size_t)-1)
+                << "Position " << pos << " char " << (int)bad;
+        }
+    }
+}
+
+TEST(Encode, ContextBatches) {
+    const HashAlgorithm algos[] = {HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256};
+    const char* input = "The quick brown fox jumps over the lazy dog";
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+    for (size_t i = 0; i < SimdLanes(); i++) {
+        bufferptrs[i] = (const uint8_t*)input;
+        lengths[i] = strlen(input) - i;
+    }
+
+    for (HashAlgorithm algo : algos) {
+        const size_t hashSize = GetHashWidth(algo);
+        SimdHashContext ctx;
+        SimdHashInit(&ctx, algo);
+        SimdHashUpdate(&ctx, lengths, bufferptrs);
+        SimdHashFinalize(&ctx);
+
+        std::vector<char> hex(SimdHashHexStride(hashSize) * MAX_LANES);
+        std::vector<char> b64(SimdHashBase64Stride(hashSize) * MAX_LANES);
+        SimdHashGetHashesHex(&ctx, hex.data(), false);
+        SimdHashGetHashesBase64(&ctx, b64.data());
+
+        for (size_t i = 0; i < SimdLanes(); i++) {
+            uint8_t expected[MAX_HASH_SIZE];
+            SimdHashSingle(algo, lengths[i], bufferptrs[i], expected);
+            EXPECT_EQ(std::string(&hex[i * SimdHashHexStride(hashSize)]), ReferenceHex(expected, hashSize, false));
+            EXPECT_EQ(std::string(&b64[i * SimdHashBase64Stride(hashSize)]), ReferenceBase64(expected, hashSize));
+        }
+    }
+}
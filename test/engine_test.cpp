@@ -0,0 +1,123 @@
+//
+// engine_test.cpp
+// Tests for the header-only ISA parameterised engine (simdhash::Engine)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "SimdHashEngine.hpp"
+
+template <typename T>
+class EngineTest : public ::testing::Test {};
+
+template <typename Isa, HashAlgorithm Algorithm>
+struct Config
+{
+    using IsaType = Isa;
+    static constexpr HashAlgorithm Value = Algorithm;
+};
+
+#define ENGINE_CONFIGS(Isa) \
+    Config<Isa, HashAlgorithmMD4>, Config<Isa, HashAlgorithmMD5>, \
+    Config<Isa, HashAlgorithmSHA1>, Config<Isa, HashAlgorithmSHA256>
+
+// Every instruction set the translation unit is compiled for, side by side
+using Configs = ::testing::Types<
+    ENGINE_CONFIGS(simdhash::isa::Library),
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    ENGINE_CONFIGS(simdhash::isa::Avx512),
+#endif
+#if defined(__AVX2__)
+    ENGINE_CONFIGS(simdhash::isa::Avx2),
+#endif
+#if defined(__SSE2__)
+    ENGINE_CONFIGS(simdhash::isa::Sse2),
+#endif
+#if defined(__ARM_NEON)
+    ENGINE_CONFIGS(simdhash::isa::Neon),
+#endif
+    ENGINE_CONFIGS(simdhash::isa::Scalar)
+>;
+TYPED_TEST_SUITE(EngineTest, Configs);
+
+TYPED_TEST(EngineTest, HashMatchesRuntime) {
+    using Engine = simdhash::Engine<typename TypeParam::IsaType, TypeParam::Value>;
+    const size_t lanes = Engine::Lanes;
+
+    srand(11);
+    for (size_t round = 0; round < 50; round++) {
+        std::vector<std::vector<uint8_t>> inputs(lanes);
+        std::vector<size_t> lengths(lanes);
+        std::vector<const uint8_t*> buffers(lanes);
+        // Alternate uniform and mixed lengths, up to four blocks
+        const size_t uniform = ((size_t)rand()) % 250;
+        for (size_t lane = 0; lane < lanes; lane++) {
+            lengths[lane] = round % 2 ? uniform : ((size_t)rand()) % 250;
+            inputs[lane].resize(lengths[lane] + 1);
+            for (auto& byte : inputs[lane]) {
+                byte = (uint8_t)(rand() & 0xff);
+            }
+            buffers[lane] = inputs[lane].data();
+        }
+
+        std::vector<uint8_t> hashes(lanes * Engine::DigestSize);
+        Engine::Hash(lengths.data(), buffers.data(), hashes.data());
+
+        for (size_t lane = 0; lane < lanes; lane++) {
+            uint8_t expected[MAX_HASH_SIZE];
+            SimdHashSingle(TypeParam::Value, lengths[lane], buffers[lane], expected);
+            ASSERT_EQ(0, memcmp(expected, &hashes[lane * Engine::DigestSize], Engine::DigestSize))
+                << "round=" << round << " lane=" << lane << " length=" << lengths[lane];
+        }
+    }
+}
+
+TYPED_TEST(EngineTest, InlineGeneratorLoop) {
+    // Builds single block candidates directly in lane layout and drives
+    // Transform, as a cracking loop would
+    using Engine = simdhash::Engine<typename TypeParam::IsaType, TypeParam::Value>;
+    using Isa = typename TypeParam::IsaType;
+    const size_t lanes = Engine::Lanes;
+    const size_t length = 6;
+
+    for (uint32_t base = 0; base < 4; base++) {
+        std::vector<std::string> candidates(lanes);
+        alignas(64) uint32_t words[16][Engine::Lanes] = {};
+        for (size_t lane = 0; lane < lanes; lane++) {
+            candidates[lane] = "pw" + std::to_string(1000 + base * lanes + lane);
+            uint8_t block[64] = {};
+            memcpy(block, candidates[lane].data(), length);
+            block[length] = 0x80;
+            const uint64_t bits = length * 8;
+            for (size_t i = 0; i < 8; i++) {
+                block[56 + i] = (uint8_t)(bits >> (Engine::BigEndian ? (7 - i) * 8 : i * 8));
+            }
+            for (size_t i = 0; i < 16; i++) {
+                uint32_t word;
+                memcpy(&word, &block[i * 4], 4);
+                words[i][lane] = Engine::BigEndian ? __builtin_bswap32(word) : word;
+            }
+        }
+
+        typename Engine::Block block;
+        for (size_t i = 0; i < 16; i++) {
+            block[i] = Isa::Load(words[i]);
+        }
+        auto state = Engine::Init();
+        Engine::Transform(state, block);
+
+        std::vector<uint8_t> hashes(lanes * Engine::DigestSize);
+        Engine::GetDigests(state, hashes.data());
+        for (size_t lane = 0; lane < lanes; lane++) {
+            uint8_t expected[MAX_HASH_SIZE];
+            SimdHashSingle(TypeParam::Value, length, (const uint8_t*)candidates[lane].data(), expected);
+            ASSERT_EQ(0, memcmp(expected, &hashes[lane * Engine::DigestSize], Engine::DigestSize)) << candidates[lane];
+        }
+    }
+}
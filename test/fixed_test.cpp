@@ -0,0 +1,69 @@
+//
+// fixed_test.cpp
+// Tests for the compile-time fixed length kernels in SimdHashFixed.hpp
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "SimdHashFixed.hpp"
+
+class FixedLengthTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+TEST_P(FixedLengthTest, MatchesSingleForAllLengths) {
+    const HashAlgorithm algo = GetParam();
+    const size_t lanes = SimdLanes();
+    const size_t digestLen = GetHashWidth(algo);
+
+    uint8_t buffers[MAX_LANES][MAX_OPTIMIZED_BUFFER_SIZE];
+    const uint8_t* bufferptrs[MAX_LANES];
+    for (size_t i = 0; i < MAX_LANES; i++) {
+        bufferptrs[i] = buffers[i];
+    }
+
+    srand(1234);
+    for (size_t len = 1; len <= MAX_OPTIMIZED_BUFFER_SIZE; len++) {
+        ASSERT_TRUE(simdhash::SupportsFixedLength(algo, len));
+        for (size_t i = 0; i < lanes; i++) {
+            for (size_t j = 0; j < len; j++) {
+                buffers[i][j] = (uint8_t)(rand() & 0xff);
+            }
+        }
+
+        uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+        ASSERT_TRUE(simdhash::SimdHashFixed(algo, len, bufferptrs, hashes));
+
+        for (size_t i = 0; i < lanes; i++) {
+            uint8_t expected[MAX_HASH_SIZE];
+            SimdHashSingle(algo, len, bufferptrs[i], expected);
+            ASSERT_EQ(0, memcmp(&hashes[i * digestLen], expected, digestLen))
+                << "algo=" << HashAlgorithmToString(algo) << " length=" << len << " lane=" << i;
+        }
+    }
+}
+
+TEST_P(FixedLengthTest, RejectsUnsupportedLengths) {
+    const HashAlgorithm algo = GetParam();
+    EXPECT_FALSE(simdhash::SupportsFixedLength(algo, 0));
+    EXPECT_FALSE(simdhash::SupportsFixedLength(algo, MAX_OPTIMIZED_BUFFER_SIZE + 1));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Fixed, FixedLengthTest,
+    ::testing::Values(
+        HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256
+    ),
+    AlgoName
+);
+
+TEST(FixedLength, UnsupportedAlgorithms) {
+    EXPECT_FALSE(simdhash::SupportsFixedLength(HashAlgorithmNTLM, 8));
+    EXPECT_FALSE(simdhash::SupportsFixedLength(HashAlgorithmSHA512, 8));
+    EXPECT_FALSE(simdhash::SupportsFixedLength(HashAlgorithmFNV1a_64, 8));
+}
@@ -0,0 +1,146 @@
+//
+// hashbatch_test.cpp
+// Tests for the arena backed lane interleaved batch (SimdHashBatch)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class HashBatchTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static std::vector<std::vector<uint8_t>> RandomInputs(size_t count, size_t width, unsigned seed) {
+    std::vector<std::vector<uint8_t>> inputs(count);
+    srand(seed);
+    for (auto& input : inputs) {
+        input.resize(((size_t)rand()) % (width + 1));
+        for (auto& byte : input) {
+            byte = (uint8_t)(rand() & 0xff);
+        }
+    }
+    return inputs;
+}
+
+static void CheckBatch(HashAlgorithm algo, SimdHashBatch& batch, const std::vector<std::vector<uint8_t>>& inputs) {
+    const size_t digestLen = GetHashWidth(algo);
+    std::vector<uint8_t> hashes(inputs.size() * digestLen);
+    uint8_t expected[MAX_HASH_SIZE];
+
+    SimdHashBatchClear(&batch);
+    for (const auto& input : inputs) {
+        ASSERT_TRUE(SimdHashBatchAdd(&batch, input.size(), input.data()));
+    }
+    ASSERT_EQ(batch.Count, inputs.size());
+
+    SimdHashBatchHash(algo, &batch, hashes.data());
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        SimdHashSingle(algo, inputs[i].size(), inputs[i].data(), expected);
+        ASSERT_EQ(memcmp(&hashes[i * digestLen], expected, digestLen), 0)
+            << "candidate " << i << " length " << inputs[i].size();
+    }
+}
+
+TEST_P(HashBatchTest, MatchesSingle) {
+    SimdHashBatch batch;
+    const size_t width = GetOptimizedLength(GetParam());
+
+    ASSERT_TRUE(SimdHashBatchInit(&batch, width, 1000, false));
+    EXPECT_EQ(batch.Capacity % SimdLanes(), 0u);
+    EXPECT_GE(batch.Capacity, 1000u);
+
+    CheckBatch(GetParam(), batch, RandomInputs(1000, width, 1));
+    SimdHashBatchDestroy(&batch);
+}
+
+TEST_P(HashBatchTest, ReuseAfterClear) {
+    SimdHashBatch batch;
+
+    ASSERT_TRUE(SimdHashBatchInit(&batch, 32, 4 * SimdLanes(), false));
+
+    // Long candidates first so that the shorter ones overwrite stale bytes
+    std::vector<std::vector<uint8_t>> longInputs(4 * SimdLanes(), std::vector<uint8_t>(32, 0xff));
+    CheckBatch(GetParam(), batch, longInputs);
+    CheckBatch(GetParam(), batch, RandomInputs(4 * SimdLanes() - 3, 32, 2));
+    CheckBatch(GetParam(), batch, RandomInputs(1, 32, 3));
+    SimdHashBatchDestroy(&batch);
+}
+
+TEST_P(HashBatchTest, HugePages) {
+    SimdHashBatch batch;
+
+    // Falls back to an ordinary mapping when no huge pages are reserved
+    ASSERT_TRUE(SimdHashBatchInit(&batch, 24, 5000, true));
+    EXPECT_TRUE(batch.Mapped);
+    EXPECT_EQ(((uintptr_t)batch.Words) % VALUE_ALIGN, 0u);
+
+    CheckBatch(GetParam(), batch, RandomInputs(5000, 24, 4));
+    SimdHashBatchDestroy(&batch);
+}
+
+TEST_P(HashBatchTest, UpdateBatchDirect) {
+    SimdHashBatch batch;
+    SimdHashContext ctx;
+    const size_t digestLen = GetHashWidth(GetParam());
+    std::vector<uint8_t> hashes(SimdLanes() * digestLen);
+    uint8_t expected[MAX_HASH_SIZE];
+    const auto inputs = RandomInputs(2 * SimdLanes(), 40, 5);
+
+    ASSERT_TRUE(SimdHashBatchInit(&batch, 40, inputs.size(), false));
+    for (size_t i = 0; i < inputs.size(); i++) {
+        SimdHashBatchSet(&batch, i, inputs[i].size(), inputs[i].data());
+    }
+    batch.Count = inputs.size();
+
+    SimdHashInit(&ctx, GetParam());
+    SimdHashUpdateBatch(&ctx, &batch, 1);
+    SimdHashFinalize(&ctx);
+    SimdHashGetHashes(&ctx, hashes.data());
+
+    for (size_t lane = 0; lane < SimdLanes(); lane++) {
+        const auto& input = inputs[SimdLanes() + lane];
+        SimdHashSingle(GetParam(), input.size(), input.data(), expected);
+        ASSERT_EQ(memcmp(&hashes[lane * digestLen], expected, digestLen), 0) << "lane " << lane;
+    }
+    SimdHashBatchDestroy(&batch);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Algorithms,
+    HashBatchTest,
+    ::testing::Values(HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256),
+    AlgoName
+);
+
+TEST(HashBatch, Limits) {
+    SimdHashBatch batch;
+    const uint8_t input[MAX_OPTIMIZED_BUFFER_SIZE + 1] = {};
+
+    EXPECT_FALSE(SimdHashBatchInit(&batch, 0, 16, false));
+    EXPECT_FALSE(SimdHashBatchInit(&batch, MAX_OPTIMIZED_BUFFER_SIZE + 1, 16, false));
+    EXPECT_FALSE(SimdHashBatchInit(&batch, 16, 0, false));
+
+    ASSERT_TRUE(SimdHashBatchInit(&batch, 16, 1, false));
+    EXPECT_EQ(batch.Capacity, SimdLanes());
+    EXPECT_FALSE(SimdHashBatchAdd(&batch, 17, input));
+    for (size_t i = 0; i < batch.Capacity; i++) {
+        EXPECT_TRUE(SimdHashBatchAdd(&batch, 16, input));
+    }
+    EXPECT_FALSE(SimdHashBatchAdd(&batch, 1, input));
+
+    SimdHashBatchClear(&batch);
+    EXPECT_EQ(batch.Count, 0u);
+    EXPECT_EQ(SimdHashBatchGroupCount(&batch), 0u);
+    EXPECT_TRUE(SimdHashBatchAdd(&batch, 1, input));
+    SimdHashBatchDestroy(&batch);
+}
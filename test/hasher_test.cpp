@@ -0,0 +1,140 @@
+//
+// hasher_test.cpp
+// Tests for the range based C++ batch hasher (simdhash::Hasher)
+//
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "SimdHash.hpp"
+
+template <typename T>
+class HasherTest : public ::testing::Test {};
+
+using Algorithms = ::testing::Types<
+    std::integral_constant<HashAlgorithm, HashAlgorithmMD4>,
+    std::integral_constant<HashAlgorithm, HashAlgorithmMD5>,
+    std::integral_constant<HashAlgorithm, HashAlgorithmSHA1>,
+    std::integral_constant<HashAlgorithm, HashAlgorithmSHA256>,
+    std::integral_constant<HashAlgorithm, HashAlgorithmSHA512>,
+    std::integral_constant<HashAlgorithm, HashAlgorithmNTLM>,
+    std::integral_constant<HashAlgorithm, HashAlgorithmFNV1a_32>
+>;
+TYPED_TEST_SUITE(HasherTest, Algorithms);
+
+static std::vector<std::string> RandomStrings(size_t count, size_t maxLength, unsigned seed) {
+    std::vector<std::string> strings(count);
+    srand(seed);
+    for (auto& s : strings) {
+        s.resize(((size_t)rand()) % (maxLength + 1));
+        for (auto& c : s) {
+            c = (char)(rand() & 0xff);
+        }
+    }
+    return strings;
+}
+
+template <HashAlgorithm Algorithm>
+static std::array<uint8_t, simdhash::HashWidth(Algorithm)> Expected(std::string_view input) {
+    std::array<uint8_t, simdhash::HashWidth(Algorithm)> digest;
+    SimdHashSingle(Algorithm, input.size(), (const uint8_t*)input.data(), digest.data());
+    return digest;
+}
+
+TYPED_TEST(HasherTest, DigestSizeMatchesRuntime) {
+    constexpr HashAlgorithm algo = TypeParam::value;
+    EXPECT_EQ(GetHashWidth(algo), simdhash::Hasher<algo>::DigestSize);
+}
+
+TYPED_TEST(HasherTest, StringsIntoSpan) {
+    constexpr HashAlgorithm algo = TypeParam::value;
+    simdhash::Hasher<algo> hasher;
+    for (size_t count : {0, 1, 15, 16, 17, 100}) {
+        auto inputs = RandomStrings(count, 140, (unsigned)count);
+        std::vector<typename simdhash::Hasher<algo>::DigestType> digests(count);
+        EXPECT_EQ(count, hasher.Hash(inputs, digests));
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_EQ(Expected<algo>(inputs[i]), digests[i]) << "count=" << count << " index=" << i;
+        }
+    }
+}
+
+TYPED_TEST(HasherTest, StringViewsAndSpans) {
+    constexpr HashAlgorithm algo = TypeParam::value;
+    simdhash::Hasher<algo> hasher;
+    auto strings = RandomStrings(50, 40, 5);
+
+    std::vector<std::string_view> views(strings.begin(), strings.end());
+    std::vector<std::span<const uint8_t>> spans;
+    for (auto& s : strings) {
+        spans.emplace_back((const uint8_t*)s.data(), s.size());
+    }
+
+    std::vector<typename simdhash::Hasher<algo>::DigestType> fromViews(strings.size());
+    std::vector<typename simdhash::Hasher<algo>::DigestType> fromSpans(strings.size());
+    hasher.Hash(views, fromViews);
+    hasher.Hash(spans, fromSpans);
+
+    for (size_t i = 0; i < strings.size(); i++) {
+        EXPECT_EQ(Expected<algo>(strings[i]), fromViews[i]);
+        EXPECT_EQ(Expected<algo>(strings[i]), fromSpans[i]);
+        EXPECT_EQ(Expected<algo>(strings[i]), hasher.Hash(spans[i]));
+    }
+}
+
+TYPED_TEST(HasherTest, CallbackOverLazyRange) {
+    constexpr HashAlgorithm algo = TypeParam::value;
+    simdhash::Hasher<algo> hasher;
+    std::list<std::string> strings;
+    for (auto& s : RandomStrings(37, 200, 9)) {
+        strings.push_back(s);
+    }
+
+    // A non random access range of string_views produced on the fly
+    auto views = strings | std::views::transform([](const std::string& s) { return std::string_view(s); });
+
+    std::vector<std::string> ordered(strings.begin(), strings.end());
+    size_t calls = 0;
+    hasher.Hash(views, [&](size_t index, const auto& digest) {
+        EXPECT_EQ(calls, index);
+        EXPECT_EQ(Expected<algo>(ordered[index]), digest);
+        calls++;
+    });
+    EXPECT_EQ(strings.size(), calls);
+}
+
+TYPED_TEST(HasherTest, SinglePassIstreamRange) {
+    constexpr HashAlgorithm algo = TypeParam::value;
+    simdhash::Hasher<algo> hasher;
+    std::vector<std::string> words;
+    std::string text;
+    for (size_t i = 0; i < 40; i++) {
+        words.push_back("word" + std::to_string(i * 7919) + std::string(i % 13, 'x'));
+        text += words.back() + " ";
+    }
+
+    // Every element of an istream range is the same cached string
+    std::istringstream intoSpan(text);
+    std::vector<typename simdhash::Hasher<algo>::DigestType> digests(words.size());
+    EXPECT_EQ(words.size(), hasher.Hash(std::views::istream<std::string>(intoSpan), digests));
+    for (size_t i = 0; i < words.size(); i++) {
+        EXPECT_EQ(Expected<algo>(words[i]), digests[i]) << "index=" << i;
+    }
+
+    std::istringstream intoCallback(text);
+    size_t calls = 0;
+    hasher.Hash(std::views::istream<std::string>(intoCallback), [&](size_t index, const auto& digest) {
+        EXPECT_EQ(Expected<algo>(words[index]), digest) << "index=" << index;
+        calls++;
+    });
+    EXPECT_EQ(words.size(), calls);
+}
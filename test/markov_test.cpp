@@ -0,0 +1,124 @@
+//
+// markov_test.cpp
+// Tests for the Markov ordered candidate generator
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class MarkovTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_Stats = SimdHashMarkovCreate();
+        ASSERT_NE(m_Stats, nullptr);
+        for (const char* word : { "pass", "pass", "pass", "past", "pest", "post", "tape", "ape" }) {
+            SimdHashMarkovTrain(m_Stats, (const uint8_t*)word, strlen(word));
+        }
+    }
+    void TearDown() override { SimdHashMarkovDestroy(m_Stats); }
+
+    static std::string Candidate(const SimdHashMarkovChain& chain, uint64_t index) {
+        uint8_t buffer[MARKOV_MAX_LENGTH];
+        const size_t length = SimdHashMarkovCandidate(&chain, index, buffer);
+        return std::string((const char*)buffer, length);
+    }
+
+    SimdHashMarkovStats* m_Stats = nullptr;
+};
+
+TEST_F(MarkovTest, MostLikelyFirst) {
+    SimdHashMarkovChain chain;
+    ASSERT_TRUE(SimdHashMarkovChainInit(&chain, m_Stats, 4, 4, "abcdefghijklmnopqrstuvwxyz"));
+    EXPECT_EQ(chain.Keyspace, 4u * 4u * 4u * 4u);
+    EXPECT_EQ(Candidate(chain, 0), "pass");
+    EXPECT_EQ(Candidate(chain, 1), "past");
+
+    // Every candidate is distinct
+    std::set<std::string> seen;
+    for (uint64_t i = 0; i < chain.Keyspace; i++) {
+        seen.insert(Candidate(chain, i));
+    }
+    EXPECT_EQ(seen.size(), chain.Keyspace);
+    SimdHashMarkovChainDestroy(&chain);
+}
+
+TEST_F(MarkovTest, GeneratorMatchesCandidates) {
+    SimdHashMarkovChain chain;
+    ASSERT_TRUE(SimdHashMarkovChainInit(&chain, m_Stats, 5, 7, nullptr));
+
+    const size_t lanes = SimdLanes();
+    std::vector<size_t> lengths(lanes);
+    std::vector<const uint8_t*> buffers(lanes);
+    std::vector<uint8_t> hashes(lanes * MD5_SIZE);
+    uint8_t expected[MD5_SIZE];
+
+    // Uneven partitions that do not line up with lane groups
+    uint64_t total = 0;
+    for (uint64_t start = 0; start < chain.Keyspace; start += 1111) {
+        SimdHashMarkovGenerator generator;
+        SimdHashMarkovGeneratorInit(&generator, &chain, start, 1111);
+        uint64_t index = start;
+        size_t found;
+        while ((found = SimdHashMarkovGeneratorNext(&generator, lengths.data(), buffers.data())) > 0) {
+            SimdHashOptimized(HashAlgorithmMD5, lengths.data(), buffers.data(), hashes.data());
+            for (size_t lane = 0; lane < found; lane++, index++) {
+                const std::string candidate = Candidate(chain, index);
+                ASSERT_EQ(std::string((const char*)buffers[lane], lengths[lane]), candidate) << index;
+                SimdHashSingle(HashAlgorithmMD5, candidate.size(), (const uint8_t*)candidate.data(), expected);
+                EXPECT_EQ(memcmp(&hashes[lane * MD5_SIZE], expected, MD5_SIZE), 0) << candidate;
+            }
+            for (size_t lane = found; lane < lanes; lane++) {
+                EXPECT_EQ(lengths[lane], 0u);
+            }
+        }
+        total += index - start;
+    }
+    EXPECT_EQ(total, chain.Keyspace);
+    SimdHashMarkovChainDestroy(&chain);
+}
+
+TEST_F(MarkovTest, TrainFile) {
+    char path[] = "/tmp/simdhash_markov_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    const std::string data = "zzz\nzzz\nzzy\n";
+    ASSERT_EQ(write(fd, data.data(), data.size()), (ssize_t)data.size());
+    close(fd);
+
+    SimdHashMarkovStats* stats = SimdHashMarkovCreate();
+    ASSERT_TRUE(SimdHashMarkovTrainFile(stats, path));
+    unlink(path);
+
+    SimdHashMarkovChain chain;
+    ASSERT_TRUE(SimdHashMarkovChainInit(&chain, stats, 3, 2, nullptr));
+    EXPECT_EQ(Candidate(chain, 0), "zzz");
+    EXPECT_EQ(Candidate(chain, 1), "zzy");
+    SimdHashMarkovChainDestroy(&chain);
+
+    EXPECT_FALSE(SimdHashMarkovTrainFile(stats, "/nonexistent/simdhash/markov.txt"));
+    SimdHashMarkovDestroy(stats);
+}
+
+TEST_F(MarkovTest, Limits) {
+    SimdHashMarkovChain chain;
+    EXPECT_FALSE(SimdHashMarkovChainInit(&chain, m_Stats, 0, 4, nullptr));
+    EXPECT_FALSE(SimdHashMarkovChainInit(&chain, m_Stats, MARKOV_MAX_LENGTH + 1, 4, nullptr));
+    EXPECT_FALSE(SimdHashMarkovChainInit(&chain, m_Stats, 4, 0, nullptr));
+    EXPECT_FALSE(SimdHashMarkovChainInit(&chain, m_Stats, 20, 95, nullptr));
+
+    // The threshold is clamped to the charset
+    ASSERT_TRUE(SimdHashMarkovChainInit(&chain, m_Stats, 3, 100, "ab"));
+    EXPECT_EQ(chain.Threshold, 2u);
+    EXPECT_EQ(chain.Keyspace, 8u);
+    SimdHashMarkovChainDestroy(&chain);
+}
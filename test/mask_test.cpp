@@ -0,0 +1,150 @@
+//
+// mask_test.cpp
+// Tests for the mask attack candidate generator
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class MaskTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static std::string Candidate(const SimdHashMask& mask, uint64_t index) {
+    uint8_t buffer[MASK_MAX_LENGTH];
+    const size_t length = SimdHashMaskCandidate(&mask, index, buffer);
+    return std::string((const char*)buffer, length);
+}
+
+// Generates [start, start + count) and checks every digest against the
+// scalar hash of the candidate with the same index
+static size_t CheckRange(HashAlgorithm algo, const SimdHashMask& mask, uint64_t start, uint64_t count) {
+    const size_t digestLen = GetHashWidth(algo);
+    std::vector<uint8_t> hashes(SimdLanes() * digestLen);
+    uint8_t expected[MAX_HASH_SIZE];
+    SimdHashMaskGenerator generator;
+    SimdHashContext ctx;
+    uint64_t index = start;
+    size_t found;
+
+    SimdHashMaskGeneratorInit(&generator, &mask, start, count);
+    SimdHashResetContext(&ctx, algo);
+    while ((found = SimdHashMaskGeneratorNext(&generator, &ctx)) > 0) {
+        SimdHashFinalize(&ctx);
+        SimdHashGetHashes(&ctx, hashes.data());
+        for (size_t lane = 0; lane < found; lane++, index++) {
+            const std::string candidate = Candidate(mask, index);
+            SimdHashSingle(algo, candidate.size(), (const uint8_t*)candidate.data(), expected);
+            EXPECT_EQ(memcmp(&hashes[lane * digestLen], expected, digestLen), 0)
+                << "index " << index << " candidate " << candidate;
+        }
+        SimdHashResetContext(&ctx, algo);
+    }
+    return index - start;
+}
+
+TEST_P(MaskTest, WholeKeyspace) {
+    SimdHashMask mask;
+    ASSERT_TRUE(SimdHashMaskParse(&mask, "?l?d?u", nullptr));
+    EXPECT_EQ(mask.Keyspace, 26u * 10u * 26u);
+    EXPECT_EQ(CheckRange(GetParam(), mask, 0, UINT64_MAX), mask.Keyspace);
+}
+
+TEST_P(MaskTest, Partitions) {
+    SimdHashMask mask;
+    const char* custom[MASK_CUSTOM_CHARSETS] = { "abc", "?d!", nullptr, nullptr };
+    ASSERT_TRUE(SimdHashMaskParse(&mask, "pw?1?2?2?d", custom));
+    EXPECT_EQ(mask.Keyspace, 3u * 11u * 11u * 10u);
+
+    // Uneven partitions that do not line up with lane groups
+    uint64_t total = 0;
+    for (uint64_t start = 0; start < mask.Keyspace; start += 777) {
+        total += CheckRange(GetParam(), mask, start, 777);
+    }
+    EXPECT_EQ(total, mask.Keyspace);
+}
+
+TEST_P(MaskTest, LongMask) {
+    SimdHashMask mask;
+    std::string pattern = "prefix-that-fills-most-of-the-block-";
+    pattern += "?a?a?b?d?s";
+    ASSERT_TRUE(SimdHashMaskParse(&mask, pattern.c_str(), nullptr));
+    ASSERT_LE(mask.Length, GetOptimizedLength(GetParam()));
+    EXPECT_EQ(CheckRange(GetParam(), mask, 123456789, 5000), 5000u);
+}
+
+TEST_P(MaskTest, CharsetDividesLanes) {
+    SimdHashMask mask;
+    const char* custom[MASK_CUSTOM_CHARSETS] = { "01", nullptr, nullptr, nullptr };
+    // The trailing positions take no step when their sizes divide the lane count
+    ASSERT_TRUE(SimdHashMaskParse(&mask, "?d?h?1?1", custom));
+    EXPECT_EQ(mask.Keyspace, 10u * 16u * 2u * 2u);
+    EXPECT_EQ(CheckRange(GetParam(), mask, 0, UINT64_MAX), mask.Keyspace);
+    EXPECT_EQ(CheckRange(GetParam(), mask, 37, 300), 300u);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Algorithms,
+    MaskTest,
+    ::testing::Values(HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256),
+    AlgoName
+);
+
+TEST(Mask, Parse) {
+    SimdHashMask mask;
+    const char* custom[MASK_CUSTOM_CHARSETS] = { "aab", nullptr, nullptr, "?l?u" };
+
+    ASSERT_TRUE(SimdHashMaskParse(&mask, "?a?b?h?H?s??", nullptr));
+    EXPECT_EQ(mask.CharsetSize[0], 95);
+    EXPECT_EQ(mask.CharsetSize[1], 256);
+    EXPECT_EQ(mask.CharsetSize[2], 16);
+    EXPECT_EQ(mask.CharsetSize[3], 16);
+    EXPECT_EQ(mask.CharsetSize[4], 33);
+    EXPECT_EQ(mask.CharsetSize[5], 1);
+    EXPECT_EQ(mask.Charset[5][0], '?');
+
+    // Duplicates in custom charsets are dropped
+    ASSERT_TRUE(SimdHashMaskParse(&mask, "?1?4", custom));
+    EXPECT_EQ(mask.CharsetSize[0], 2);
+    EXPECT_EQ(mask.CharsetSize[1], 52);
+
+    EXPECT_FALSE(SimdHashMaskParse(&mask, "", nullptr));
+    EXPECT_FALSE(SimdHashMaskParse(&mask, "?z", nullptr));
+    EXPECT_FALSE(SimdHashMaskParse(&mask, "?", nullptr));
+    EXPECT_FALSE(SimdHashMaskParse(&mask, "?2", custom));
+    EXPECT_FALSE(SimdHashMaskParse(&mask, "?1", nullptr));
+    EXPECT_FALSE(SimdHashMaskParse(&mask, std::string(MASK_MAX_LENGTH + 1, 'x').c_str(), nullptr));
+    // 256^9 does not fit in 64 bits
+    EXPECT_FALSE(SimdHashMaskParse(&mask, "?b?b?b?b?b?b?b?b?b", nullptr));
+}
+
+TEST(Mask, CandidateOrder) {
+    SimdHashMask mask;
+    ASSERT_TRUE(SimdHashMaskParse(&mask, "x?d?l", nullptr));
+    EXPECT_EQ(Candidate(mask, 0), "x0a");
+    EXPECT_EQ(Candidate(mask, 1), "x0b");
+    EXPECT_EQ(Candidate(mask, 26), "x1a");
+    EXPECT_EQ(Candidate(mask, mask.Keyspace - 1), "x9z");
+}
+
+TEST(Mask, EmptyRange) {
+    SimdHashMask mask;
+    SimdHashMaskGenerator generator;
+    SimdHashContext ctx;
+
+    ASSERT_TRUE(SimdHashMaskParse(&mask, "?d", nullptr));
+    SimdHashResetContext(&ctx, HashAlgorithmMD5);
+    SimdHashMaskGeneratorInit(&generator, &mask, 10, 5);
+    EXPECT_EQ(SimdHashMaskGeneratorNext(&generator, &ctx), 0u);
+    SimdHashMaskGeneratorInit(&generator, &mask, 3, 0);
+    EXPECT_EQ(SimdHashMaskGeneratorNext(&generator, &ctx), 0u);
+}
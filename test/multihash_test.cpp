@@ -0,0 +1,107 @@
+//
+// multihash_test.cpp
+// Tests for fused multi-algorithm hashing (SimdHashMulti)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+static void CheckMulti(
+    const std::vector<HashAlgorithm>& algos,
+    const size_t* lengths,
+    const uint8_t* const* bufferptrs)
+{
+    const size_t lanes = SimdLanes();
+    std::vector<std::vector<uint8_t>> outputs(algos.size());
+    std::vector<uint8_t*> outputptrs(algos.size());
+    for (size_t a = 0; a < algos.size(); a++) {
+        outputs[a].resize(MAX_LANES * MAX_HASH_SIZE);
+        outputptrs[a] = outputs[a].data();
+    }
+
+    SimdHashMulti(algos.size(), algos.data(), lengths, bufferptrs, outputptrs.data());
+
+    for (size_t a = 0; a < algos.size(); a++) {
+        const size_t digestLen = GetHashWidth(algos[a]);
+        for (size_t i = 0; i < lanes; i++) {
+            uint8_t expected[MAX_HASH_SIZE];
+            SimdHashSingle(algos[a], lengths[i], bufferptrs[i], expected);
+            ASSERT_EQ(0, memcmp(&outputs[a][i * digestLen], expected, digestLen))
+                << "algo=" << HashAlgorithmToString(algos[a]) << " lane=" << i << " length=" << lengths[i];
+        }
+    }
+}
+
+TEST(MultiHash, SupportedAlgorithms) {
+    EXPECT_TRUE(SupportsMultiHash(HashAlgorithmMD4));
+    EXPECT_TRUE(SupportsMultiHash(HashAlgorithmMD5));
+    EXPECT_TRUE(SupportsMultiHash(HashAlgorithmSHA1));
+    EXPECT_TRUE(SupportsMultiHash(HashAlgorithmSHA256));
+    EXPECT_FALSE(SupportsMultiHash(HashAlgorithmSHA512));
+    EXPECT_FALSE(SupportsMultiHash(HashAlgorithmNTLM));
+    EXPECT_FALSE(SupportsMultiHash(HashAlgorithmFNV1a_64));
+}
+
+TEST(MultiHash, UniformLengths) {
+    const std::vector<HashAlgorithm> algos = {
+        HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256
+    };
+    std::vector<std::vector<uint8_t>> buffers(MAX_LANES, std::vector<uint8_t>(300));
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    srand(29);
+    for (size_t len = 0; len <= 300; len += 7) {
+        for (size_t i = 0; i < SimdLanes(); i++) {
+            for (size_t j = 0; j < len; j++) {
+                buffers[i][j] = (uint8_t)(rand() & 0xff);
+            }
+            bufferptrs[i] = buffers[i].data();
+            lengths[i] = len;
+        }
+        CheckMulti(algos, lengths, bufferptrs);
+    }
+}
+
+TEST(MultiHash, MixedLengths) {
+    // Big endian algorithm first so the length fix-up runs the other way
+    const std::vector<HashAlgorithm> algos = {
+        HashAlgorithmSHA256, HashAlgorithmMD4, HashAlgorithmSHA1, HashAlgorithmMD5
+    };
+    std::vector<std::vector<uint8_t>> buffers(MAX_LANES, std::vector<uint8_t>(1000));
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    srand(30);
+    for (int iter = 0; iter < 100; iter++) {
+        for (size_t i = 0; i < SimdLanes(); i++) {
+            lengths[i] = ((size_t)rand()) % 1000;
+            for (size_t j = 0; j < lengths[i]; j++) {
+                buffers[i][j] = (uint8_t)(rand() & 0xff);
+            }
+            bufferptrs[i] = buffers[i].data();
+        }
+        CheckMulti(algos, lengths, bufferptrs);
+    }
+}
+
+TEST(MultiHash, UnfusedAlgorithmsFallBack) {
+    const std::vector<HashAlgorithm> algos = {
+        HashAlgorithmMD5, HashAlgorithmSHA512, HashAlgorithmFNV1a_32, HashAlgorithmSHA1
+    };
+    const char* input = "The quick brown fox jumps over the lazy dog";
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+    for (size_t i = 0; i < SimdLanes(); i++) {
+        bufferptrs[i] = (const uint8_t*)input;
+        lengths[i] = strlen(input) - (i % 5);
+    }
+    CheckMulti(algos, lengths, bufferptrs);
+}
@@ -0,0 +1,290 @@
+//
+// ntlm_test.cpp
+// Tests for the NTLM UTF-8 -> UTF-16LE conversion and optimized path
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unicode/ustring.h>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+// Reference: MD4 over a hand-built UTF-16LE encoding
+static std::vector<uint8_t> ReferenceNtlm(const std::u16string& wide) {
+    std::vector<uint8_t> bytes;
+    for (char16_t c : wide) {
+        bytes.push_back(c & 0xff);
+        bytes.push_back(c >> 8);
+    }
+    std::vector<uint8_t> digest(MD4_SIZE);
+    SimdHashSingle(HashAlgorithmMD4, bytes.size(), bytes.data(), digest.data());
+    return digest;
+}
+
+struct NtlmVector {
+    std::string utf8;
+    std::u16string utf16;
+};
+
+static const std::vector<NtlmVector> kNtlmVectors = {
+    {"", u""},
+    {"password", u"password"},
+    {"abcdefghijklmnopqrstuvwxyz0", u"abcdefghijklmnopqrstuvwxyz0"},
+    {"p\xc3\xa4ssw\xc3\xb6rd", u"pässwörd"},
+    {"\xe2\x82\xac" "100", u"€100"},
+    {"\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e", u"日本語"},
+    {"x\xf0\x9f\x98\x80y", u"x\U0001F600y"},
+    {"0123456789abcdef0123456789abcdef\xc3\xa9", u"0123456789abcdef0123456789abcdefé"},
+};
+
+// ============================================================
+// UTF-8 decoder
+// ============================================================
+
+TEST(Ntlm, DecoderMatchesReference) {
+    for (const auto& tv : kNtlmVectors) {
+        std::vector<uint8_t> out(tv.utf8.size() * 2 + 1);
+        size_t written = Utf8ToUtf16le((const uint8_t*)tv.utf8.data(), tv.utf8.size(), out.data());
+        ASSERT_EQ(written, tv.utf16.size() * 2) << "Input: " << tv.utf8;
+        for (size_t i = 0; i < tv.utf16.size(); i++) {
+            EXPECT_EQ(out[i * 2] | (out[i * 2 + 1] << 8), tv.utf16[i]) << "Input: " << tv.utf8;
+        }
+    }
+}
+
+TEST(Ntlm, DecoderRejectsMalformed) {
+    const std::string malformed[] = {
+        "\x80",             // Lone continuation
+        "\xc3",             // Truncated sequence
+        "\xc0\xaf",         // Overlong
+        "\xed\xa0\x80",     // Encoded surrogate
+        "\xf4\x90\x80\x80", // Above U+10FFFF
+    };
+    for (const auto& s : malformed) {
+        std::vector<uint8_t> out(s.size() * 2 + 1);
+        EXPECT_EQ(Utf8ToUtf16le((const uint8_t*)s.data(), s.size(), out.data()), (size_t)-1);
+    }
+}
+
+// Encodes code points as UTF-8 and UTF-16 for the randomized tests
+static void AppendCodepoint(std::string& utf8, std::u16string& utf16, uint32_t cp) {
+    if (cp < 0x80) {
+        utf8 += (char)cp;
+    } else if (cp < 0x800) {
+        utf8 += (char)(0xc0 | (cp >> 6));
+        utf8 += (char)(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        utf8 += (char)(0xe0 | (cp >> 12));
+        utf8 += (char)(0x80 | ((cp >> 6) & 0x3f));
+        utf8 += (char)(0x80 | (cp & 0x3f));
+    } else {
+        utf8 += (char)(0xf0 | (cp >> 18));
+        utf8 += (char)(0x80 | ((cp >> 12) & 0x3f));
+        utf8 += (char)(0x80 | ((cp >> 6) & 0x3f));
+        utf8 += (char)(0x80 | (cp & 0x3f));
+    }
+    if (cp < 0x10000) {
+        utf16 += (char16_t)cp;
+    } else {
+        utf16 += (char16_t)(0xd800 | ((cp - 0x10000) >> 10));
+        utf16 += (char16_t)(0xdc00 | ((cp - 0x10000) & 0x3ff));
+    }
+}
+
+static uint32_t RandomCodepoint() {
+    switch (rand() % 4) {
+    case 0: return rand() % 0x80;
+    case 1: return 0x80 + rand() % (0x800 - 0x80);
+    case 2: {
+        uint32_t cp = 0x800 + rand() % (0x10000 - 0x800);
+        return (cp >= 0xd800 && cp <= 0xdfff) ? cp - 0x800 : cp;
+    }
+    default: return 0x10000 + rand() % (0x110000 - 0x10000);
+    }
+}
+
+TEST(Ntlm, DecoderRandomMixedSequences) {
+    srand(26);
+    for (size_t iteration = 0; iteration < 2000; iteration++) {
+        std::string utf8;
+        std::u16string utf16;
+        const size_t count = rand() % 40;
+        for (size_t i = 0; i < count; i++) {
+            AppendCodepoint(utf8, utf16, RandomCodepoint());
+        }
+
+        std::vector<uint8_t> out(utf8.size() * 2 + 1);
+        ASSERT_EQ(Utf8ToUtf16le((const uint8_t*)utf8.data(), utf8.size(), out.data()), utf16.size() * 2);
+        for (size_t i = 0; i < utf16.size(); i++) {
+            ASSERT_EQ(out[i * 2] | (out[i * 2 + 1] << 8), utf16[i]) << "iteration " << iteration;
+        }
+
+        // Corrupt one byte and check that validity matches ICU's strict decoder
+        if (!utf8.empty()) {
+            utf8[rand() % utf8.size()] = (char)(rand() & 0xff);
+            UErrorCode status = U_ZERO_ERROR;
+            int32_t length = 0;
+            std::vector<UChar> icu(utf8.size() + 1);
+            u_strFromUTF8(icu.data(), (int32_t)icu.size(), &length, utf8.data(), (int32_t)utf8.size(), &status);
+            const size_t written = Utf8ToUtf16le((const uint8_t*)utf8.data(), utf8.size(), out.data());
+            if (U_FAILURE(status)) {
+                EXPECT_EQ(written, (size_t)-1) << "iteration " << iteration;
+            } else {
+                ASSERT_EQ(written, (size_t)length * 2) << "iteration " << iteration;
+                EXPECT_EQ(0, memcmp(out.data(), icu.data(), written)) << "iteration " << iteration;
+            }
+        }
+    }
+}
+
+// ============================================================
+// Single, general and optimized paths agree with the reference
+// ============================================================
+
+TEST(Ntlm, SingleMatchesReference) {
+    for (const auto& tv : kNtlmVectors) {
+        uint8_t hash[MD4_SIZE];
+        SimdHashSingle(HashAlgorithmNTLM, tv.utf8.size(), (const uint8_t*)tv.utf8.data(), hash);
+        EXPECT_EQ(0, memcmp(hash, ReferenceNtlm(tv.utf16).data(), MD4_SIZE)) << "Input: " << tv.utf8;
+    }
+}
+
+TEST(Ntlm, SimdMatchesReference) {
+    const size_t lanes = SimdLanes();
+    const uint8_t* buffers[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    for (size_t i = 0; i < lanes; i++) {
+        const auto& tv = kNtlmVectors[i % kNtlmVectors.size()];
+        buffers[i] = (const uint8_t*)tv.utf8.data();
+        lengths[i] = tv.utf8.size();
+    }
+
+    uint8_t hashes[MAX_LANES * MD4_SIZE];
+    SimdHash(HashAlgorithmNTLM, lengths, buffers, hashes);
+
+    for (size_t i = 0; i < lanes; i++) {
+        const auto& tv = kNtlmVectors[i % kNtlmVectors.size()];
+        EXPECT_EQ(0, memcmp(&hashes[i * MD4_SIZE], ReferenceNtlm(tv.utf16).data(), MD4_SIZE))
+            << "Lane " << i;
+    }
+}
+
+TEST(Ntlm, OptimizedMixedLengths) {
+    const size_t lanes = SimdLanes();
+    const uint8_t* buffers[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    ASSERT_TRUE(SupportsOptimization(HashAlgorithmNTLM));
+    ASSERT_EQ(GetOptimizedLength(HashAlgorithmNTLM), NTLM_OPTIMIZED_BUFFER_SIZE);
+
+    for (size_t i = 0; i < lanes; i++) {
+        const auto& tv = kNtlmVectors[i % (kNtlmVectors.size() - 1)];
+        buffers[i] = (const uint8_t*)tv.utf8.data();
+        lengths[i] = tv.utf8.size();
+    }
+
+    uint8_t hashes[MAX_LANES * MD4_SIZE];
+    SimdHashOptimized(HashAlgorithmNTLM, lengths, buffers, hashes);
+
+    for (size_t i = 0; i < lanes; i++) {
+        const auto& tv = kNtlmVectors[i % (kNtlmVectors.size() - 1)];
+        EXPECT_EQ(0, memcmp(&hashes[i * MD4_SIZE], ReferenceNtlm(tv.utf16).data(), MD4_SIZE))
+            << "Lane " << i;
+    }
+}
+
+TEST(Ntlm, OptimizedUniformLengthAllSizes) {
+    const size_t lanes = SimdLanes();
+    std::vector<std::string> inputs(lanes);
+    const uint8_t* buffers[MAX_LANES];
+
+    for (size_t len = 0; len <= NTLM_OPTIMIZED_BUFFER_SIZE; len++) {
+        for (size_t i = 0; i < lanes; i++) {
+            inputs[i].assign(len, (char)('a' + i));
+            // Put a two byte sequence into one lane to exercise the per-lane rewrite
+            if (i == 1 && len >= 2) {
+                inputs[i][0] = '\xc3';
+                inputs[i][1] = '\xa9';
+            }
+            buffers[i] = (const uint8_t*)inputs[i].data();
+        }
+
+        uint8_t hashes[MAX_LANES * MD4_SIZE];
+        SimdHashContext ctx;
+        SimdHashInit(&ctx, HashAlgorithmNTLM);
+        SimdHashUpdateAllOptimized(&ctx, len, buffers);
+        SimdHashFinalize(&ctx);
+        SimdHashGetHashes(&ctx, hashes);
+
+        for (size_t i = 0; i < lanes; i++) {
+            uint8_t expected[MD4_SIZE];
+            SimdHashSingle(HashAlgorithmNTLM, len, buffers[i], expected);
+            EXPECT_EQ(0, memcmp(&hashes[i * MD4_SIZE], expected, MD4_SIZE))
+                << "Lane " << i << " length " << len;
+        }
+    }
+}
+
+TEST(Ntlm, MalformedFallsBackToIcu) {
+    // ICU's lenient converter is only used for malformed input; the
+    // SIMD path and the single path must still agree
+    const std::string input = "ab\xff" "cd";
+    const size_t lanes = SimdLanes();
+    const uint8_t* buffers[MAX_LANES];
+    size_t lengths[MAX_LANES];
+    for (size_t i = 0; i < lanes; i++) {
+        buffers[i] = (const uint8_t*)input.data();
+        lengths[i] = input.size();
+    }
+
+    uint8_t expected[MD4_SIZE];
+    SimdHashSingle(HashAlgorithmNTLM, input.size(), (const uint8_t*)input.data(), expected);
+
+    uint8_t hashes[MAX_LANES * MD4_SIZE];
+    SimdHash(HashAlgorithmNTLM, lengths, buffers, hashes);
+    for (size_t i = 0; i < lanes; i++) {
+        EXPECT_EQ(0, memcmp(&hashes[i * MD4_SIZE], expected, MD4_SIZE)) << "Lane " << i;
+    }
+
+    SimdHashOptimized(HashAlgorithmNTLM, lengths, buffers, hashes);
+    for (size_t i = 0; i < lanes; i++) {
+        EXPECT_EQ(0, memcmp(&hashes[i * MD4_SIZE], expected, MD4_SIZE)) << "Lane " << i;
+    }
+}
+
+TEST(Ntlm, MalformedMixedLengths) {
+    // Random bytes are almost never valid UTF-8, so every lane goes
+    // through the ICU fallback with a different converted length
+    const size_t lanes = SimdLanes();
+    uint8_t buffers[MAX_LANES][100];
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    srand(5);
+    for (int iter = 0; iter < 100; iter++) {
+        for (size_t i = 0; i < lanes; i++) {
+            lengths[i] = ((size_t)rand()) % sizeof(buffers[i]);
+            for (size_t j = 0; j < lengths[i]; j++) {
+                buffers[i][j] = (uint8_t)(rand() & 0xff);
+            }
+            bufferptrs[i] = buffers[i];
+        }
+
+        uint8_t hashes[MAX_LANES * MD4_SIZE];
+        SimdHash(HashAlgorithmNTLM, lengths, bufferptrs, hashes);
+        for (size_t i = 0; i < lanes; i++) {
+            uint8_t expected[MD4_SIZE];
+            SimdHashSingle(HashAlgorithmNTLM, lengths[i], bufferptrs[i], expected);
+            ASSERT_EQ(0, memcmp(&hashes[i * MD4_SIZE], expected, MD4_SIZE))
+                << "iter=" << iter << " lane=" << i << " length=" << lengths[i];
+        }
+    }
+}
@@ -0,0 +1,117 @@
+//
+// output_test.cpp
+// Tests for the transposed (linear) and SoA digest output layouts
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class OutputTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static void HashRandomLanes(SimdHashContext* ctx, HashAlgorithm algo, unsigned seed) {
+    uint8_t buffers[MAX_LANES][64];
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    srand(seed);
+    for (size_t i = 0; i < SimdLanes(); i++) {
+        lengths[i] = ((size_t)rand()) % sizeof(buffers[i]);
+        for (size_t j = 0; j < lengths[i]; j++) {
+            buffers[i][j] = (uint8_t)(rand() & 0xff);
+        }
+        bufferptrs[i] = buffers[i];
+    }
+
+    SimdHashInit(ctx, algo);
+    SimdHashUpdate(ctx, lengths, bufferptrs);
+    SimdHashFinalize(ctx);
+}
+
+TEST_P(OutputTest, LinearMatchesPerLane) {
+    const HashAlgorithm algo = GetParam();
+    const size_t digestLen = GetHashWidth(algo);
+    SimdHashContext ctx;
+    HashRandomLanes(&ctx, algo, 30);
+
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    SimdHashGetHashes(&ctx, hashes);
+
+    for (size_t i = 0; i < SimdLanes(); i++) {
+        uint8_t expected[MAX_HASH_SIZE];
+        SimdHashGetHash(&ctx, expected, i);
+        EXPECT_EQ(0, memcmp(&hashes[i * digestLen], expected, digestLen)) << "Lane " << i;
+    }
+}
+
+TEST_P(OutputTest, SoALayout) {
+    const HashAlgorithm algo = GetParam();
+    const size_t lanes = SimdLanes();
+    const size_t hashDwords = GetHashWidth(algo) / sizeof(uint32_t);
+    SimdHashContext ctx;
+    HashRandomLanes(&ctx, algo, 31);
+
+    std::vector<uint32_t> soa(MAX_H_COUNT * MAX_LANES);
+    SimdHashGetHashesSoA(&ctx, (uint8_t*)soa.data());
+
+    for (size_t i = 0; i < lanes; i++) {
+        uint32_t expected[MAX_H_COUNT];
+        SimdHashGetHash(&ctx, (uint8_t*)expected, i);
+        for (size_t d = 0; d < hashDwords; d++) {
+            EXPECT_EQ(soa[d * lanes + i], expected[d]) << "Lane " << i << " dword " << d;
+        }
+    }
+}
+
+TEST_P(OutputTest, ExtendedLinearAndSoA) {
+    const HashAlgorithm algo = GetParam();
+    const size_t lanes = SimdLanes();
+    const size_t hashDwords = GetHashWidth(algo) / sizeof(uint32_t);
+
+    // Cover every mix of 16x16, 8x8, 4x4 and scalar rows
+    for (size_t count = hashDwords; count <= 40; count++) {
+        SimdHashContext ctx;
+        HashRandomLanes(&ctx, algo, 32);
+
+        std::vector<uint32_t> linear(count * MAX_LANES);
+        std::vector<uint32_t> soa(count * MAX_LANES);
+        SimdHashContext copy = ctx;
+        SimdHashExtendEntropyAndGetHashes(&ctx, (uint8_t*)linear.data(), count);
+        SimdHashExtendEntropyAndGetHashesSoA(&copy, (uint8_t*)soa.data(), count);
+
+        for (size_t i = 0; i < lanes; i++) {
+            std::vector<uint32_t> expected(count);
+            SimdHashGetHash(&ctx, (uint8_t*)expected.data(), i);
+            // Same recurrence as SimdHashSingleExtended
+            for (size_t d = hashDwords; d < count; d++) {
+                const uint32_t w15 = expected[d - hashDwords];
+                const uint32_t w2 = expected[d - 2];
+                const uint32_t s0 = ((w15 >> 7) | (w15 << 25)) ^ ((w15 >> 18) | (w15 << 14)) ^ (w15 >> 3);
+                const uint32_t s1 = ((w2 >> 17) | (w2 << 15)) ^ ((w2 >> 19) | (w2 << 13)) ^ (w2 >> 10);
+                expected[d] = expected[d - 3] + s0 + s1;
+            }
+            for (size_t d = 0; d < count; d++) {
+                ASSERT_EQ(linear[i * count + d], expected[d]) << "count " << count << " lane " << i << " dword " << d;
+                ASSERT_EQ(soa[d * lanes + i], expected[d]) << "count " << count << " lane " << i << " dword " << d;
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Output, OutputTest,
+    ::testing::Values(
+        HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256
+    ),
+    AlgoName
+);
@@ -0,0 +1,224 @@
+//
+// rules_test.cpp
+// Tests for the lane interleaved rule engine
+//
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+static size_t Position(char value) {
+    return value <= '9' ? value - '0' : value - 'A' + 10;
+}
+
+// Straightforward string implementation used as the reference. Returns
+// false when the candidate grows past RULE_MAX_LENGTH
+static bool Reference(const std::string& rule, std::string word, std::string& output) {
+    if (word.size() > RULE_MAX_LENGTH) {
+        return false;
+    }
+    for (size_t i = 0; i < rule.size(); i++) {
+        switch (rule[i]) {
+        case 'l':
+            for (auto& c : word) c = (char)tolower((unsigned char)c);
+            break;
+        case 'u':
+            for (auto& c : word) c = (char)toupper((unsigned char)c);
+            break;
+        case 'c':
+            for (auto& c : word) c = (char)tolower((unsigned char)c);
+            if (!word.empty()) word[0] = (char)toupper((unsigned char)word[0]);
+            break;
+        case 'C':
+            for (auto& c : word) c = (char)toupper((unsigned char)c);
+            if (!word.empty()) word[0] = (char)tolower((unsigned char)word[0]);
+            break;
+        case 't':
+            for (auto& c : word) c = isupper((unsigned char)c) ? (char)tolower((unsigned char)c) : (char)toupper((unsigned char)c);
+            break;
+        case 'T': {
+            const size_t n = Position(rule[++i]);
+            if (n < word.size()) {
+                char& c = word[n];
+                c = isupper((unsigned char)c) ? (char)tolower((unsigned char)c) : (char)toupper((unsigned char)c);
+            }
+            break;
+        }
+        case 'r':
+            std::reverse(word.begin(), word.end());
+            break;
+        case 'd':
+            word += word;
+            break;
+        case '$':
+            word.push_back(rule[++i]);
+            break;
+        case '^':
+            word.insert(word.begin(), rule[++i]);
+            break;
+        case '[':
+            if (!word.empty()) word.erase(0, 1);
+            break;
+        case ']':
+            if (!word.empty()) word.pop_back();
+            break;
+        case 'D': {
+            const size_t n = Position(rule[++i]);
+            if (n < word.size()) word.erase(n, 1);
+            break;
+        }
+        case '\'':
+            word.resize(std::min(word.size(), Position(rule[++i])));
+            break;
+        case 's': {
+            const char from = rule[++i];
+            const char to = rule[++i];
+            std::replace(word.begin(), word.end(), from, to);
+            break;
+        }
+        default:
+            break;
+        }
+        if (word.size() > RULE_MAX_LENGTH) {
+            return false;
+        }
+    }
+    output = word;
+    return true;
+}
+
+static std::string RandomWord(size_t maxLength) {
+    static const char alphabet[] = "abcXYZ019@!-_eoisaEOIS";
+    std::string word;
+    const size_t length = rand() % (maxLength + 1);
+    for (size_t i = 0; i < length; i++) {
+        word.push_back(alphabet[rand() % (sizeof(alphabet) - 1)]);
+    }
+    return word;
+}
+
+static std::string RandomRule() {
+    static const char* simple[] = { "l", "u", "c", "C", "t", "r", "d", "[", "]", ":" };
+    static const char positions[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::string rule;
+    const size_t count = 1 + rand() % 6;
+    for (size_t i = 0; i < count; i++) {
+        switch (rand() % 8) {
+        case 0: rule += std::string("$") + (char)('!' + rand() % 90); break;
+        case 1: rule += std::string("^") + (char)('!' + rand() % 90); break;
+        case 2: rule += std::string("T") + positions[rand() % 12]; break;
+        case 3: rule += std::string("D") + positions[rand() % 12]; break;
+        case 4: rule += std::string("'") + positions[rand() % 36]; break;
+        case 5: rule += std::string("s") + "aeoisXZ"[rand() % 7] + "4301$!z"[rand() % 7]; break;
+        default: rule += simple[rand() % 10]; break;
+        }
+    }
+    return rule;
+}
+
+class RulesTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+TEST_P(RulesTest, MatchesReference) {
+    const HashAlgorithm algo = GetParam();
+    const size_t lanes = SimdLanes();
+    const size_t digestLen = GetHashWidth(algo);
+    std::vector<uint8_t> hashes(lanes * digestLen);
+    uint8_t expected[MAX_HASH_SIZE];
+    SimdHashRuleWords words;
+    SimdHashContext ctx;
+
+    srand(46);
+    for (size_t group = 0; group < 50; group++) {
+        std::vector<std::string> base(lanes);
+        std::vector<size_t> lengths(lanes);
+        std::vector<const uint8_t*> buffers(lanes);
+        for (size_t lane = 0; lane < lanes; lane++) {
+            base[lane] = RandomWord(group == 0 ? RULE_MAX_LENGTH + 4 : 20);
+            lengths[lane] = base[lane].size();
+            buffers[lane] = (const uint8_t*)base[lane].data();
+        }
+        SimdHashRuleLoad(&words, lengths.data(), buffers.data());
+
+        // Every rule runs against the same loaded words
+        for (size_t r = 0; r < 40; r++) {
+            SimdHashRule rule;
+            const std::string text = RandomRule();
+            ASSERT_TRUE(SimdHashRuleCompile(&rule, text.c_str())) << text;
+
+            SimdHashResetContext(&ctx, algo);
+            const uint64_t valid = SimdHashRuleApply(&rule, &words, &ctx);
+            SimdHashFinalize(&ctx);
+            SimdHashGetHashes(&ctx, hashes.data());
+
+            for (size_t lane = 0; lane < lanes; lane++) {
+                std::string candidate;
+                const bool accepted = Reference(text, base[lane], candidate);
+                ASSERT_EQ(accepted, ((valid >> lane) & 1) != 0) << text << " on " << base[lane];
+                if (!accepted) {
+                    continue;
+                }
+                SimdHashSingle(algo, candidate.size(), (const uint8_t*)candidate.data(), expected);
+                EXPECT_EQ(memcmp(&hashes[lane * digestLen], expected, digestLen), 0)
+                    << text << " on " << base[lane] << " -> " << candidate;
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Algorithms,
+    RulesTest,
+    ::testing::Values(HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256),
+    AlgoName
+);
+
+static std::string ApplySingle(const char* text, const std::string& word) {
+    SimdHashRule rule;
+    uint8_t output[RULE_MAX_LENGTH];
+    EXPECT_TRUE(SimdHashRuleCompile(&rule, text));
+    const size_t length = SimdHashRuleApplySingle(&rule, (const uint8_t*)word.data(), word.size(), output);
+    return length == SIZE_MAX ? "<rejected>" : std::string((const char*)output, length);
+}
+
+TEST(Rules, Single) {
+    EXPECT_EQ(ApplySingle(":", "password"), "password");
+    EXPECT_EQ(ApplySingle("c $1 $2 $3", "pASSword"), "Password123");
+    EXPECT_EQ(ApplySingle("sa@ so0 se3", "password"), "p@ssw0rd");
+    EXPECT_EQ(ApplySingle("r", "abc"), "cba");
+    EXPECT_EQ(ApplySingle("d", "abc"), "abcabc");
+    EXPECT_EQ(ApplySingle("^x ^y", "abc"), "yxabc");
+    EXPECT_EQ(ApplySingle("t T0", "aBc"), "abC");
+    EXPECT_EQ(ApplySingle("'4", "password"), "pass");
+    EXPECT_EQ(ApplySingle("[ ] D1", "password"), "aswor");
+    EXPECT_EQ(ApplySingle("C", "password"), "pASSWORD");
+    EXPECT_EQ(ApplySingle("u", "p4ss"), "P4SS");
+    EXPECT_EQ(ApplySingle("d d", std::string(20, 'a')), "<rejected>");
+    EXPECT_EQ(ApplySingle("$a", std::string(RULE_MAX_LENGTH, 'a')), "<rejected>");
+}
+
+TEST(Rules, Compile) {
+    SimdHashRule rule;
+    EXPECT_TRUE(SimdHashRuleCompile(&rule, ""));
+    EXPECT_EQ(rule.Count, 0u);
+    EXPECT_TRUE(SimdHashRuleCompile(&rule, "l $1 sab"));
+    EXPECT_EQ(rule.Count, 3u);
+    EXPECT_FALSE(SimdHashRuleCompile(&rule, "$"));
+    EXPECT_FALSE(SimdHashRuleCompile(&rule, "sa"));
+    EXPECT_FALSE(SimdHashRuleCompile(&rule, "T"));
+    EXPECT_FALSE(SimdHashRuleCompile(&rule, "Tz"));
+    EXPECT_FALSE(SimdHashRuleCompile(&rule, "X"));
+    EXPECT_FALSE(SimdHashRuleCompile(&rule, std::string(RULE_MAX_OPS + 1, 'r').c_str()));
+}
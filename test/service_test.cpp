@@ -0,0 +1,130 @@
+//
+// service_test.cpp
+// Tests for the micro-batching hash service (simdhash::HashService)
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "SimdHashService.hpp"
+
+class ServiceTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static std::vector<std::vector<uint8_t>> RandomInputs(size_t count, size_t maxLength, unsigned seed) {
+    std::vector<std::vector<uint8_t>> inputs(count);
+    srand(seed);
+    for (auto& input : inputs) {
+        input.resize(((size_t)rand()) % (maxLength + 1));
+        for (auto& byte : input) {
+            byte = (uint8_t)(rand() & 0xff);
+        }
+    }
+    return inputs;
+}
+
+static std::vector<uint8_t> Expected(HashAlgorithm algo, const std::vector<uint8_t>& input) {
+    std::vector<uint8_t> digest(GetHashWidth(algo));
+    SimdHashSingle(algo, input.size(), input.data(), digest.data());
+    return digest;
+}
+
+TEST_P(ServiceTest, ConcurrentFutures) {
+    const HashAlgorithm algo = GetParam();
+    const size_t threads = 8;
+    const size_t perThread = 400;
+    simdhash::HashService service(algo, std::chrono::microseconds(200), 256);
+
+    std::vector<std::thread> workers;
+    std::atomic<size_t> mismatches{0};
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            auto inputs = RandomInputs(perThread, 150, (unsigned)t + 1);
+            std::vector<std::future<simdhash::Digest>> futures;
+            for (auto& input : inputs) {
+                futures.push_back(service.Submit(std::span<const uint8_t>(input)));
+            }
+            for (size_t i = 0; i < perThread; i++) {
+                if (futures[i].get() != Expected(algo, inputs[i])) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(0u, mismatches.load());
+}
+
+TEST_P(ServiceTest, Callbacks) {
+    const HashAlgorithm algo = GetParam();
+    const size_t count = 1000;
+    auto inputs = RandomInputs(count, 80, 99);
+    std::atomic<size_t> completed{0};
+    std::atomic<size_t> mismatches{0};
+
+    {
+        simdhash::HashService service(algo);
+        for (size_t i = 0; i < count; i++) {
+            service.Submit(std::span<const uint8_t>(inputs[i]), [&, i](std::span<const uint8_t> digest) {
+                const auto expected = Expected(algo, inputs[i]);
+                if (digest.size() != expected.size() ||
+                    memcmp(digest.data(), expected.data(), expected.size()) != 0) {
+                    mismatches++;
+                }
+                completed++;
+            });
+        }
+        // Destruction completes everything still queued
+    }
+
+    EXPECT_EQ(count, completed.load());
+    EXPECT_EQ(0u, mismatches.load());
+}
+
+TEST_P(ServiceTest, DeadlineFlushesPartialBatch) {
+    const HashAlgorithm algo = GetParam();
+    simdhash::HashService service(algo, std::chrono::microseconds(1000));
+
+    auto future = service.Submit(std::string_view("password"));
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(10)));
+
+    std::vector<uint8_t> input{'p', 'a', 's', 's', 'w', 'o', 'r', 'd'};
+    EXPECT_EQ(Expected(algo, input), future.get());
+}
+
+TEST_P(ServiceTest, RingSmallerThanBatch) {
+    // Slots are held until their group completes, so a ring with fewer
+    // slots than lanes has to drain through the deadline and be reused
+    const HashAlgorithm algo = GetParam();
+    simdhash::HashService service(algo, std::chrono::microseconds(50), 2);
+    auto inputs = RandomInputs(64, 200, 7);
+
+    std::vector<std::future<simdhash::Digest>> futures;
+    for (auto& input : inputs) {
+        futures.push_back(service.Submit(std::span<const uint8_t>(input)));
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        EXPECT_EQ(Expected(algo, inputs[i]), futures[i].get()) << "input=" << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Service, ServiceTest,
+    ::testing::Values(
+        HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256,
+        HashAlgorithmSHA512, HashAlgorithmNTLM
+    ),
+    AlgoName
+);
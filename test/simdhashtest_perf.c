@@ -93,7 +93,9 @@ PerformanceTests(
     for (size_t i = 0; i < Iterations; i++)
     {
         begin = timer_start();
-        if (SupportsOptimization(Algorithm))
+        if (SupportsOptimization(Algorithm) &&
+            (LENGTH <= GetOptimizedLength(Algorithm) ||
+             LENGTH <= GetOptimizedTwoBlockLength(Algorithm)))
         {
             SimdHashOptimized(
                 Algorithm,
@@ -135,6 +137,114 @@ PerformanceTests(
     printf("  Hashes/core/s : %zu\n", average * SimdLanes());
 }
 
+static long
+BatchNanoseconds(
+    const HashAlgorithm Algorithm,
+    const size_t Path,
+    const size_t Count,
+    const size_t Lengths[],
+    const uint8_t* const Buffers[],
+    const size_t Iterations
+)
+/*++
+	Returns the average time for one batch of Count inputs over
+	Iterations runs. Path 0 hashes each input alone, a power of
+	two hashes with the narrow engine of that many lanes, and
+	SIZE_MAX pads the batch out to every lane
+--*/
+{
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+    struct timespec begin;
+
+    for (size_t lane = 0; lane < SimdLanes(); lane++)
+    {
+        lengths[lane] = lane < Count ? Lengths[lane] : 0;
+        buffers[lane] = Buffers[lane < Count ? lane : 0];
+    }
+
+    begin = timer_start();
+    for (size_t i = 0; i < Iterations; i++)
+    {
+        if (Path == 0)
+        {
+            for (size_t j = 0; j < Count; j++)
+            {
+                SimdHashSingle(Algorithm, Lengths[j], Buffers[j], &hashes[j * MAX_HASH_SIZE]);
+            }
+        }
+        else if (Path == SIZE_MAX)
+        {
+            if (SupportsOptimization(Algorithm) && Lengths[0] <= GetOptimizedTwoBlockLength(Algorithm))
+            {
+                SimdHashOptimized(Algorithm, lengths, buffers, hashes);
+            }
+            else
+            {
+                SimdHash(Algorithm, lengths, buffers, hashes);
+            }
+        }
+        else
+        {
+            SimdHashNarrow(Algorithm, Path, Count, Lengths, Buffers, hashes);
+        }
+    }
+
+    return timer_end(begin) / (long)Iterations;
+}
+
+static void
+OccupancyTests(
+    const HashAlgorithm Algorithm,
+    const size_t Iterations
+)
+/*++
+	Prints the nanoseconds per batch of each kernel that
+	SimdHashAdaptive can choose, for every occupancy. These
+	are the measurements behind GetSingleCrossover and
+	GetNarrowLanes
+--*/
+{
+    static const size_t lengths[] = { 16, 100 };
+    uint8_t buffers[MAX_LANES][128];
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t sizes[MAX_LANES];
+
+    for (size_t i = 0; i < MAX_LANES; i++)
+    {
+        memset(buffers[i], (int)i, sizeof(buffers[i]));
+        bufferptrs[i] = &buffers[i][0];
+    }
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++)
+    {
+        for (size_t i = 0; i < MAX_LANES; i++)
+        {
+            sizes[i] = lengths[l];
+        }
+
+        printf("%s occupancy, %zu byte inputs (ns per batch)\n", HashAlgorithmToString(Algorithm), lengths[l]);
+        printf("  count   single  narrow4  narrow8  %2zu lanes\n", SimdLanes());
+        for (size_t count = 1; count <= SimdLanes(); count++)
+        {
+            printf("  %5zu  %7ld", count, BatchNanoseconds(Algorithm, 0, count, sizes, bufferptrs, Iterations));
+            for (size_t narrow = 4; narrow <= 8; narrow *= 2)
+            {
+                if (count <= narrow && narrow < SimdLanes())
+                {
+                    printf("  %7ld", BatchNanoseconds(Algorithm, narrow, count, sizes, bufferptrs, Iterations));
+                }
+                else
+                {
+                    printf("        -");
+                }
+            }
+            printf("  %9ld\n", BatchNanoseconds(Algorithm, SIZE_MAX, count, sizes, bufferptrs, Iterations));
+        }
+    }
+}
+
 int main(int argc, char* argv[])
 {
     HashAlgorithm algorithm;
@@ -144,7 +254,17 @@ int main(int argc, char* argv[])
     // If no arguments are passed, use the default
     // iterations will all algoritms
     //
-    if (argc == 1)
+    if (argc > 1 && strcmp(argv[1], "--occupancy") == 0)
+    {
+        const HashAlgorithm algorithms[] = {
+            HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256
+        };
+        for (size_t a = 0; a < sizeof(algorithms) / sizeof(algorithms[0]); a++)
+        {
+            OccupancyTests(algorithms[a], argc > 2 ? atoll(argv[2]) : 10000);
+        }
+    }
+    else if (argc == 1)
     {
         for (size_t a = 0; a < SimdHashAlgorithmCount; a++)
         {
@@ -0,0 +1,133 @@
+//
+// streampool_test.cpp
+// Tests for the pooled per-stream state (SimdHashStreamPool)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class StreamPoolTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static void CheckInterleaved(HashAlgorithm algo, size_t streams, size_t updates, size_t maxChunk, unsigned seed) {
+    const size_t digestLen = GetHashWidth(algo);
+    SimdHashStreamPool pool;
+    std::vector<std::vector<uint8_t>> data(streams);
+
+    ASSERT_TRUE(SimdHashStreamPoolInit(&pool, algo, streams));
+
+    // Feed random sized chunks to random streams
+    srand(seed);
+    for (size_t u = 0; u < updates; u++) {
+        const size_t stream = ((size_t)rand()) % streams;
+        const size_t length = ((size_t)rand()) % (maxChunk + 1);
+        std::vector<uint8_t> chunk(length + 1);
+        for (size_t j = 0; j < length; j++) {
+            chunk[j] = (uint8_t)(rand() & 0xff);
+        }
+        SimdHashStreamUpdate(&pool, stream, length, chunk.data());
+        data[stream].insert(data[stream].end(), chunk.begin(), chunk.begin() + length);
+    }
+
+    // Finalize in reverse order to check the scatter of digests
+    std::vector<size_t> ids(streams);
+    for (size_t i = 0; i < streams; i++) {
+        ids[i] = streams - 1 - i;
+    }
+    std::vector<uint8_t> hashes(streams * digestLen);
+    SimdHashStreamFinalize(&pool, streams, ids.data(), hashes.data());
+
+    for (size_t i = 0; i < streams; i++) {
+        uint8_t expected[MAX_HASH_SIZE];
+        SimdHashSingle(algo, data[ids[i]].size(), data[ids[i]].data(), expected);
+        ASSERT_EQ(0, memcmp(&hashes[i * digestLen], expected, digestLen))
+            << "stream=" << ids[i] << " length=" << data[ids[i]].size();
+    }
+
+    SimdHashStreamPoolDestroy(&pool);
+}
+
+TEST_P(StreamPoolTest, SmallChunks) {
+    CheckInterleaved(GetParam(), 37, 4000, 20, 1);
+}
+
+TEST_P(StreamPoolTest, LargeChunks) {
+    CheckInterleaved(GetParam(), 5, 300, 500, 2);
+}
+
+TEST_P(StreamPoolTest, SingleStream) {
+    CheckInterleaved(GetParam(), 1, 200, 130, 3);
+}
+
+TEST_P(StreamPoolTest, ResetAfterFinalize) {
+    const HashAlgorithm algo = GetParam();
+    const size_t digestLen = GetHashWidth(algo);
+    const uint8_t message[] = "The quick brown fox jumps over the lazy dog";
+    const size_t length = sizeof(message) - 1;
+    SimdHashStreamPool pool;
+    uint8_t expected[MAX_HASH_SIZE];
+    uint8_t hash[MAX_HASH_SIZE];
+    size_t id = 2;
+
+    ASSERT_TRUE(SimdHashStreamPoolInit(&pool, algo, 4));
+    SimdHashSingle(algo, length, message, expected);
+
+    for (int round = 0; round < 2; round++) {
+        SimdHashStreamUpdate(&pool, id, length, message);
+        SimdHashStreamFinalize(&pool, 1, &id, hash);
+        ASSERT_EQ(0, memcmp(hash, expected, digestLen)) << "round=" << round;
+    }
+
+    SimdHashStreamPoolDestroy(&pool);
+}
+
+TEST_P(StreamPoolTest, ResetDropsQueuedBlock) {
+    const HashAlgorithm algo = GetParam();
+    const size_t digestLen = GetHashWidth(algo);
+    const uint8_t block[64] = { 'x' };
+    const uint8_t message[] = "abc";
+    SimdHashStreamPool pool;
+    uint8_t expected[2][MAX_HASH_SIZE];
+    uint8_t hashes[2 * MAX_HASH_SIZE];
+    size_t ids[2] = { 0, 1 };
+
+    ASSERT_TRUE(SimdHashStreamPoolInit(&pool, algo, 4));
+    SimdHashSingle(algo, sizeof(block), block, expected[0]);
+    SimdHashSingle(algo, sizeof(message) - 1, message, expected[1]);
+
+    // Both streams queue a full block, then stream 1 starts over
+    SimdHashStreamUpdate(&pool, 0, sizeof(block), block);
+    SimdHashStreamUpdate(&pool, 1, sizeof(block), block);
+    SimdHashStreamReset(&pool, 1);
+    SimdHashStreamUpdate(&pool, 1, sizeof(message) - 1, message);
+    SimdHashStreamFinalize(&pool, 2, ids, hashes);
+
+    EXPECT_EQ(0, memcmp(&hashes[0], expected[0], digestLen));
+    EXPECT_EQ(0, memcmp(&hashes[digestLen], expected[1], digestLen));
+
+    SimdHashStreamPoolDestroy(&pool);
+}
+
+TEST(StreamPool, UnsupportedAlgorithm) {
+    SimdHashStreamPool pool;
+    EXPECT_FALSE(SimdHashStreamPoolInit(&pool, HashAlgorithmSHA512, 4));
+    EXPECT_FALSE(SimdHashStreamPoolInit(&pool, HashAlgorithmFNV1a_32, 4));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    StreamPool, StreamPoolTest,
+    ::testing::Values(
+        HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256
+    ),
+    AlgoName
+);
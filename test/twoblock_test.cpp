@@ -0,0 +1,102 @@
+//
+// twoblock_test.cpp
+// Tests for the two-block optimized path (56-119 byte inputs)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+class TwoBlockTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static void CheckAgainstSingle(
+    HashAlgorithm algo,
+    const size_t* lengths,
+    const uint8_t* const* bufferptrs,
+    const uint8_t* hashes)
+{
+    const size_t digestLen = GetHashWidth(algo);
+    for (size_t i = 0; i < SimdLanes(); i++) {
+        uint8_t expected[MAX_HASH_SIZE];
+        SimdHashSingle(algo, lengths[i], bufferptrs[i], expected);
+        ASSERT_EQ(0, memcmp(&hashes[i * digestLen], expected, digestLen))
+            << "algo=" << HashAlgorithmToString(algo) << " lane=" << i << " length=" << lengths[i];
+    }
+}
+
+TEST_P(TwoBlockTest, UniformLengths) {
+    const HashAlgorithm algo = GetParam();
+    const size_t maxLength = GetOptimizedTwoBlockLength(algo);
+    ASSERT_EQ(maxLength, (size_t)119);
+
+    uint8_t buffers[MAX_LANES][MAX_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE];
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    srand(56);
+    for (size_t len = 0; len <= maxLength; len++) {
+        for (size_t i = 0; i < SimdLanes(); i++) {
+            for (size_t j = 0; j < len; j++) {
+                buffers[i][j] = (uint8_t)(rand() & 0xff);
+            }
+            bufferptrs[i] = buffers[i];
+            lengths[i] = len;
+        }
+
+        uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+        SimdHashOptimizedTwoBlock(algo, lengths, bufferptrs, hashes);
+        CheckAgainstSingle(algo, lengths, bufferptrs, hashes);
+
+        // SimdHashOptimized dispatches to the same path for long inputs
+        SimdHashOptimized(algo, lengths, bufferptrs, hashes);
+        CheckAgainstSingle(algo, lengths, bufferptrs, hashes);
+    }
+}
+
+TEST_P(TwoBlockTest, MixedLengths) {
+    const HashAlgorithm algo = GetParam();
+    const size_t maxLength = GetOptimizedTwoBlockLength(algo);
+
+    uint8_t buffers[MAX_LANES][MAX_OPTIMIZED_TWO_BLOCK_BUFFER_SIZE];
+    const uint8_t* bufferptrs[MAX_LANES];
+    size_t lengths[MAX_LANES];
+
+    srand(119);
+    for (int iter = 0; iter < 200; iter++) {
+        for (size_t i = 0; i < SimdLanes(); i++) {
+            // Mix of single block, padding spill and full two block lanes
+            lengths[i] = ((size_t)rand()) % (maxLength + 1);
+            for (size_t j = 0; j < lengths[i]; j++) {
+                buffers[i][j] = (uint8_t)(rand() & 0xff);
+            }
+            bufferptrs[i] = buffers[i];
+        }
+
+        uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+        SimdHashOptimized(algo, lengths, bufferptrs, hashes);
+        CheckAgainstSingle(algo, lengths, bufferptrs, hashes);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TwoBlock, TwoBlockTest,
+    ::testing::Values(
+        HashAlgorithmMD4, HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256
+    ),
+    AlgoName
+);
+
+TEST(TwoBlock, UnsupportedAlgorithms) {
+    EXPECT_EQ(GetOptimizedTwoBlockLength(HashAlgorithmNTLM), (size_t)0);
+    EXPECT_EQ(GetOptimizedTwoBlockLength(HashAlgorithmSHA512), (size_t)0);
+    EXPECT_EQ(GetOptimizedTwoBlockLength(HashAlgorithmFNV1a_32), (size_t)0);
+}
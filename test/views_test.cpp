@@ -0,0 +1,101 @@
+//
+// views_test.cpp
+// Tests for the lazy hashing range adaptor (simdhash::views::hash)
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SimdHashViews.hpp"
+
+class ViewsTest : public ::testing::TestWithParam<HashAlgorithm> {};
+
+static std::string AlgoName(const ::testing::TestParamInfo<HashAlgorithm>& info) {
+    return HashAlgorithmToString(info.param);
+}
+
+static void ExpectDigest(HashAlgorithm algo, std::string_view input, std::span<const uint8_t> digest) {
+    uint8_t expected[MAX_HASH_SIZE];
+    SimdHashSingle(algo, input.size(), (const uint8_t*)input.data(), expected);
+    ASSERT_EQ(GetHashWidth(algo), digest.size());
+    EXPECT_EQ(0, memcmp(expected, digest.data(), digest.size())) << "length=" << input.size();
+}
+
+TEST_P(ViewsTest, Container) {
+    const HashAlgorithm algo = GetParam();
+    std::vector<std::string> inputs;
+    srand(3);
+    for (size_t i = 0; i < 75; i++) {
+        std::string s(((size_t)rand()) % 120, '\0');
+        for (auto& c : s) {
+            c = (char)(rand() & 0xff);
+        }
+        inputs.push_back(s);
+    }
+
+    size_t index = 0;
+    for (auto [input, digest] : inputs | simdhash::views::hash(algo)) {
+        ASSERT_LT(index, inputs.size());
+        EXPECT_EQ(inputs[index], input);
+        ExpectDigest(algo, input, digest);
+        index++;
+    }
+    EXPECT_EQ(inputs.size(), index);
+}
+
+TEST_P(ViewsTest, LazyGenerator) {
+    const HashAlgorithm algo = GetParam();
+
+    // Each element is a temporary string that only lives while it is pulled
+    auto numbers = std::views::iota(0, 1000) |
+        std::views::transform([](int i) { return "candidate" + std::to_string(i); });
+
+    int expected = 0;
+    for (auto [input, digest] : numbers | simdhash::views::hash(algo)) {
+        EXPECT_EQ("candidate" + std::to_string(expected), input);
+        ExpectDigest(algo, input, digest);
+        expected++;
+    }
+    EXPECT_EQ(1000, expected);
+}
+
+TEST_P(ViewsTest, InputsWiderThanBuffer) {
+    const HashAlgorithm algo = GetParam();
+    std::vector<std::string> inputs;
+    for (size_t length = 0; length < 300; length += 7) {
+        inputs.push_back(std::string(length, (char)('a' + length % 26)));
+    }
+
+    size_t index = 0;
+    for (auto [input, digest] : simdhash::views::hash<16>(inputs, algo)) {
+        EXPECT_EQ(inputs[index], input);
+        ExpectDigest(algo, input, digest);
+        index++;
+    }
+    EXPECT_EQ(inputs.size(), index);
+}
+
+TEST(Views, EmptyRange) {
+    std::vector<std::string_view> inputs;
+    size_t count = 0;
+    for (auto pair : inputs | simdhash::views::hash(HashAlgorithmMD5)) {
+        (void)pair;
+        count++;
+    }
+    EXPECT_EQ(0u, count);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Views, ViewsTest,
+    ::testing::Values(
+        HashAlgorithmMD5, HashAlgorithmSHA1, HashAlgorithmSHA256,
+        HashAlgorithmSHA512, HashAlgorithmNTLM, HashAlgorithmFNV1_64
+    ),
+    AlgoName
+);
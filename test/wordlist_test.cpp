@@ -0,0 +1,180 @@
+//
+// wordlist_test.cpp
+// Tests for the newline splitter and the memory mapped wordlist
+//
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+extern "C" {
+#include "simdhash.h"
+}
+
+// Reference splitter: newline separated, CR stripped, length filtered
+static std::vector<std::string> ReferenceLines(const std::string& data, size_t minLength, size_t maxLength) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start < data.size()) {
+        size_t end = data.find('\n', start);
+        if (end == std::string::npos) {
+            end = data.size();
+        }
+        std::string line = data.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.size() >= minLength && line.size() <= maxLength) {
+            lines.push_back(line);
+        }
+        start = end + 1;
+    }
+    return lines;
+}
+
+static std::vector<std::string> SplitAll(SimdHashLineSplitter& splitter, size_t count) {
+    std::vector<std::string> lines;
+    std::vector<size_t> lengths(count);
+    std::vector<const uint8_t*> buffers(count);
+    size_t found;
+    while ((found = SimdHashLineSplitterNext(&splitter, count, lengths.data(), buffers.data())) > 0) {
+        for (size_t i = 0; i < found; i++) {
+            lines.emplace_back((const char*)buffers[i], lengths[i]);
+        }
+        for (size_t i = found; i < count; i++) {
+            EXPECT_EQ(lengths[i], 0u);
+            EXPECT_NE(buffers[i], nullptr);
+        }
+    }
+    return lines;
+}
+
+static std::string RandomWordlist(size_t lines, size_t maxLength, unsigned seed) {
+    std::string data;
+    srand(seed);
+    for (size_t i = 0; i < lines; i++) {
+        const size_t length = ((size_t)rand()) % (maxLength + 1);
+        for (size_t j = 0; j < length; j++) {
+            data.push_back((char)('!' + rand() % 90));
+        }
+        if (rand() % 4 == 0) {
+            data.push_back('\r');
+        }
+        data.push_back('\n');
+    }
+    return data;
+}
+
+TEST(LineSplitter, MatchesReference) {
+    for (unsigned seed = 0; seed < 8; seed++) {
+        const std::string data = RandomWordlist(2000, seed * 20 + 3, seed);
+        SimdHashLineSplitter splitter;
+        SimdHashLineSplitterInit(&splitter, (const uint8_t*)data.data(), data.size(), 0, SIZE_MAX, true);
+        EXPECT_EQ(SplitAll(splitter, SimdLanes()), ReferenceLines(data, 0, SIZE_MAX)) << "seed " << seed;
+    }
+}
+
+TEST(LineSplitter, LengthFilter) {
+    const std::string data = RandomWordlist(5000, 80, 42);
+    SimdHashLineSplitter splitter;
+    SimdHashLineSplitterInit(&splitter, (const uint8_t*)data.data(), data.size(), 4, 20, true);
+    EXPECT_EQ(SplitAll(splitter, 7), ReferenceLines(data, 4, 20));
+}
+
+TEST(LineSplitter, Edges) {
+    const std::vector<std::string> cases = {
+        "",
+        "\n",
+        "\r\n",
+        "a",
+        "a\nb",
+        "a\r\nb\r\n",
+        "\n\n\n",
+        std::string(63, 'x') + "\n" + std::string(65, 'y') + "\n" + std::string(200, 'z'),
+        std::string(64, 'x') + "\r\n" + "tail\r",
+    };
+    for (const auto& data : cases) {
+        SimdHashLineSplitter splitter;
+        SimdHashLineSplitterInit(&splitter, (const uint8_t*)data.data(), data.size(), 0, SIZE_MAX, true);
+        EXPECT_EQ(SplitAll(splitter, 3), ReferenceLines(data, 0, SIZE_MAX)) << "input \"" << data << "\"";
+    }
+}
+
+TEST(LineSplitter, NotFinalLeavesPartialLine) {
+    const std::string data = "alpha\nbeta\r\ngam";
+    SimdHashLineSplitter splitter;
+    SimdHashLineSplitterInit(&splitter, (const uint8_t*)data.data(), data.size(), 0, SIZE_MAX, false);
+
+    const auto lines = SplitAll(splitter, 4);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], "alpha");
+    EXPECT_EQ(lines[1], "beta");
+    EXPECT_EQ(data.substr(splitter.LineStart), "gam");
+}
+
+class WordlistTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/simdhash_wordlist_XXXXXX";
+        const int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        m_Path = path;
+    }
+    void TearDown() override { unlink(m_Path.c_str()); }
+    void Write(const std::string& data) {
+        FILE* file = fopen(m_Path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        fwrite(data.data(), 1, data.size(), file);
+        fclose(file);
+    }
+    std::string m_Path;
+};
+
+TEST_F(WordlistTest, HashesStraightFromMapping) {
+    const std::string data = RandomWordlist(3000, 70, 7);
+    const auto expectedLines = ReferenceLines(data, 1, MAX_OPTIMIZED_BUFFER_SIZE);
+    Write(data);
+
+    SimdHashWordlist wordlist;
+    ASSERT_TRUE(SimdHashWordlistOpen(&wordlist, m_Path.c_str(), 1, MAX_OPTIMIZED_BUFFER_SIZE));
+
+    const size_t lanes = SimdLanes();
+    std::vector<size_t> lengths(lanes);
+    std::vector<const uint8_t*> buffers(lanes);
+    std::vector<uint8_t> hashes(lanes * SHA1_SIZE);
+    uint8_t expected[SHA1_SIZE];
+    size_t index = 0;
+    size_t found;
+
+    while ((found = SimdHashWordlistNext(&wordlist, lanes, lengths.data(), buffers.data())) > 0) {
+        SimdHashOptimized(HashAlgorithmSHA1, lengths.data(), buffers.data(), hashes.data());
+        for (size_t lane = 0; lane < found; lane++, index++) {
+            ASSERT_LT(index, expectedLines.size());
+            const auto& line = expectedLines[index];
+            ASSERT_EQ(std::string((const char*)buffers[lane], lengths[lane]), line);
+            SimdHashSingle(HashAlgorithmSHA1, line.size(), (const uint8_t*)line.data(), expected);
+            ASSERT_EQ(memcmp(&hashes[lane * SHA1_SIZE], expected, SHA1_SIZE), 0) << line;
+        }
+    }
+    EXPECT_EQ(index, expectedLines.size());
+    SimdHashWordlistClose(&wordlist);
+}
+
+TEST_F(WordlistTest, EmptyAndMissing) {
+    SimdHashWordlist wordlist;
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+
+    Write("");
+    ASSERT_TRUE(SimdHashWordlistOpen(&wordlist, m_Path.c_str(), 0, SIZE_MAX));
+    EXPECT_EQ(SimdHashWordlistNext(&wordlist, SimdLanes(), lengths, buffers), 0u);
+    SimdHashWordlistClose(&wordlist);
+
+    EXPECT_FALSE(SimdHashWordlistOpen(&wordlist, "/nonexistent/simdhash/wordlist", 0, SIZE_MAX));
+}
@@ -0,0 +1,962 @@
+//
+//  simdcrack.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "simdhash.h"
+
+#define MAX_THREADS (256)
+#define FILTER_BITS (24)
+#define MASK_CHUNK (1ull << 20)
+#define BLOCK_COUNT (8)
+#define BLOCK_SIZE (4 << 20)
+#define DEFAULT_POTFILE "simdcrack.pot"
+
+typedef enum _AttackMode
+{
+    AttackWordlist,
+    AttackMask
+} AttackMode;
+
+//
+// Sorted target digests with a bitmap over their leading bits so that
+// most candidates are rejected without a search
+//
+typedef struct _TargetSet
+{
+    uint8_t*  Digests;
+    size_t    Count;
+    size_t    Width;
+    uint64_t* Filter;
+    atomic_bool* Cracked;
+    atomic_size_t Remaining;
+} TargetSet;
+
+typedef struct _Worker
+{
+    pthread_t Thread;
+    struct _Cracker* Cracker;
+    // Candidates hashed, read by the status loop
+    _Atomic uint64_t Hashes __attribute__((aligned(64)));
+    uint64_t  LastHashes;
+} Worker;
+
+typedef struct _Cracker
+{
+    HashAlgorithm Algorithm;
+    AttackMode Mode;
+    TargetSet Targets;
+    SimdHashCompressedReader* Reader;
+    SimdHashRule* Rules;
+    size_t    RuleCount;
+    SimdHashMask Mask;
+    _Atomic uint64_t NextChunk;
+    FILE*     Potfile;
+    pthread_mutex_t OutputLock;
+    atomic_bool Stop;
+    atomic_size_t Running;
+    size_t    ThreadCount;
+    Worker    Workers[MAX_THREADS];
+} Cracker;
+
+static double
+Now(
+    void
+)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static const char*
+FormatRate(
+    const double Rate,
+    char* Buffer,
+    const size_t Size
+)
+{
+    static const char* units[] = { "H/s", "kH/s", "MH/s", "GH/s", "TH/s" };
+    double value = Rate;
+    size_t unit = 0;
+
+    while (value >= 1000.0 && unit < sizeof(units) / sizeof(units[0]) - 1)
+    {
+        value /= 1000.0;
+        unit++;
+    }
+    snprintf(Buffer, Size, "%.2f %s", value, units[unit]);
+    return Buffer;
+}
+
+// Digest width for qsort, which takes no context argument portably
+static size_t SortWidth;
+
+static int
+CompareDigest(
+    const void* Left,
+    const void* Right
+)
+{
+    return memcmp(Left, Right, SortWidth);
+}
+
+static inline uint32_t
+FilterIndex(
+    const uint8_t* Digest
+)
+{
+    return ((uint32_t)Digest[0] << 16 | (uint32_t)Digest[1] << 8 | Digest[2]) & ((1u << FILTER_BITS) - 1);
+}
+
+static bool
+ParseTargetLine(
+    char* Line,
+    const size_t Width,
+    uint8_t* Digest
+)
+/*++
+ Accepts a bare hex digest as hashcat takes it, or colon separated
+ fields such as john's user:hash, taking the first field that is a hex
+ digest of the right width
+--*/
+{
+    char* save = NULL;
+
+    for (char* field = strtok_r(Line, ":", &save); field != NULL; field = strtok_r(NULL, ":", &save))
+    {
+        const size_t length = strlen(field);
+        if (length == Width * 2 && SimdHashDecodeHex(field, length, Digest) == Width)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+FreeTargets(
+    TargetSet* Targets
+)
+{
+    free(Targets->Digests);
+    free(Targets->Filter);
+    free(Targets->Cracked);
+}
+
+static bool
+LoadTargets(
+    TargetSet* Targets,
+    const char* Path,
+    const size_t Width
+)
+{
+    FILE* file = fopen(Path, "r");
+    char* line = NULL;
+    size_t capacity = 0;
+    size_t allocated = 1024;
+
+    if (file == NULL)
+    {
+        perror(Path);
+        return false;
+    }
+
+    memset(Targets, 0, sizeof(*Targets));
+    Targets->Width = Width;
+    Targets->Digests = malloc(allocated * Width);
+    bool ok = Targets->Digests != NULL;
+
+    while (ok && getline(&line, &capacity, file) >= 0)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (Targets->Count == allocated)
+        {
+            uint8_t* digests = realloc(Targets->Digests, allocated * 2 * Width);
+            if (digests == NULL)
+            {
+                ok = false;
+                break;
+            }
+            Targets->Digests = digests;
+            allocated *= 2;
+        }
+        if (ParseTargetLine(line, Width, &Targets->Digests[Targets->Count * Width]))
+        {
+            Targets->Count++;
+        }
+    }
+    free(line);
+    fclose(file);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Out of memory loading %s\n", Path);
+        FreeTargets(Targets);
+        memset(Targets, 0, sizeof(*Targets));
+        return false;
+    }
+
+    // Sort and drop duplicates
+    SortWidth = Width;
+    qsort(Targets->Digests, Targets->Count, Width, CompareDigest);
+    size_t unique = 0;
+    for (size_t i = 0; i < Targets->Count; i++)
+    {
+        if (unique == 0 || memcmp(&Targets->Digests[(unique - 1) * Width], &Targets->Digests[i * Width], Width) != 0)
+        {
+            memmove(&Targets->Digests[unique * Width], &Targets->Digests[i * Width], Width);
+            unique++;
+        }
+    }
+    Targets->Count = unique;
+
+    Targets->Filter = calloc((1ull << FILTER_BITS) / 64, sizeof(uint64_t));
+    Targets->Cracked = calloc(Targets->Count + 1, sizeof(atomic_bool));
+    if (Targets->Filter == NULL || Targets->Cracked == NULL)
+    {
+        fprintf(stderr, "Out of memory loading %s\n", Path);
+        FreeTargets(Targets);
+        memset(Targets, 0, sizeof(*Targets));
+        return false;
+    }
+    for (size_t i = 0; i < Targets->Count; i++)
+    {
+        const uint32_t bit = FilterIndex(&Targets->Digests[i * Width]);
+        Targets->Filter[bit / 64] |= 1ull << (bit % 64);
+    }
+    atomic_init(&Targets->Remaining, Targets->Count);
+
+    return Targets->Count > 0;
+}
+
+static inline size_t
+LookupTarget(
+    const TargetSet* Targets,
+    const uint8_t* Digest
+)
+{
+    const uint32_t bit = FilterIndex(Digest);
+    size_t low = 0;
+    size_t high = Targets->Count;
+
+    if (!(Targets->Filter[bit / 64] & (1ull << (bit % 64))))
+    {
+        return SIZE_MAX;
+    }
+
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        const int order = memcmp(&Targets->Digests[middle * Targets->Width], Digest, Targets->Width);
+        if (order == 0)
+        {
+            return middle;
+        }
+        if (order < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return SIZE_MAX;
+}
+
+static void
+WritePlain(
+    FILE* File,
+    const uint8_t* Plain,
+    const size_t Length
+)
+/*++
+ Plains with separators or unprintable bytes are written as $HEX[..]
+ like hashcat does
+--*/
+{
+    bool printable = true;
+
+    for (size_t i = 0; i < Length; i++)
+    {
+        printable &= Plain[i] >= 0x20 && Plain[i] < 0x7f && Plain[i] != ':';
+    }
+
+    if (printable)
+    {
+        fwrite(Plain, 1, Length, File);
+        return;
+    }
+
+    fputs("$HEX[", File);
+    for (size_t i = 0; i < Length; i++)
+    {
+        fprintf(File, "%02x", Plain[i]);
+    }
+    fputc(']', File);
+}
+
+static void
+ReportCrack(
+    Cracker* Cracker,
+    const size_t Target,
+    const uint8_t* Plain,
+    const size_t Length
+)
+{
+    TargetSet* targets = &Cracker->Targets;
+    char hex[MAX_HASH_SIZE * 2 + 1];
+
+    // Several lanes or threads may find the same target
+    if (atomic_exchange(&targets->Cracked[Target], true))
+    {
+        return;
+    }
+
+    hex[SimdHashEncodeHex(&targets->Digests[Target * targets->Width], targets->Width, hex, false)] = '\0';
+
+    pthread_mutex_lock(&Cracker->OutputLock);
+    if (Cracker->Potfile != NULL)
+    {
+        fprintf(Cracker->Potfile, "%s:", hex);
+        WritePlain(Cracker->Potfile, Plain, Length);
+        fputc('\n', Cracker->Potfile);
+        fflush(Cracker->Potfile);
+    }
+    printf("%s:", hex);
+    WritePlain(stdout, Plain, Length);
+    putchar('\n');
+    fflush(stdout);
+    pthread_mutex_unlock(&Cracker->OutputLock);
+
+    if (atomic_fetch_sub(&targets->Remaining, 1) == 1)
+    {
+        atomic_store(&Cracker->Stop, true);
+    }
+}
+
+static void
+LoadPotfile(
+    Cracker* Cracker,
+    const char* Path
+)
+/*++
+ Targets already in the potfile are not searched for again
+--*/
+{
+    TargetSet* targets = &Cracker->Targets;
+    FILE* file = fopen(Path, "r");
+    uint8_t digest[MAX_HASH_SIZE];
+    char* line = NULL;
+    size_t capacity = 0;
+
+    if (file == NULL)
+    {
+        return;
+    }
+
+    while (getline(&line, &capacity, file) >= 0)
+    {
+        const size_t length = strcspn(line, ":");
+        if (length == targets->Width * 2 && SimdHashDecodeHex(line, length, digest) == targets->Width)
+        {
+            const size_t target = LookupTarget(targets, digest);
+            if (target != SIZE_MAX && !atomic_exchange(&targets->Cracked[target], true))
+            {
+                atomic_fetch_sub(&targets->Remaining, 1);
+            }
+        }
+    }
+    free(line);
+    fclose(file);
+}
+
+static size_t
+LoadRules(
+    const char* Path,
+    SimdHashRule** Rules
+)
+{
+    FILE* file = fopen(Path, "r");
+    char* line = NULL;
+    size_t capacity = 0;
+    size_t count = 0;
+    size_t allocated = 64;
+    size_t number = 0;
+
+    if (file == NULL)
+    {
+        perror(Path);
+        return 0;
+    }
+
+    *Rules = malloc(allocated * sizeof(SimdHashRule));
+    bool ok = *Rules != NULL;
+
+    while (ok && getline(&line, &capacity, file) >= 0)
+    {
+        number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#')
+        {
+            continue;
+        }
+        if (count == allocated)
+        {
+            SimdHashRule* rules = realloc(*Rules, allocated * 2 * sizeof(SimdHashRule));
+            if (rules == NULL)
+            {
+                ok = false;
+                break;
+            }
+            *Rules = rules;
+            allocated *= 2;
+        }
+        if (!SimdHashRuleCompile(&(*Rules)[count], line))
+        {
+            fprintf(stderr, "%s:%zu: skipping unsupported rule '%s'\n", Path, number, line);
+            continue;
+        }
+        count++;
+    }
+    free(line);
+    fclose(file);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Out of memory loading %s\n", Path);
+        free(*Rules);
+        *Rules = NULL;
+        return 0;
+    }
+    return count;
+}
+
+static inline size_t
+FindTargets(
+    Cracker* Cracker,
+    const uint8_t* Hashes,
+    const uint64_t Lanes,
+    size_t Targets[]
+)
+/*++
+ Looks up the digest of every lane set in Lanes, storing the target it
+ matches or SIZE_MAX, and returns how many lanes matched
+--*/
+{
+    const size_t width = Cracker->Targets.Width;
+    size_t matches = 0;
+
+    for (size_t lane = 0; lane < SimdLanes(); lane++)
+    {
+        Targets[lane] = (Lanes >> lane) & 1 ?
+            LookupTarget(&Cracker->Targets, &Hashes[lane * width]) : SIZE_MAX;
+        matches += Targets[lane] != SIZE_MAX;
+    }
+    return matches;
+}
+
+static inline uint64_t
+LaneMask(
+    const size_t Count
+)
+{
+    return Count >= 64 ? UINT64_MAX : (1ull << Count) - 1;
+}
+
+static void
+RunWordlist(
+    Worker* Worker
+)
+{
+    Cracker* cracker = Worker->Cracker;
+    const size_t lanes = SimdLanes();
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    size_t targets[MAX_LANES];
+    SimdHashInputBlock* block;
+
+    while (!atomic_load_explicit(&cracker->Stop, memory_order_relaxed) &&
+           (block = SimdHashCompressedAcquire(cracker->Reader)) != NULL)
+    {
+        size_t found;
+        while (!atomic_load_explicit(&cracker->Stop, memory_order_relaxed) &&
+               (found = SimdHashLineSplitterNext(&block->Splitter, lanes, lengths, buffers)) > 0)
+        {
+            SimdHashAdaptive(cracker->Algorithm, found, lengths, buffers, hashes);
+            if (FindTargets(cracker, hashes, LaneMask(found), targets) > 0)
+            {
+                for (size_t lane = 0; lane < found; lane++)
+                {
+                    if (targets[lane] != SIZE_MAX)
+                    {
+                        ReportCrack(cracker, targets[lane], buffers[lane], lengths[lane]);
+                    }
+                }
+            }
+            atomic_fetch_add_explicit(&Worker->Hashes, found, memory_order_relaxed);
+        }
+        SimdHashCompressedRelease(cracker->Reader, block);
+    }
+}
+
+static void
+RunRules(
+    Worker* Worker
+)
+/*++
+ Each lane group of words is interleaved once and every rule is applied
+ to it in the context's message buffer
+--*/
+{
+    Cracker* cracker = Worker->Cracker;
+    const size_t lanes = SimdLanes();
+    size_t lengths[MAX_LANES];
+    const uint8_t* buffers[MAX_LANES];
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    uint8_t plain[RULE_MAX_LENGTH];
+    size_t targets[MAX_LANES];
+    SimdHashRuleWords words;
+    SimdHashContext context;
+    SimdHashInputBlock* block;
+
+    while (!atomic_load_explicit(&cracker->Stop, memory_order_relaxed) &&
+           (block = SimdHashCompressedAcquire(cracker->Reader)) != NULL)
+    {
+        size_t found;
+        while (!atomic_load_explicit(&cracker->Stop, memory_order_relaxed) &&
+               (found = SimdHashLineSplitterNext(&block->Splitter, lanes, lengths, buffers)) > 0)
+        {
+            SimdHashRuleLoad(&words, lengths, buffers);
+            for (size_t r = 0; r < cracker->RuleCount; r++)
+            {
+                const SimdHashRule* rule = &cracker->Rules[r];
+
+                SimdHashResetContext(&context, cracker->Algorithm);
+                const uint64_t valid = SimdHashRuleApply(rule, &words, &context) & LaneMask(found);
+                SimdHashFinalize(&context);
+                SimdHashGetHashes(&context, hashes);
+
+                if (FindTargets(cracker, hashes, valid, targets) > 0)
+                {
+                    for (size_t lane = 0; lane < found; lane++)
+                    {
+                        if (targets[lane] != SIZE_MAX)
+                        {
+                            const size_t length = SimdHashRuleApplySingle(rule, buffers[lane], lengths[lane], plain);
+                            ReportCrack(cracker, targets[lane], plain, length);
+                        }
+                    }
+                }
+            }
+            atomic_fetch_add_explicit(&Worker->Hashes, found * cracker->RuleCount, memory_order_relaxed);
+        }
+        SimdHashCompressedRelease(cracker->Reader, block);
+    }
+}
+
+static void
+RunMask(
+    Worker* Worker
+)
+/*++
+ Threads take fixed size chunks of the keyspace in turn
+--*/
+{
+    Cracker* cracker = Worker->Cracker;
+    uint8_t hashes[MAX_LANES * MAX_HASH_SIZE];
+    uint8_t plain[MASK_MAX_LENGTH];
+    size_t targets[MAX_LANES];
+    SimdHashMaskGenerator generator;
+    SimdHashContext context;
+
+    while (!atomic_load_explicit(&cracker->Stop, memory_order_relaxed))
+    {
+        const uint64_t chunk = atomic_fetch_add(&cracker->NextChunk, 1);
+        if (chunk >= (cracker->Mask.Keyspace + MASK_CHUNK - 1) / MASK_CHUNK)
+        {
+            break;
+        }
+
+        uint64_t index = chunk * MASK_CHUNK;
+        size_t found;
+
+        SimdHashMaskGeneratorInit(&generator, &cracker->Mask, index, MASK_CHUNK);
+        SimdHashResetContext(&context, cracker->Algorithm);
+        while ((found = SimdHashMaskGeneratorNext(&generator, &context)) > 0)
+        {
+            SimdHashFinalize(&context);
+            SimdHashGetHashes(&context, hashes);
+
+            if (FindTargets(cracker, hashes, LaneMask(found), targets) > 0)
+            {
+                for (size_t lane = 0; lane < found; lane++)
+                {
+                    if (targets[lane] != SIZE_MAX)
+                    {
+                        const size_t length = SimdHashMaskCandidate(&cracker->Mask, index + lane, plain);
+                        ReportCrack(cracker, targets[lane], plain, length);
+                    }
+                }
+            }
+
+            index += found;
+            atomic_fetch_add_explicit(&Worker->Hashes, found, memory_order_relaxed);
+            SimdHashResetContext(&context, cracker->Algorithm);
+        }
+    }
+}
+
+static void*
+WorkerThread(
+    void* Parameter
+)
+{
+    Worker* worker = Parameter;
+    Cracker* cracker = worker->Cracker;
+
+    if (cracker->Mode == AttackMask)
+    {
+        RunMask(worker);
+    }
+    else if (cracker->RuleCount > 0)
+    {
+        RunRules(worker);
+    }
+    else
+    {
+        RunWordlist(worker);
+    }
+
+    atomic_fetch_sub(&cracker->Running, 1);
+    return NULL;
+}
+
+static void
+PrintStatus(
+    Cracker* Cracker,
+    const double Interval,
+    const double Elapsed,
+    const bool PerThread
+)
+/*++
+ Rates are over the last interval, the total is over the whole run
+--*/
+{
+    char rate[32];
+    uint64_t total = 0;
+    uint64_t recent = 0;
+
+    pthread_mutex_lock(&Cracker->OutputLock);
+    for (size_t i = 0; i < Cracker->ThreadCount; i++)
+    {
+        Worker* worker = &Cracker->Workers[i];
+        const uint64_t hashes = atomic_load_explicit(&worker->Hashes, memory_order_relaxed);
+        const uint64_t delta = hashes - worker->LastHashes;
+
+        if (PerThread)
+        {
+            fprintf(stderr, "  Thread %3zu: %s\n", i, FormatRate(delta / Interval, rate, sizeof(rate)));
+        }
+        worker->LastHashes = hashes;
+        total += hashes;
+        recent += delta;
+    }
+    fprintf(stderr, "Speed: %s (%s average), %llu candidates, %zu/%zu cracked, %.0fs\n",
+        FormatRate(recent / Interval, rate, sizeof(rate)),
+        FormatRate(Elapsed > 0 ? total / Elapsed : 0, (char[32]){ 0 }, 32),
+        (unsigned long long)total,
+        Cracker->Targets.Count - atomic_load(&Cracker->Targets.Remaining),
+        Cracker->Targets.Count,
+        Elapsed);
+    pthread_mutex_unlock(&Cracker->OutputLock);
+}
+
+static void
+Usage(
+    const char* Program
+)
+{
+    fprintf(stderr,
+        "Usage: %s [options] <targets> <wordlist|mask>\n"
+        "  -m <algorithm>  md4, md5, sha1, sha256, ... (detected from the targets if omitted)\n"
+        "  -a <mode>       0 or wordlist (default), 3 or mask\n"
+        "  -r <rules>      hashcat style rule file, wordlist mode only\n"
+        "  -1..-4 <chars>  custom mask charsets\n"
+        "  -t <threads>    worker threads (default: online CPUs)\n"
+        "  -o <potfile>    potfile to append cracks to (default " DEFAULT_POTFILE ")\n"
+        "  -s <seconds>    status interval, 0 for a final summary only (default 10)\n"
+        "  -q              no per thread rates\n",
+        Program);
+}
+
+static HashAlgorithm
+DetectTargetAlgorithm(
+    const char* Path
+)
+/*++
+ Uses the length of the first hex field of the first target line
+--*/
+{
+    FILE* file = fopen(Path, "r");
+    char* line = NULL;
+    size_t capacity = 0;
+    HashAlgorithm algorithm = HashAlgorithmUndefined;
+
+    if (file == NULL)
+    {
+        return HashAlgorithmUndefined;
+    }
+
+    while (algorithm == HashAlgorithmUndefined && getline(&line, &capacity, file) >= 0)
+    {
+        char* save = NULL;
+        line[strcspn(line, "\r\n")] = '\0';
+        for (char* field = strtok_r(line, ":", &save); field != NULL; field = strtok_r(NULL, ":", &save))
+        {
+            if (strspn(field, "0123456789abcdefABCDEF") == strlen(field))
+            {
+                algorithm = DetectHashAlgorithmHex(strlen(field));
+                if (algorithm != HashAlgorithmUndefined)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    free(line);
+    fclose(file);
+    return algorithm;
+}
+
+int main(int argc, char* argv[])
+{
+    static Cracker cracker;
+    const char* custom[MASK_CUSTOM_CHARSETS] = { NULL };
+    const char* rulesPath = NULL;
+    const char* potfilePath = DEFAULT_POTFILE;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    double interval = 10;
+    bool perThread = true;
+    int option;
+
+    cracker.Algorithm = HashAlgorithmUndefined;
+    cracker.Mode = AttackWordlist;
+
+    while ((option = getopt(argc, argv, "m:a:r:1:2:3:4:t:o:s:qh")) != -1)
+    {
+        switch (option)
+        {
+        case 'm':
+            cracker.Algorithm = ParseHashAlgorithm(optarg);
+            if (cracker.Algorithm == HashAlgorithmUndefined)
+            {
+                fprintf(stderr, "Invalid hash algorithm\n");
+                return 1;
+            }
+            break;
+        case 'a':
+            if (strcmp(optarg, "0") == 0 || strcmp(optarg, "wordlist") == 0)
+            {
+                cracker.Mode = AttackWordlist;
+            }
+            else if (strcmp(optarg, "3") == 0 || strcmp(optarg, "mask") == 0)
+            {
+                cracker.Mode = AttackMask;
+            }
+            else
+            {
+                fprintf(stderr, "Invalid attack mode\n");
+                return 1;
+            }
+            break;
+        case 'r':
+            rulesPath = optarg;
+            break;
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+            custom[option - '1'] = optarg;
+            break;
+        case 't':
+            threads = atol(optarg);
+            break;
+        case 'o':
+            potfilePath = optarg;
+            break;
+        case 's':
+            interval = atof(optarg);
+            break;
+        case 'q':
+            perThread = false;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (argc - optind != 2)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+    if (cracker.Mode == AttackMask && rulesPath != NULL)
+    {
+        fprintf(stderr, "Rules only apply to wordlist attacks\n");
+        Usage(argv[0]);
+        return 1;
+    }
+    const char* targetsPath = argv[optind];
+    const char* input = argv[optind + 1];
+
+    if (cracker.Algorithm == HashAlgorithmUndefined)
+    {
+        cracker.Algorithm = DetectTargetAlgorithm(targetsPath);
+        if (cracker.Algorithm == HashAlgorithmUndefined)
+        {
+            fprintf(stderr, "Unable to detect the hash algorithm, use -m\n");
+            return 1;
+        }
+    }
+
+    // Masks and rules write straight into the single block message buffer
+    const bool laneLayout = cracker.Mode == AttackMask || rulesPath != NULL;
+    if (laneLayout &&
+        (!SupportsOptimization(cracker.Algorithm) || cracker.Algorithm == HashAlgorithmNTLM))
+    {
+        fprintf(stderr, "%s is not supported by mask or rule attacks\n", HashAlgorithmToString(cracker.Algorithm));
+        return 1;
+    }
+    if (threads < 1 || threads > MAX_THREADS)
+    {
+        threads = threads < 1 ? 1 : MAX_THREADS;
+    }
+    cracker.ThreadCount = (size_t)threads;
+
+    if (!LoadTargets(&cracker.Targets, targetsPath, GetHashWidth(cracker.Algorithm)))
+    {
+        fprintf(stderr, "No %s targets in %s\n", HashAlgorithmToString(cracker.Algorithm), targetsPath);
+        return 1;
+    }
+    LoadPotfile(&cracker, potfilePath);
+    if (atomic_load(&cracker.Targets.Remaining) == 0)
+    {
+        fprintf(stderr, "All targets are already in %s\n", potfilePath);
+        FreeTargets(&cracker.Targets);
+        return 0;
+    }
+
+    if (cracker.Mode == AttackMask)
+    {
+        if (!SimdHashMaskParse(&cracker.Mask, input, custom))
+        {
+            fprintf(stderr, "Invalid mask %s\n", input);
+            return 1;
+        }
+    }
+    else
+    {
+        size_t maxLength = SIZE_MAX;
+        if (rulesPath != NULL)
+        {
+            cracker.RuleCount = LoadRules(rulesPath, &cracker.Rules);
+            if (cracker.RuleCount == 0)
+            {
+                fprintf(stderr, "No usable rules in %s\n", rulesPath);
+                return 1;
+            }
+            maxLength = RULE_MAX_LENGTH;
+        }
+        cracker.Reader = SimdHashCompressedOpen(input, 0, maxLength, BLOCK_COUNT, BLOCK_SIZE);
+        if (cracker.Reader == NULL)
+        {
+            // errno only describes the failure when the file itself could not be opened
+            if (access(input, R_OK) != 0)
+            {
+                perror(input);
+            }
+            else
+            {
+                fprintf(stderr, "%s: unsupported or corrupt compressed input\n", input);
+            }
+            return 1;
+        }
+    }
+
+    cracker.Potfile = fopen(potfilePath, "a");
+    if (cracker.Potfile == NULL)
+    {
+        perror(potfilePath);
+    }
+    pthread_mutex_init(&cracker.OutputLock, NULL);
+
+    fprintf(stderr, "Cracking %zu %s targets with %zu threads of %zu lanes\n",
+        atomic_load(&cracker.Targets.Remaining), HashAlgorithmToString(cracker.Algorithm),
+        cracker.ThreadCount, SimdLanes());
+
+    const double start = Now();
+    double last = start;
+
+    atomic_init(&cracker.Running, cracker.ThreadCount);
+    for (size_t i = 0; i < cracker.ThreadCount; i++)
+    {
+        cracker.Workers[i].Cracker = &cracker;
+        pthread_create(&cracker.Workers[i].Thread, NULL, WorkerThread, &cracker.Workers[i]);
+    }
+
+    while (atomic_load(&cracker.Running) > 0)
+    {
+        usleep(100000);
+        const double now = Now();
+        if (interval > 0 && now - last >= interval)
+        {
+            PrintStatus(&cracker, now - last, now - start, perThread);
+            last = now;
+        }
+    }
+
+    for (size_t i = 0; i < cracker.ThreadCount; i++)
+    {
+        pthread_join(cracker.Workers[i].Thread, NULL);
+    }
+
+    const double end = Now();
+    PrintStatus(&cracker, end - last > 0 ? end - last : 1, end - start, false);
+
+    bool failed = false;
+    if (cracker.Reader != NULL)
+    {
+        failed = SimdHashCompressedFailed(cracker.Reader);
+        if (failed)
+        {
+            fprintf(stderr, "Error reading %s\n", input);
+        }
+        SimdHashCompressedClose(cracker.Reader);
+    }
+    if (cracker.Potfile != NULL)
+    {
+        fclose(cracker.Potfile);
+    }
+    pthread_mutex_destroy(&cracker.OutputLock);
+    free(cracker.Rules);
+    FreeTargets(&cracker.Targets);
+
+    return failed ? 1 : 0;
+}
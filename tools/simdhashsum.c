@@ -0,0 +1,759 @@
+//
+//  simdhashsum.c
+//  SimdHash
+//
+//  Created by Gareth Evans on 18/10/2026.
+//  Copyright © 2026 Gareth Evans. All rights reserved.
+//
+
+// nftw and madvise
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <getopt.h>
+#include <libgen.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "simdhash.h"
+
+#define MAX_THREADS (256)
+#define CHUNK_SIZE (64 * 1024)
+#define LARGE_FILE (8 * 1024 * 1024)
+#define PROGRAM "simdhashsum"
+
+typedef struct _FileResult
+{
+    uint8_t   Digest[MAX_HASH_SIZE];
+    int       Error;
+    bool      Done;
+} FileResult;
+
+//
+// Files are taken from a shared list by the workers in any order, while
+// the main thread prints results in list order as they complete
+//
+typedef struct _Summer
+{
+    HashAlgorithm Algorithm;
+    size_t    DigestSize;
+    char**    Paths;
+    size_t    Count;
+    FileResult* Results;
+    atomic_size_t Next;
+    _Atomic uint64_t Bytes;
+    pthread_mutex_t Lock;
+    pthread_cond_t Progress;
+} Summer;
+
+//
+// A lane's file. Each worker keeps one per lane and refills it with the
+// next file as soon as its file is finished
+//
+typedef struct _Slot
+{
+    int       Fd;
+    size_t    File;
+    uint8_t*  Data;
+    size_t    Length;
+    size_t    Offset;
+} Slot;
+
+typedef struct _PathList
+{
+    char**    Paths;
+    size_t    Count;
+    size_t    Allocated;
+} PathList;
+
+static PathList* WalkList;
+
+static void
+AddPath(
+    PathList* List,
+    const char* Path
+)
+{
+    if (List->Count == List->Allocated)
+    {
+        List->Allocated = List->Allocated ? List->Allocated * 2 : 1024;
+        List->Paths = realloc(List->Paths, List->Allocated * sizeof(char*));
+    }
+    List->Paths[List->Count++] = strdup(Path);
+}
+
+static int
+WalkEntry(
+    const char* Path,
+    const struct stat* Status,
+    int Type,
+    struct FTW* Walk
+)
+{
+    if (Type == FTW_F)
+    {
+        AddPath(WalkList, Path);
+    }
+    return 0;
+}
+
+static void
+Complete(
+    Summer* Summer,
+    const size_t File,
+    const uint8_t* Digest,
+    const int Error
+)
+{
+    FileResult* result = &Summer->Results[File];
+
+    if (Digest != NULL)
+    {
+        memcpy(result->Digest, Digest, Summer->DigestSize);
+    }
+    result->Error = Error;
+
+    pthread_mutex_lock(&Summer->Lock);
+    result->Done = true;
+    pthread_cond_broadcast(&Summer->Progress);
+    pthread_mutex_unlock(&Summer->Lock);
+}
+
+static bool
+HashLargeFile(
+    Summer* Summer,
+    const size_t File,
+    const int Fd
+)
+/*++
+ A single long stream gains nothing from the lanes, so large regular
+ files are mapped and hashed in one call to SimdHashSingle instead
+--*/
+{
+    uint8_t digest[MAX_HASH_SIZE];
+    struct stat info;
+
+    if (fstat(Fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size < LARGE_FILE)
+    {
+        return false;
+    }
+
+    void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    madvise(mapping, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+    SimdHashSingle(Summer->Algorithm, (size_t)info.st_size, mapping, digest);
+    munmap(mapping, (size_t)info.st_size);
+    atomic_fetch_add_explicit(&Summer->Bytes, (uint64_t)info.st_size, memory_order_relaxed);
+    Complete(Summer, File, digest, 0);
+    return true;
+}
+
+static bool
+OpenNext(
+    Summer* Summer,
+    Slot* Slot
+)
+/*++
+ Opens the next file of the list into Slot, recording files that cannot
+ be opened as failed. Returns false once the list is exhausted
+--*/
+{
+    for (;;)
+    {
+        const size_t file = atomic_fetch_add(&Summer->Next, 1);
+        if (file >= Summer->Count)
+        {
+            return false;
+        }
+
+        const char* path = Summer->Paths[file];
+        const int fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            Complete(Summer, file, NULL, errno);
+            continue;
+        }
+
+        if (HashLargeFile(Summer, file, fd))
+        {
+            close(fd);
+            continue;
+        }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        Slot->Fd = fd;
+        Slot->File = file;
+        Slot->Length = 0;
+        Slot->Offset = 0;
+        return true;
+    }
+}
+
+static void
+CloseSlot(
+    Slot* Slot
+)
+{
+    if (Slot->Fd != STDIN_FILENO)
+    {
+        close(Slot->Fd);
+    }
+    Slot->Fd = -1;
+}
+
+static void*
+WorkerThread(
+    void* Parameter
+)
+/*++
+ Keeps one file per lane of a stream pool. Every round each lane adds
+ up to a block of its file, so the pool transforms whole lane groups,
+ and lanes whose file ended are finalized together and refilled
+--*/
+{
+    Summer* summer = Parameter;
+    const size_t lanes = SimdLanes();
+    SimdHashStreamPool pool;
+    Slot slots[MAX_LANES];
+    size_t finished[MAX_LANES];
+    size_t finishedFiles[MAX_LANES];
+    uint8_t digests[MAX_LANES * MAX_HASH_SIZE];
+    uint8_t* data = malloc(lanes * CHUNK_SIZE);
+    bool more = true;
+
+    if (data == NULL || !SimdHashStreamPoolInit(&pool, summer->Algorithm, lanes))
+    {
+        fprintf(stderr, PROGRAM ": out of memory\n");
+        exit(1);
+    }
+
+    for (size_t lane = 0; lane < lanes; lane++)
+    {
+        slots[lane].Fd = -1;
+        slots[lane].Data = &data[lane * CHUNK_SIZE];
+    }
+
+    for (;;)
+    {
+        size_t active = 0;
+        size_t finishedCount = 0;
+
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            Slot* slot = &slots[lane];
+
+            if (slot->Fd < 0)
+            {
+                more = more && OpenNext(summer, slot);
+                if (slot->Fd < 0)
+                {
+                    continue;
+                }
+            }
+
+            if (slot->Offset == slot->Length)
+            {
+                const ssize_t bytes = read(slot->Fd, slot->Data, CHUNK_SIZE);
+                if (bytes < 0)
+                {
+                    Complete(summer, slot->File, NULL, errno);
+                    SimdHashStreamReset(&pool, lane);
+                    CloseSlot(slot);
+                    continue;
+                }
+                if (bytes == 0)
+                {
+                    finishedFiles[finishedCount] = slot->File;
+                    finished[finishedCount++] = lane;
+                    CloseSlot(slot);
+                    continue;
+                }
+                slot->Length = (size_t)bytes;
+                slot->Offset = 0;
+                atomic_fetch_add_explicit(&summer->Bytes, (uint64_t)bytes, memory_order_relaxed);
+            }
+
+            const size_t left = slot->Length - slot->Offset;
+            const size_t take = left < pool.BufferSize ? left : pool.BufferSize;
+            SimdHashStreamUpdate(&pool, lane, take, &slot->Data[slot->Offset]);
+            slot->Offset += take;
+            active++;
+        }
+
+        if (finishedCount > 0)
+        {
+            SimdHashStreamFinalize(&pool, finishedCount, finished, digests);
+            for (size_t i = 0; i < finishedCount; i++)
+            {
+                Complete(summer, finishedFiles[i], &digests[i * summer->DigestSize], 0);
+            }
+        }
+        else if (active == 0 && !more)
+        {
+            break;
+        }
+    }
+
+    SimdHashStreamPoolDestroy(&pool);
+    free(data);
+    return NULL;
+}
+
+static void
+WaitFor(
+    Summer* Summer,
+    const size_t File
+)
+{
+    pthread_mutex_lock(&Summer->Lock);
+    while (!Summer->Results[File].Done)
+    {
+        pthread_cond_wait(&Summer->Progress, &Summer->Lock);
+    }
+    pthread_mutex_unlock(&Summer->Lock);
+}
+
+static bool
+NeedsEscape(
+    const char* Name
+)
+{
+    return strpbrk(Name, "\\\n\r") != NULL;
+}
+
+static void
+PrintName(
+    const char* Name
+)
+/*++
+ Names with a backslash or line break are escaped as coreutils does, and
+ the line is then marked by a leading backslash
+--*/
+{
+    for (const char* next = Name; *next; next++)
+    {
+        switch (*next)
+        {
+        case '\\':
+            fputs("\\\\", stdout);
+            break;
+        case '\n':
+            fputs("\\n", stdout);
+            break;
+        case '\r':
+            fputs("\\r", stdout);
+            break;
+        default:
+            putchar(*next);
+            break;
+        }
+    }
+}
+
+static bool
+Unescape(
+    char* Name
+)
+{
+    char* out = Name;
+
+    for (const char* next = Name; *next; next++)
+    {
+        if (*next != '\\')
+        {
+            *out++ = *next;
+            continue;
+        }
+        switch (*++next)
+        {
+        case '\\':
+            *out++ = '\\';
+            break;
+        case 'n':
+            *out++ = '\n';
+            break;
+        case 'r':
+            *out++ = '\r';
+            break;
+        default:
+            return false;
+        }
+    }
+    *out = '\0';
+    return true;
+}
+
+static size_t
+ParseCheckFile(
+    const char* Path,
+    const size_t DigestSize,
+    PathList* Files,
+    uint8_t** Expected,
+    size_t* Malformed
+)
+/*++
+ Reads "<hex>  <name>" or "<hex> *<name>" lines as written by the sum
+ tools. Returns the number of well formed lines
+--*/
+{
+    FILE* file = strcmp(Path, "-") == 0 ? stdin : fopen(Path, "r");
+    char* line = NULL;
+    size_t capacity = 0;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, PROGRAM ": %s: %s\n", Path, strerror(errno));
+        return 0;
+    }
+
+    while (getline(&line, &capacity, file) >= 0)
+    {
+        char* next = line;
+        const bool escaped = *next == '\\';
+
+        next[strcspn(next, "\n")] = '\0';
+        next += escaped;
+
+        const size_t hexLength = DigestSize * 2;
+        if (strlen(next) < hexLength + 2 ||
+            next[hexLength] != ' ' ||
+            (next[hexLength + 1] != ' ' && next[hexLength + 1] != '*') ||
+            next[hexLength + 2] == '\0')
+        {
+            (*Malformed)++;
+            continue;
+        }
+
+        char* name = &next[hexLength + 2];
+        if (escaped && !Unescape(name))
+        {
+            (*Malformed)++;
+            continue;
+        }
+
+        uint8_t digest[MAX_HASH_SIZE];
+        if (SimdHashDecodeHex(next, hexLength, digest) != DigestSize)
+        {
+            (*Malformed)++;
+            continue;
+        }
+
+        const size_t allocated = Files->Allocated;
+        AddPath(Files, name);
+        if (Files->Allocated != allocated)
+        {
+            *Expected = realloc(*Expected, Files->Allocated * DigestSize);
+        }
+        memcpy(&(*Expected)[(Files->Count - 1) * DigestSize], digest, DigestSize);
+    }
+
+    free(line);
+    if (file != stdin)
+    {
+        fclose(file);
+    }
+    return Files->Count;
+}
+
+static HashAlgorithm
+AlgorithmFromName(
+    const char* Program
+)
+/*++
+ Invoked through a link such as md5sum the algorithm follows the name
+--*/
+{
+    static const struct { const char* Name; HashAlgorithm Algorithm; } names[] = {
+        { "md4", HashAlgorithmMD4 },
+        { "md5", HashAlgorithmMD5 },
+        { "sha1", HashAlgorithmSHA1 },
+        { "sha256", HashAlgorithmSHA256 },
+    };
+    char* copy = strdup(Program);
+    const char* base = basename(copy);
+    HashAlgorithm algorithm = HashAlgorithmSHA256;
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (strncmp(base, names[i].Name, strlen(names[i].Name)) == 0 &&
+            strcmp(&base[strlen(names[i].Name)], "sum") == 0)
+        {
+            algorithm = names[i].Algorithm;
+        }
+    }
+    free(copy);
+    return algorithm;
+}
+
+static void
+Usage(
+    void
+)
+{
+    fprintf(stderr,
+        "Usage: " PROGRAM " [options] [file...]\n"
+        "  -a, --algorithm <name>  md4, md5, sha1 or sha256 (default sha256)\n"
+        "  -b, --binary            mark names with '*' as binary mode\n"
+        "  -c, --check             verify the sums listed in the given files\n"
+        "  -r, --recursive         hash every regular file under directories\n"
+        "  -t, --threads <n>       worker threads (default: online CPUs)\n"
+        "      --quiet             with -c, do not print OK lines\n"
+        "      --status            with -c, print nothing and only set the exit status\n"
+        "  -v, --verbose           print throughput to stderr when done\n");
+}
+
+int main(int argc, char* argv[])
+{
+    static const struct option options[] = {
+        { "algorithm", required_argument, NULL, 'a' },
+        { "binary", no_argument, NULL, 'b' },
+        { "check", no_argument, NULL, 'c' },
+        { "recursive", no_argument, NULL, 'r' },
+        { "text", no_argument, NULL, 'T' },
+        { "threads", required_argument, NULL, 't' },
+        { "quiet", no_argument, NULL, 'Q' },
+        { "status", no_argument, NULL, 'S' },
+        { "verbose", no_argument, NULL, 'v' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    static Summer summer;
+    PathList files = { 0 };
+    uint8_t* expected = NULL;
+    pthread_t threads[MAX_THREADS];
+    long threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    bool binary = false;
+    bool check = false;
+    bool recursive = false;
+    bool quiet = false;
+    bool status = false;
+    bool verbose = false;
+    size_t malformed = 0;
+    int option;
+    int exitCode = 0;
+
+    summer.Algorithm = AlgorithmFromName(argv[0]);
+
+    while ((option = getopt_long(argc, argv, "a:bcrt:vh", options, NULL)) != -1)
+    {
+        switch (option)
+        {
+        case 'a':
+            summer.Algorithm = ParseHashAlgorithm(optarg);
+            break;
+        case 'b':
+            binary = true;
+            break;
+        case 'T':
+            binary = false;
+            break;
+        case 'c':
+            check = true;
+            break;
+        case 'r':
+            recursive = true;
+            break;
+        case 't':
+            threadCount = atol(optarg);
+            break;
+        case 'Q':
+            quiet = true;
+            break;
+        case 'S':
+            status = true;
+            break;
+        case 'v':
+            verbose = true;
+            break;
+        default:
+            Usage();
+            return 1;
+        }
+    }
+
+    switch (summer.Algorithm)
+    {
+    case HashAlgorithmMD4:
+    case HashAlgorithmMD5:
+    case HashAlgorithmSHA1:
+    case HashAlgorithmSHA256:
+        break;
+    default:
+        fprintf(stderr, PROGRAM ": unsupported algorithm\n");
+        return 1;
+    }
+    summer.DigestSize = GetHashWidth(summer.Algorithm);
+
+    if (check)
+    {
+        if (optind == argc)
+        {
+            ParseCheckFile("-", summer.DigestSize, &files, &expected, &malformed);
+        }
+        for (int i = optind; i < argc; i++)
+        {
+            ParseCheckFile(argv[i], summer.DigestSize, &files, &expected, &malformed);
+        }
+    }
+    else if (optind == argc)
+    {
+        AddPath(&files, "-");
+    }
+    else
+    {
+        for (int i = optind; i < argc; i++)
+        {
+            struct stat info;
+            if (recursive && stat(argv[i], &info) == 0 && S_ISDIR(info.st_mode))
+            {
+                WalkList = &files;
+                nftw(argv[i], WalkEntry, 64, FTW_PHYS);
+            }
+            else
+            {
+                AddPath(&files, argv[i]);
+            }
+        }
+    }
+
+    summer.Paths = files.Paths;
+    summer.Count = files.Count;
+    summer.Results = calloc(files.Count + 1, sizeof(FileResult));
+    pthread_mutex_init(&summer.Lock, NULL);
+    pthread_cond_init(&summer.Progress, NULL);
+
+    threadCount = threadCount < 1 ? 1 : threadCount > MAX_THREADS ? MAX_THREADS : threadCount;
+    if ((size_t)threadCount > files.Count)
+    {
+        threadCount = files.Count > 0 ? (long)files.Count : 1;
+    }
+
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+
+    for (long i = 0; i < threadCount; i++)
+    {
+        pthread_create(&threads[i], NULL, WorkerThread, &summer);
+    }
+
+    size_t mismatched = 0;
+    size_t unreadable = 0;
+    char hex[MAX_HASH_SIZE * 2 + 1];
+
+    for (size_t i = 0; i < files.Count; i++)
+    {
+        const FileResult* result = &summer.Results[i];
+        const char* path = files.Paths[i];
+
+        WaitFor(&summer, i);
+
+        if (result->Error != 0)
+        {
+            unreadable++;
+            exitCode = 1;
+            if (!status)
+            {
+                fprintf(stderr, PROGRAM ": %s: %s\n", path, strerror(result->Error));
+                if (check)
+                {
+                    printf("%s: FAILED open or read\n", path);
+                }
+            }
+            continue;
+        }
+
+        if (check)
+        {
+            const bool match = memcmp(result->Digest, &expected[i * summer.DigestSize], summer.DigestSize) == 0;
+            mismatched += !match;
+            exitCode |= !match;
+            if (!status && (!match || !quiet))
+            {
+                if (NeedsEscape(path))
+                {
+                    putchar('\\');
+                }
+                PrintName(path);
+                printf(": %s\n", match ? "OK" : "FAILED");
+            }
+            continue;
+        }
+
+        hex[SimdHashEncodeHex(result->Digest, summer.DigestSize, hex, false)] = '\0';
+        if (NeedsEscape(path))
+        {
+            putchar('\\');
+        }
+        printf("%s %c", hex, binary ? '*' : ' ');
+        PrintName(path);
+        putchar('\n');
+    }
+    fflush(stdout);
+
+    for (long i = 0; i < threadCount; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (check && !status)
+    {
+        if (malformed > 0)
+        {
+            fprintf(stderr, PROGRAM ": WARNING: %zu line%s improperly formatted\n", malformed, malformed == 1 ? " is" : "s are");
+        }
+        if (unreadable > 0)
+        {
+            fprintf(stderr, PROGRAM ": WARNING: %zu listed file%s could not be read\n", unreadable, unreadable == 1 ? "" : "s");
+        }
+        if (mismatched > 0)
+        {
+            fprintf(stderr, PROGRAM ": WARNING: %zu computed checksum%s did NOT match\n", mismatched, mismatched == 1 ? "" : "s");
+        }
+    }
+    if (check && files.Count == 0)
+    {
+        fprintf(stderr, PROGRAM ": no properly formatted checksum lines found\n");
+        exitCode = 1;
+    }
+
+    if (verbose)
+    {
+        const double elapsed = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+        const double megabytes = atomic_load(&summer.Bytes) / 1e6;
+        fprintf(stderr, "%zu files, %.1f MB in %.3fs with %ld threads of %zu lanes: %.1f MB/s, %.0f files/s\n",
+            files.Count, megabytes, elapsed, threadCount, SimdLanes(),
+            elapsed > 0 ? megabytes / elapsed : 0, elapsed > 0 ? files.Count / elapsed : 0);
+    }
+
+    for (size_t i = 0; i < files.Count; i++)
+    {
+        free(files.Paths[i]);
+    }
+    free(files.Paths);
+    free(expected);
+    free(summer.Results);
+    pthread_cond_destroy(&summer.Progress);
+    pthread_mutex_destroy(&summer.Lock);
+
+    return exitCode;
+}